@@ -404,6 +404,9 @@ all:
 endif
 
 build: elf cpfirmware
+ifeq ($(strip $(BINLOG_ENABLE)), yes)
+build: $(BUILD_DIR)/$(TARGET).binlog.json
+endif
 check-size: build
 check-md5: build
 objs-size: build
@@ -411,6 +414,10 @@ objs-size: build
 include show_options.mk
 include $(TMK_PATH)/rules.mk
 
+# The format strings `qmk binlog` decodes the console output with
+$(BUILD_DIR)/$(TARGET).binlog.json: $(BUILD_DIR)/$(TARGET).elf
+	bin/qmk generate-binlog-table --quiet --output $@ $<
+
 # Ensure we have generated files available for each of the objects
 define GEN_FILES
 $1: generated-files
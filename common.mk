@@ -22,4 +22,5 @@ COMMON_VPATH += $(QUANTUM_PATH)/audio
 COMMON_VPATH += $(QUANTUM_PATH)/process_keycode
 COMMON_VPATH += $(QUANTUM_PATH)/api
 COMMON_VPATH += $(QUANTUM_PATH)/sequencer
+COMMON_VPATH += $(QUANTUM_PATH)/binlog
 COMMON_VPATH += $(DRIVER_PATH)
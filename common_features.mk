@@ -51,6 +51,7 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
             OPT_DEFS += -DAUDIO_DRIVER_DAC
         else ifeq ($(strip $(AUDIO_DRIVER)), dac_additive)
             OPT_DEFS += -DAUDIO_DRIVER_DAC
+            SRC += $(QUANTUM_DIR)/audio/wavetable.c
         ## stm32f2 and above have a usable DAC unit, f1 do not, and need to use pwm instead
         else ifeq ($(strip $(AUDIO_DRIVER)), pwm_software)
             OPT_DEFS += -DAUDIO_DRIVER_PWM
@@ -98,6 +99,9 @@ endif
 
 ifeq ($(strip $(VIRTSER_ENABLE)), yes)
     OPT_DEFS += -DVIRTSER_ENABLE
+    ifeq ($(PLATFORM),TEST)
+        SRC += $(PLATFORM_COMMON_DIR)/virtser.c
+    endif
 endif
 
 ifeq ($(strip $(MOUSEKEY_ENABLE)), yes)
@@ -112,6 +116,10 @@ ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/pointing_device.c
 endif
 
+ifneq ($(filter yes,$(strip $(MOUSEKEY_ENABLE)) $(strip $(POINTING_DEVICE_ENABLE))),)
+    SRC += $(QUANTUM_DIR)/mouse_accumulator.c
+endif
+
 VALID_EEPROM_DRIVER_TYPES := vendor custom transient i2c spi
 EEPROM_DRIVER ?= vendor
 ifeq ($(filter $(EEPROM_DRIVER),$(VALID_EEPROM_DRIVER_TYPES)),)
@@ -326,6 +334,12 @@ ifeq ($(strip $(SERIAL_LINK_ENABLE)), yes)
     VAPTH += $(SERIAL_PATH)
 endif
 
+ifeq ($(strip $(BINLOG_ENABLE)), yes)
+    OPT_DEFS += -DBINLOG_ENABLE
+    SRC += $(QUANTUM_DIR)/binlog/binlog.c
+    EXTRALDFLAGS += -Wl,-T,$(QUANTUM_DIR)/binlog/binlog.ld
+endif
+
 VARIABLE_TRACE ?= no
 ifneq ($(strip $(VARIABLE_TRACE)),no)
     SRC += $(QUANTUM_DIR)/variable_trace.c
@@ -506,6 +520,7 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
 
     # Include files used by all split keyboards
     QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_util.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_link.c
 
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
@@ -30,7 +30,7 @@
     there is nothing to override during linkage.
 */
 
-#include "wait.h"
+#include "timer.h"
 #include "i2c_master.h"
 #include "eeprom.h"
 #include "eeprom_i2c.h"
@@ -38,10 +38,31 @@
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif  // DEBUG_EEPROM_OUTPUT
 
+#define PAGE_START(addr) ((addr) & ~(uintptr_t)(EXTERNAL_EEPROM_PAGE_SIZE - 1))
+
+// The chip ignores its address while it's writing a page, so instead of waiting for the longest time the datasheet
+// allows, it's polled until it acknowledges again. That's only done before the next transfer, the write itself returns
+// right away.
+static bool      write_in_progress = false;
+static uint16_t  write_started;
+static uintptr_t write_address;
+
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+// Pages written to RAM and not yet to the chip, oldest first. The bytes written so far are marked in dirty, the rest
+// of data is only read from the chip when the page is.
+typedef struct {
+    uintptr_t page;
+    uint8_t   data[EXTERNAL_EEPROM_PAGE_SIZE];
+    uint8_t   dirty[EXTERNAL_EEPROM_PAGE_SIZE / 8];
+} pending_page_t;
+
+static pending_page_t pending_pages[EXTERNAL_EEPROM_WRITE_BACK_PAGES];
+static uint8_t        pending_count = 0;
+#endif
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -50,7 +71,134 @@ static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     }
 }
 
-void eeprom_driver_init(void) { i2c_init(); }
+// Polls the chip once, a chip that's still busy after the write time is given up on, the same as if it had finished
+static bool write_finished(void) {
+    if (!write_in_progress) {
+        return true;
+    }
+
+    uint8_t address[EXTERNAL_EEPROM_ADDRESS_SIZE];
+    fill_target_address(address, (const void *)write_address);
+    if (i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(write_address), address, EXTERNAL_EEPROM_ADDRESS_SIZE, 100) == I2C_STATUS_SUCCESS || timer_elapsed(write_started) > EXTERNAL_EEPROM_WRITE_TIME) {
+        write_in_progress = false;
+    }
+    return !write_in_progress;
+}
+
+static void wait_for_write(void) {
+    while (!write_finished()) {
+    }
+}
+
+static void read_from_chip(void *buf, uintptr_t addr, size_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
+    fill_target_address(complete_packet, (const void *)addr);
+
+    wait_for_write();
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
+    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS(addr), buf, len, 100);
+}
+
+// Writes within a single page
+static void write_to_chip(const uint8_t *buf, uintptr_t addr, uint8_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
+    fill_target_address(complete_packet, (const void *)addr);
+    memcpy(&complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE], buf, len);
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("[EEPROM W] 0x%04X: ", ((int)addr));
+    for (uint8_t i = 0; i < len; i++) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
+#endif  // DEBUG_EEPROM_OUTPUT
+
+    wait_for_write();
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + len, 100);
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+    write_in_progress = true;
+    write_started     = timer_read();
+    write_address     = addr;
+#endif
+}
+
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+static inline bool is_dirty(const pending_page_t *p, uint8_t offset) { return p->dirty[offset / 8] & (1 << (offset % 8)); }
+
+static pending_page_t *find_pending_page(uintptr_t page) {
+    for (uint8_t i = 0; i < pending_count; i++) {
+        if (pending_pages[i].page == page) {
+            return &pending_pages[i];
+        }
+    }
+    return NULL;
+}
+
+// Writes the span of the oldest page from its first to its last dirty byte, reading the clean bytes in between first
+static void write_oldest_page(void) {
+    pending_page_t *p     = &pending_pages[0];
+    uint8_t         first = 0;
+    uint8_t         last  = EXTERNAL_EEPROM_PAGE_SIZE - 1;
+    while (!is_dirty(p, first)) {
+        first++;
+    }
+    while (!is_dirty(p, last)) {
+        last--;
+    }
+
+    bool holes = false;
+    for (uint8_t i = first; i <= last; i++) {
+        holes |= !is_dirty(p, i);
+    }
+    if (holes) {
+        uint8_t clean[EXTERNAL_EEPROM_PAGE_SIZE];
+        read_from_chip(&clean[first], p->page + first, last - first + 1);
+        for (uint8_t i = first; i <= last; i++) {
+            if (!is_dirty(p, i)) {
+                p->data[i] = clean[i];
+            }
+        }
+    }
+    write_to_chip(&p->data[first], p->page + first, last - first + 1);
+
+    pending_count--;
+    memmove(&pending_pages[0], &pending_pages[1], pending_count * sizeof(pending_page_t));
+}
+
+/** \brief Writes the oldest pending page, once the chip has finished the previous write
+ *
+ * Called from keyboard_task(), so writes don't keep the keyboard waiting
+ */
+void eeprom_i2c_task(void) {
+    static uint16_t last_poll = 0;
+
+    // The chip only has to be polled once a millisecond, as no write is done sooner
+    if (pending_count == 0 || (write_in_progress && timer_read() == last_poll)) {
+        return;
+    }
+    last_poll = timer_read();
+    if (write_finished()) {
+        write_oldest_page();
+    }
+}
+
+/** \brief Writes all the pending pages, and waits for the chip to finish
+ */
+void eeprom_i2c_flush(void) {
+    while (pending_count > 0) {
+        write_oldest_page();
+    }
+    wait_for_write();
+}
+#endif
+
+void eeprom_driver_init(void) {
+    i2c_init();
+    write_in_progress = false;
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+    pending_count = 0;
+#endif
+}
 
 void eeprom_driver_erase(void) {
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
@@ -69,11 +217,28 @@ void eeprom_driver_erase(void) {
 }
 
 void eeprom_read_block(void *buf, const void *addr, size_t len) {
-    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
-    fill_target_address(complete_packet, addr);
+    uintptr_t target_addr = (uintptr_t)addr;
 
-    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
-    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+    // Served from the pending pages alone if they have all of it
+    bool from_chip = false;
+    for (size_t i = 0; i < len && !from_chip; i++) {
+        pending_page_t *p = find_pending_page(PAGE_START(target_addr + i));
+        from_chip         = !p || !is_dirty(p, (target_addr + i) % EXTERNAL_EEPROM_PAGE_SIZE);
+    }
+    if (from_chip) {
+        read_from_chip(buf, target_addr, len);
+    }
+    for (size_t i = 0; i < len; i++) {
+        pending_page_t *p      = find_pending_page(PAGE_START(target_addr + i));
+        uint8_t         offset = (target_addr + i) % EXTERNAL_EEPROM_PAGE_SIZE;
+        if (p && is_dirty(p, offset)) {
+            ((uint8_t *)buf)[i] = p->data[offset];
+        }
+    }
+#else
+    read_from_chip(buf, target_addr, len);
+#endif
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
@@ -85,32 +250,33 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+    const uint8_t *read_buf    = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
 
     while (len > 0) {
         uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        size_t    write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
         if (write_length > len) {
             write_length = len;
         }
 
-        fill_target_address(complete_packet, (const void *)target_addr);
-        for (uint8_t i = 0; i < write_length; i++) {
-            complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = read_buf[i];
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+        pending_page_t *p = find_pending_page(PAGE_START(target_addr));
+        if (!p) {
+            if (pending_count == EXTERNAL_EEPROM_WRITE_BACK_PAGES) {
+                write_oldest_page();
+            }
+            p       = &pending_pages[pending_count++];
+            p->page = PAGE_START(target_addr);
+            memset(p->dirty, 0, sizeof(p->dirty));
         }
-
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
-        for (uint8_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(read_buf[i]));
+        for (uint8_t i = page_offset; i < page_offset + write_length; i++) {
+            p->data[i] = read_buf[i - page_offset];
+            p->dirty[i / 8] |= 1 << (i % 8);
         }
-        dprintf("\n");
-#endif  // DEBUG_EEPROM_OUTPUT
-
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+#else
+        write_to_chip(read_buf, target_addr, write_length);
+#endif
 
         read_buf += write_length;
         target_addr += write_length;
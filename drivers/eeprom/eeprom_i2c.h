@@ -113,8 +113,28 @@
 
 /*
     The write cycle time of the EEPROM in milliseconds, as specified in the
-    datasheet.
+    datasheet. The EEPROM is polled until it has finished a write, this is only
+    how long it's polled for at most.
 */
 #ifndef EXTERNAL_EEPROM_WRITE_TIME
 #    define EXTERNAL_EEPROM_WRITE_TIME 5
 #endif
+
+/*
+    With EXTERNAL_EEPROM_WRITE_BACK defined, writes are kept in RAM, and
+    written to the EEPROM a page at a time by eeprom_i2c_task(), called from
+    keyboard_task(). This is how many pages are kept, once they're all used, the
+    oldest is written right away.
+
+    eeconfig_flush() calls eeprom_i2c_flush(), before jumping to the bootloader
+    and when suspending. Call either before anything else that can lose the
+    pending writes.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_BACK_PAGES
+#    define EXTERNAL_EEPROM_WRITE_BACK_PAGES 4
+#endif
+
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+void eeprom_i2c_task(void);
+void eeprom_i2c_flush(void);
+#endif
@@ -0,0 +1,97 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom_driver.h"
+#include "eeprom_i2c.h"
+#include "i2c_master.h"
+#include "timer.h"
+}
+
+#include <string.h>
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+class EepromI2cTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        i2c_mock_write_time_us = 1000;
+        i2c_mock_byte_time_us  = 25;
+        memset(i2c_mock_memory, 0xFF, EXTERNAL_EEPROM_BYTE_COUNT);
+        eeprom_driver_init();
+    }
+
+    void fill_pattern(uint8_t *buf, size_t len, uint8_t seed) {
+        for (size_t i = 0; i < len; i++) {
+            buf[i] = seed + i * 7;
+        }
+    }
+};
+
+TEST_F(EepromI2cTest, ReadsBackWhatWasWritten) {
+    uint8_t data[300], read[300];
+    fill_pattern(data, sizeof(data), 1);
+    eeprom_write_block(data, (void *)50, sizeof(data));
+    eeprom_read_block(read, (void *)50, sizeof(read));
+    EXPECT_EQ(memcmp(read, data, sizeof(data)), 0);
+    EXPECT_EQ(memcmp(&i2c_mock_memory[50], data, sizeof(data)), 0);
+    EXPECT_EQ(i2c_mock_memory[49], 0xFF);
+    EXPECT_EQ(i2c_mock_memory[350], 0xFF);
+    // 14 bytes to the end of the first page, then 4 full pages and 30 bytes
+    EXPECT_EQ(i2c_mock_page_writes, 6);
+}
+
+TEST_F(EepromI2cTest, WaitsOnlyUntilTheChipAcknowledges) {
+    uint8_t data[8 * EXTERNAL_EEPROM_PAGE_SIZE];
+    fill_pattern(data, sizeof(data), 2);
+    eeprom_write_block(data, (void *)0, sizeof(data));
+    // Each page takes 1.7ms on the bus and the chip 1ms to write it, the last write isn't waited for
+    EXPECT_LE(timer_read32(), 8 * 2 + 7 * 1);
+    EXPECT_LT(timer_read32(), 8 * EXTERNAL_EEPROM_WRITE_TIME);
+    EXPECT_GT(i2c_mock_nacks, 0);
+    EXPECT_EQ(memcmp(i2c_mock_memory, data, sizeof(data)), 0);
+}
+
+TEST_F(EepromI2cTest, ReadWaitsForTheWriteToFinish) {
+    eeprom_write_byte((uint8_t *)100, 0x42);
+    uint16_t nacks = i2c_mock_nacks;
+    EXPECT_EQ(eeprom_read_byte((const uint8_t *)100), 0x42);
+    EXPECT_GT(i2c_mock_nacks, nacks);
+}
+
+TEST_F(EepromI2cTest, UpdateOnlyWritesChanges) {
+    eeprom_write_byte((uint8_t *)10, 0x42);
+    i2c_mock_clear_counts();
+    eeprom_update_byte((uint8_t *)10, 0x42);
+    EXPECT_EQ(i2c_mock_page_writes, 0);
+    eeprom_update_byte((uint8_t *)10, 0x43);
+    EXPECT_EQ(i2c_mock_page_writes, 1);
+}
+
+TEST_F(EepromI2cTest, GivesUpAfterTheWriteTime) {
+    i2c_mock_write_time_us = 50000;
+    eeprom_write_byte((uint8_t *)0, 0x42);
+    uint32_t start = timer_read32();
+    eeprom_write_byte((uint8_t *)EXTERNAL_EEPROM_PAGE_SIZE, 0x43);
+    EXPECT_LE(timer_elapsed32(start), EXTERNAL_EEPROM_WRITE_TIME + 2);
+    EXPECT_EQ(i2c_mock_memory[EXTERNAL_EEPROM_PAGE_SIZE], 0xFF);
+}
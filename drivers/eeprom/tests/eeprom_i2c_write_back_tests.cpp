@@ -0,0 +1,157 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom_driver.h"
+#include "eeprom_i2c.h"
+#include "eeconfig.h"
+#include "action_layer.h"
+#include "i2c_master.h"
+#include "timer.h"
+}
+
+#include <string.h>
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+// Reset by eeconfig_init(), normally from action_layer.c
+layer_state_t default_layer_state = 0;
+}
+
+class EepromI2cWriteBackTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        i2c_mock_write_time_us = 3000;
+        i2c_mock_byte_time_us  = 25;
+        for (uint32_t i = 0; i < EXTERNAL_EEPROM_BYTE_COUNT; i++) {
+            i2c_mock_memory[i] = i;
+        }
+        eeprom_driver_init();
+    }
+
+    void fill_pattern(uint8_t *buf, size_t len, uint8_t seed) {
+        for (size_t i = 0; i < len; i++) {
+            buf[i] = seed + i * 7;
+        }
+    }
+
+    // As keyboard_task() would
+    void run_tasks(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            eeprom_i2c_task();
+            advance_time(1);
+        }
+    }
+};
+
+TEST_F(EepromI2cWriteBackTest, WritesDontWaitForTheBus) {
+    uint8_t data[EXTERNAL_EEPROM_WRITE_BACK_PAGES * EXTERNAL_EEPROM_PAGE_SIZE], read[sizeof(data)];
+    fill_pattern(data, sizeof(data), 1);
+    eeprom_write_block(data, (void *)0, sizeof(data));
+    EXPECT_EQ(timer_read32(), 0);
+    EXPECT_EQ(i2c_mock_transfers, 0);
+
+    // Served from the pending pages
+    eeprom_read_block(read, (void *)0, sizeof(read));
+    EXPECT_EQ(memcmp(read, data, sizeof(data)), 0);
+    EXPECT_EQ(i2c_mock_transfers, 0);
+
+    // A page per write time of the chip
+    run_tasks(EXTERNAL_EEPROM_WRITE_BACK_PAGES * 5);
+    EXPECT_EQ(i2c_mock_page_writes, EXTERNAL_EEPROM_WRITE_BACK_PAGES);
+    EXPECT_EQ(memcmp(i2c_mock_memory, data, sizeof(data)), 0);
+}
+
+TEST_F(EepromI2cWriteBackTest, PartialWritesKeepTheRestOfThePage) {
+    const uint16_t page = 3 * EXTERNAL_EEPROM_PAGE_SIZE;
+    uint8_t        expected[EXTERNAL_EEPROM_PAGE_SIZE], read[EXTERNAL_EEPROM_PAGE_SIZE];
+    memcpy(expected, &i2c_mock_memory[page], EXTERNAL_EEPROM_PAGE_SIZE);
+
+    eeprom_write_word((uint16_t *)(page + 10), 0xABCD);
+    eeprom_write_byte((uint8_t *)(page + 20), 0x42);
+    memcpy(&expected[10], "\xCD\xAB", 2);
+    expected[20] = 0x42;
+
+    eeprom_read_block(read, (void *)page, sizeof(read));
+    EXPECT_EQ(memcmp(read, expected, sizeof(expected)), 0);
+
+    eeprom_i2c_flush();
+    EXPECT_EQ(i2c_mock_page_writes, 1);
+    EXPECT_EQ(memcmp(&i2c_mock_memory[page], expected, sizeof(expected)), 0);
+}
+
+TEST_F(EepromI2cWriteBackTest, RewritesOfAPageAreCoalesced) {
+    for (uint8_t i = 0; i < 10; i++) {
+        eeprom_update_byte((uint8_t *)(5 + i % 2), i);
+    }
+    EXPECT_EQ(eeprom_read_byte((const uint8_t *)5), 8);
+    EXPECT_EQ(eeprom_read_byte((const uint8_t *)6), 9);
+    eeprom_i2c_flush();
+    EXPECT_EQ(i2c_mock_page_writes, 1);
+    EXPECT_EQ(i2c_mock_memory[5], 8);
+    EXPECT_EQ(i2c_mock_memory[6], 9);
+}
+
+TEST_F(EepromI2cWriteBackTest, AFullQueueWritesTheOldestPage) {
+    for (uint8_t i = 0; i <= EXTERNAL_EEPROM_WRITE_BACK_PAGES; i++) {
+        eeprom_write_byte((uint8_t *)(uintptr_t)(i * EXTERNAL_EEPROM_PAGE_SIZE), 0xA0 + i);
+    }
+    EXPECT_EQ(i2c_mock_page_writes, 1);
+    EXPECT_EQ(i2c_mock_memory[0], 0xA0);
+    EXPECT_EQ(i2c_mock_memory[EXTERNAL_EEPROM_PAGE_SIZE], (uint8_t)EXTERNAL_EEPROM_PAGE_SIZE);
+
+    eeprom_i2c_flush();
+    EXPECT_EQ(i2c_mock_page_writes, EXTERNAL_EEPROM_WRITE_BACK_PAGES + 1);
+    for (uint8_t i = 0; i <= EXTERNAL_EEPROM_WRITE_BACK_PAGES; i++) {
+        EXPECT_EQ(i2c_mock_memory[i * EXTERNAL_EEPROM_PAGE_SIZE], 0xA0 + i);
+    }
+}
+
+TEST_F(EepromI2cWriteBackTest, TaskDoesntWaitForTheChip) {
+    uint8_t data[2 * EXTERNAL_EEPROM_PAGE_SIZE];
+    fill_pattern(data, sizeof(data), 3);
+    eeprom_write_block(data, (void *)0, sizeof(data));
+
+    // The first page goes out right away, the second only once the chip acknowledges again
+    eeprom_i2c_task();
+    EXPECT_EQ(i2c_mock_page_writes, 1);
+    uint32_t start = timer_read32();
+    eeprom_i2c_task();
+    EXPECT_EQ(timer_elapsed32(start), 0);
+    EXPECT_EQ(i2c_mock_page_writes, 1);
+
+    run_tasks(5);
+    EXPECT_EQ(i2c_mock_page_writes, 2);
+    EXPECT_EQ(memcmp(i2c_mock_memory, data, sizeof(data)), 0);
+}
+
+TEST_F(EepromI2cWriteBackTest, EeconfigFlushWritesToTheChip) {
+    // Held back twice, by eeconfig and by the driver, as before a reset_keyboard() or a power down
+    eeconfig_update_kb(0x12345678);
+    eeprom_write_byte((uint8_t *)(4 * EXTERNAL_EEPROM_PAGE_SIZE), 0x42);
+    EXPECT_EQ(i2c_mock_transfers, 0);
+
+    eeconfig_flush();
+    uint32_t kb;
+    memcpy(&kb, &i2c_mock_memory[(uintptr_t)EECONFIG_KEYBOARD], sizeof(kb));
+    EXPECT_EQ(kb, 0x12345678);
+    EXPECT_EQ(i2c_mock_memory[4 * EXTERNAL_EEPROM_PAGE_SIZE], 0x42);
+}
@@ -0,0 +1,44 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stands in for the platform i2c_master.h, the transfers go to a simulated 24-series EEPROM instead
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int16_t i2c_status_t;
+
+#define I2C_STATUS_SUCCESS (0)
+#define I2C_STATUS_ERROR (-1)
+#define I2C_STATUS_TIMEOUT (-2)
+
+// Memory of the simulated EEPROM
+extern uint8_t i2c_mock_memory[];
+// How long the simulated EEPROM takes to write a page, it doesn't acknowledge its address until then
+extern uint32_t i2c_mock_write_time_us;
+// How long each byte takes on the bus, including the address byte of every transfer
+extern uint32_t i2c_mock_byte_time_us;
+extern uint16_t i2c_mock_page_writes;
+extern uint16_t i2c_mock_transfers;
+extern uint16_t i2c_mock_nacks;
+
+void i2c_mock_clear_counts(void);
+
+void         i2c_init(void);
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout);
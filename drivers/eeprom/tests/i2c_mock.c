@@ -0,0 +1,95 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_master.h"
+#include "eeprom_i2c.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+
+uint8_t  i2c_mock_memory[EXTERNAL_EEPROM_BYTE_COUNT];
+uint32_t i2c_mock_write_time_us;
+uint32_t i2c_mock_byte_time_us;
+uint16_t i2c_mock_page_writes;
+uint16_t i2c_mock_transfers;
+uint16_t i2c_mock_nacks;
+
+// Bus time that hasn't added up to a whole millisecond of the test timer yet
+static uint32_t carry_us;
+static uint32_t busy_until_us;
+static uint16_t pointer;
+
+void i2c_mock_clear_counts(void) { i2c_mock_page_writes = i2c_mock_transfers = i2c_mock_nacks = 0; }
+
+void i2c_init(void) {
+    carry_us = busy_until_us = 0;
+    pointer                  = 0;
+    i2c_mock_clear_counts();
+}
+
+static uint32_t now_us(void) { return timer_read32() * 1000 + carry_us; }
+
+static void bus_time(uint16_t bytes) {
+    carry_us += bytes * i2c_mock_byte_time_us;
+    advance_time(carry_us / 1000);
+    carry_us %= 1000;
+}
+
+// Sends the device address, which is only acknowledged once a write has finished
+static bool address_acked(void) {
+    i2c_mock_transfers++;
+    bus_time(1);
+    if (now_us() < busy_until_us) {
+        i2c_mock_nacks++;
+        return false;
+    }
+    return true;
+}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (!address_acked()) {
+        return I2C_STATUS_ERROR;
+    }
+    bus_time(length);
+
+    pointer = 0;
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; i++) {
+        pointer = (pointer << 8) | data[i];
+    }
+    if (length > EXTERNAL_EEPROM_ADDRESS_SIZE) {
+        // Like the real thing, a page write wraps around to the start of the page
+        uint16_t page = pointer & ~(EXTERNAL_EEPROM_PAGE_SIZE - 1);
+        for (uint16_t i = 0; i < length - EXTERNAL_EEPROM_ADDRESS_SIZE; i++) {
+            i2c_mock_memory[page | ((pointer + i) & (EXTERNAL_EEPROM_PAGE_SIZE - 1))] = data[EXTERNAL_EEPROM_ADDRESS_SIZE + i];
+        }
+        i2c_mock_page_writes++;
+        busy_until_us = now_us() + i2c_mock_write_time_us;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (!address_acked()) {
+        return I2C_STATUS_ERROR;
+    }
+    bus_time(length);
+
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = i2c_mock_memory[pointer];
+        pointer = (pointer + 1) % EXTERNAL_EEPROM_BYTE_COUNT;
+    }
+    return I2C_STATUS_SUCCESS;
+}
@@ -0,0 +1,25 @@
+eeprom_i2c_DEFS := -DNO_DEBUG -DNO_PRINT -DEEPROM_DRIVER -DEEPROM_I2C -DEEPROM_I2C_24LC256
+
+eeprom_i2c_INC := \
+	$(DRIVER_PATH)/eeprom/tests \
+	$(DRIVER_PATH)/eeprom \
+	$(TMK_PATH)/common
+
+eeprom_i2c_SRC := \
+	$(DRIVER_PATH)/eeprom/tests/i2c_mock.c \
+	$(DRIVER_PATH)/eeprom/tests/eeprom_i2c_tests.cpp \
+	$(DRIVER_PATH)/eeprom/eeprom_driver.c \
+	$(DRIVER_PATH)/eeprom/eeprom_i2c.c \
+	$(TMK_PATH)/common/test/timer.c
+
+eeprom_i2c_write_back_DEFS := $(eeprom_i2c_DEFS) -DEXTERNAL_EEPROM_WRITE_BACK -DEECONFIG_WRITE_DELAY=500
+
+eeprom_i2c_write_back_INC := $(eeprom_i2c_INC)
+
+eeprom_i2c_write_back_SRC := \
+	$(DRIVER_PATH)/eeprom/tests/i2c_mock.c \
+	$(DRIVER_PATH)/eeprom/tests/eeprom_i2c_write_back_tests.cpp \
+	$(DRIVER_PATH)/eeprom/eeprom_driver.c \
+	$(DRIVER_PATH)/eeprom/eeprom_i2c.c \
+	$(TMK_PATH)/common/eeconfig.c \
+	$(TMK_PATH)/common/test/timer.c
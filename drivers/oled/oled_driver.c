@@ -225,13 +225,16 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds(uint8_t update_start, uint8_t count, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint16_t start        = OLED_BLOCK_SIZE * update_start;
+    uint16_t end          = start + OLED_BLOCK_SIZE * count;
+    uint8_t  start_page   = start / OLED_DISPLAY_WIDTH;
+    uint8_t  start_column = start % OLED_DISPLAY_WIDTH;
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
+    (void)end;
     cmd_array[0] = PAM_PAGE_ADDR | start_page;
     cmd_array[1] = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
     cmd_array[2] = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
@@ -242,94 +245,165 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     // Commands for use in Horizontal Addressing mode.
     cmd_array[1] = start_column;
     cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    cmd_array[2] = end - start >= OLED_DISPLAY_WIDTH ? OLED_DISPLAY_WIDTH - 1 : start_column + (end - start) - 1;
+    cmd_array[5] = (end - 1) / OLED_DISPLAY_WIDTH;
 #endif
 }
 
-static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds_90(uint8_t update_start, uint8_t count, uint8_t *cmd_array) {
     cmd_array[1] = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
     cmd_array[4] = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
-    ;
+    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 * count - 1 + cmd_array[1];
     cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
 }
 
-uint8_t crot(uint8_t a, int8_t n) {
-    const uint8_t mask = 0x7;
-    n &= mask;
-    return a << n | a >> (-n & mask);
-}
-
-static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
-        }
+// Counts how many dirty blocks, starting with update_start, can be sent in a single addressed transfer
+static uint8_t calc_span(uint8_t update_start) {
+    uint8_t count = 1;
+    while (count < OLED_RENDER_MAX_BLOCKS && update_start + count < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << (update_start + count)))) {
+        ++count;
     }
-}
 
-void oled_render(void) {
-    if (!oled_initialized) {
-        return;
+    if (HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+        // Rotated blocks cover whole columns, so neighbours are side by side unless a block is shorter than the display
+        return OLED_BLOCK_SIZE % OLED_DISPLAY_HEIGHT == 0 ? count : 1;
     }
 
-    // Do we have work to do?
-    oled_dirty &= OLED_ALL_BLOCKS_MASK;
-    if (!oled_dirty || oled_scrolling) {
-        return;
+#if (OLED_IC == OLED_IC_SH1106)
+    // Page addressing has no end bound to wrap at, so a transfer has to stay on one page
+    const bool whole_pages = false;
+#else
+    // The column window wraps back to its own start, so a transfer either stays on one page or covers whole pages
+    const bool whole_pages = true;
+#endif
+    if (OLED_DISPLAY_WIDTH % OLED_BLOCK_SIZE != 0 && (!whole_pages || OLED_BLOCK_SIZE % OLED_DISPLAY_WIDTH != 0)) {
+        // Blocks that don't line up with the pages are sent one at a time
+        return 1;
     }
 
-    // Find first dirty block
-    uint8_t update_start = 0;
-    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
-        ++update_start;
+    uint16_t start = OLED_BLOCK_SIZE * update_start;
+    uint16_t end   = start + OLED_BLOCK_SIZE * count;
+    if ((end - 1) / OLED_DISPLAY_WIDTH != start / OLED_DISPLAY_WIDTH) {
+        if (whole_pages && start % OLED_DISPLAY_WIDTH == 0) {
+            end = end / OLED_DISPLAY_WIDTH * OLED_DISPLAY_WIDTH;
+        } else {
+            end = (start / OLED_DISPLAY_WIDTH + 1) * OLED_DISPLAY_WIDTH;
+        }
     }
+    return (end - start) / OLED_BLOCK_SIZE;
+}
 
+// Transposes an 8x8 bit tile: bit i of src[j] becomes bit 7 - j of dest[i].
+// Works on the tile as two 32 bit words, swapping 1x1, 2x2 and 4x4 bit squares in parallel.
+static void rotate_90(const uint8_t *src, uint8_t *dest) {
+    uint32_t x = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+    uint32_t y = ((uint32_t)src[4] << 24) | ((uint32_t)src[5] << 16) | ((uint32_t)src[6] << 8) | src[7];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    dest[0] = y;
+    dest[1] = y >> 8;
+    dest[2] = y >> 16;
+    dest[3] = y >> 24;
+    dest[4] = x;
+    dest[5] = x >> 8;
+    dest[6] = x >> 16;
+    dest[7] = x >> 24;
+}
+
+// Sends a run of dirty blocks, returns false if the display didn't acknowledge it
+static bool render_span(uint8_t update_start, uint8_t count) {
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        calc_bounds(update_start, count, &display_start[1]);  // Offset from I2C_CMD byte at the start
     } else {
-        calc_bounds_90(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        calc_bounds_90(update_start, count, &display_start[1]);  // Offset from I2C_CMD byte at the start
     }
 
     // Send column & page position
     if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
         print("oled_render offset command failed\n");
-        return;
+        return false;
     }
 
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
         // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE * count) != I2C_STATUS_SUCCESS) {
             print("oled_render data failed\n");
-            return;
+            return false;
         }
     } else {
         // Rotate the render chunks
         const static uint8_t source_map[] = OLED_SOURCE_MAP;
         const static uint8_t target_map[] = OLED_TARGET_MAP;
 
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+        // Each rotated block is a few pages of block_width columns. The display fills the whole
+        // window a page at a time, so the blocks' rows have to be interleaved page by page.
+        const uint8_t  block_width = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8;
+        static uint8_t temp_buffer[OLED_BLOCK_SIZE * OLED_RENDER_MAX_BLOCKS];
+        for (uint8_t block = 0; block < count; ++block) {
+            const uint8_t *source = &oled_buffer[OLED_BLOCK_SIZE * (update_start + block)];
+            for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+                uint16_t target = target_map[i] / block_width * block_width * count + block * block_width + target_map[i] % block_width;
+                rotate_90(&source[source_map[i]], &temp_buffer[target]);
+            }
         }
 
         // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE * count) != I2C_STATUS_SUCCESS) {
             print("oled_render90 data failed\n");
-            return;
+            return false;
         }
     }
+    return true;
+}
+
+void oled_render(void) {
+    if (!oled_initialized) {
+        return;
+    }
+
+    // Do we have work to do?
+    oled_dirty &= OLED_ALL_BLOCKS_MASK;
+    if (!oled_dirty || oled_scrolling) {
+        return;
+    }
+
+    // Send runs of dirty blocks until they are all clean or the time budget is spent
+    uint16_t render_start = timer_read();
+    uint8_t  update_start = 0;
+    do {
+        // Find next dirty block
+        while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
+            ++update_start;
+        }
+
+        uint8_t count = calc_span(update_start);
+        if (!render_span(update_start, count)) {
+            return;
+        }
+
+        // Clear dirty flags
+        oled_dirty &= ~(((((OLED_BLOCK_TYPE)1 << (count - 1)) << 1) - 1) << update_start);
+        update_start += count;
+    } while (oled_dirty && timer_elapsed(render_start) < OLED_RENDER_TIME_BUDGET);
 
     // Turn on display if it is off
     oled_on();
-
-    // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -158,6 +158,20 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_I2C_TIMEOUT 100
 #endif
 
+// Most dirty blocks oled_render sends in one transfer, this also sizes the 90 degree rotation buffer
+#if !defined(OLED_RENDER_MAX_BLOCKS)
+#    if defined(__AVR__)
+#        define OLED_RENDER_MAX_BLOCKS 2
+#    else
+#        define OLED_RENDER_MAX_BLOCKS 4
+#    endif
+#endif
+
+// How long in ms oled_render keeps sending transfers before leaving the rest for the next call
+#if !defined(OLED_RENDER_TIME_BUDGET)
+#    define OLED_RENDER_TIME_BUDGET 2
+#endif
+
 typedef struct __attribute__((__packed__)) {
     uint8_t *current_element;
     uint16_t remaining_element_count;
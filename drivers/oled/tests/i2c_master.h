@@ -0,0 +1,52 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stands in for the platform i2c_master.h, the transfers go to a simulated SSD1306 instead
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int16_t i2c_status_t;
+
+#define I2C_STATUS_SUCCESS (0)
+#define I2C_STATUS_ERROR (-1)
+#define I2C_STATUS_TIMEOUT (-2)
+
+#define I2C_MOCK_MAX_TRANSACTIONS 64
+
+typedef struct {
+    uint8_t  control;
+    uint16_t length;
+} i2c_mock_transaction_t;
+
+// Display RAM of the simulated controller, in pages of 8 rows
+extern uint8_t i2c_mock_ram[8][128];
+// Segment remap and COM scan direction as last set by the driver
+extern bool i2c_mock_flipped;
+// Every transfer since i2c_mock_clear_log, the control byte tells commands (0x00) from data (0x40)
+extern i2c_mock_transaction_t i2c_mock_log[I2C_MOCK_MAX_TRANSACTIONS];
+extern uint8_t                i2c_mock_log_count;
+// Fake time each data transfer takes
+extern uint32_t i2c_mock_data_time;
+
+void    i2c_mock_clear_log(void);
+uint8_t i2c_mock_data_transfers(void);
+
+void         i2c_init(void);
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout);
@@ -0,0 +1,122 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_master.h"
+
+#include <string.h>
+
+void advance_time(uint32_t ms);
+
+uint8_t                i2c_mock_ram[8][128];
+bool                   i2c_mock_flipped;
+i2c_mock_transaction_t i2c_mock_log[I2C_MOCK_MAX_TRANSACTIONS];
+uint8_t                i2c_mock_log_count;
+uint32_t               i2c_mock_data_time;
+
+// Horizontal addressing mode window and write pointer
+static uint8_t column_start, column_end, column;
+static uint8_t page_start, page_end, page;
+
+void i2c_mock_clear_log(void) { i2c_mock_log_count = 0; }
+
+uint8_t i2c_mock_data_transfers(void) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < i2c_mock_log_count; i++) {
+        if (i2c_mock_log[i].control == 0x40) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void i2c_init(void) {
+    memset(i2c_mock_ram, 0, sizeof(i2c_mock_ram));
+    i2c_mock_flipped = false;
+    column_start = column = 0;
+    column_end            = 127;
+    page_start = page = 0;
+    page_end          = 7;
+    i2c_mock_clear_log();
+}
+
+static void log_transaction(uint8_t control, uint16_t length) {
+    if (i2c_mock_log_count < I2C_MOCK_MAX_TRANSACTIONS) {
+        i2c_mock_log[i2c_mock_log_count++] = (i2c_mock_transaction_t){control, length};
+    }
+}
+
+static void write_commands(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        switch (data[i]) {
+            case 0x21:  // COLUMN_ADDR
+                column_start = column = data[++i];
+                column_end            = data[++i];
+                break;
+            case 0x22:  // PAGE_ADDR
+                page_start = page = data[++i];
+                page_end          = data[++i];
+                break;
+            case 0xA0:  // SEGMENT_REMAP
+            case 0xC0:  // COM_SCAN_INC
+                i2c_mock_flipped = true;
+                break;
+            case 0xA1:  // SEGMENT_REMAP_INV
+            case 0xC8:  // COM_SCAN_DEC
+                i2c_mock_flipped = false;
+                break;
+            case 0x20:  // MEMORY_MODE
+            case 0x81:  // CONTRAST
+            case 0x8D:  // CHARGE_PUMP
+            case 0xA8:  // MULTIPLEX_RATIO
+            case 0xD3:  // DISPLAY_OFFSET
+            case 0xD5:  // DISPLAY_CLOCK
+            case 0xD9:  // PRE_CHARGE_PERIOD
+            case 0xDA:  // COM_PINS
+            case 0xDB:  // VCOM_DETECT
+                i++;
+                break;
+            case 0x26:  // SCROLL_RIGHT
+            case 0x27:  // SCROLL_LEFT
+                i += 6;
+                break;
+        }
+    }
+}
+
+static void write_data(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        i2c_mock_ram[page][column] = data[i];
+        if (column++ == column_end) {
+            column = column_start;
+            if (page++ == page_end) {
+                page = page_start;
+            }
+        }
+    }
+    advance_time(i2c_mock_data_time);
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    log_transaction(regaddr, length);
+    if (regaddr == 0x40) {
+        write_data(data, length);
+    } else {
+        write_commands(data, length);
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) { return i2c_writeReg(address, data[0], &data[1], length - 1, timeout); }
@@ -0,0 +1,153 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "oled_driver.h"
+#include "i2c_master.h"
+}
+
+extern "C" {
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+class OledDriverTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        i2c_mock_data_time = 0;
+    }
+
+    void init(oled_rotation_t rotation) {
+        ASSERT_TRUE(oled_init(rotation));
+        oled_render();
+        i2c_mock_clear_log();
+    }
+
+    void fill_random(uint32_t seed) {
+        for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+            seed = seed * 1103515245 + 12345;
+            oled_write_raw_byte(seed >> 16, i);
+        }
+    }
+
+    void mark_dirty(std::initializer_list<uint8_t> blocks) {
+        for (uint8_t block : blocks) {
+            oled_write_raw_byte(~oled_buffer[block * OLED_BLOCK_SIZE], block * OLED_BLOCK_SIZE);
+        }
+    }
+
+    bool ram_pixel(uint8_t x, uint8_t y) { return i2c_mock_ram[y / 8][x] & (1 << (y % 8)); }
+
+    // Checks the display RAM against the buffer, as the hardware would show it before any flipping
+    void expect_ram_matches_buffer(bool rotated) {
+        uint8_t width = rotated ? OLED_DISPLAY_HEIGHT : OLED_DISPLAY_WIDTH;
+        for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                uint8_t x  = i % width;
+                uint8_t y  = i / width * 8 + bit;
+                bool    on = oled_buffer[i] & (1 << bit);
+                if (!rotated) {
+                    ASSERT_EQ(ram_pixel(x, y), on) << "at " << +x << "," << +y;
+                } else {
+                    // Rotated x runs up the display and rotated y runs along it
+                    ASSERT_EQ(ram_pixel(y, OLED_DISPLAY_HEIGHT - 1 - x), on) << "at " << +x << "," << +y;
+                }
+            }
+        }
+    }
+};
+
+TEST_F(OledDriverTest, RendersAllRotations) {
+    for (auto rotation : {OLED_ROTATION_0, OLED_ROTATION_90, OLED_ROTATION_180, OLED_ROTATION_270}) {
+        SCOPED_TRACE(rotation);
+        init(rotation);
+        fill_random(rotation + 1);
+        oled_render();
+        EXPECT_EQ(oled_dirty, 0);
+        EXPECT_EQ(i2c_mock_flipped, (rotation & OLED_ROTATION_180) != 0);
+        expect_ram_matches_buffer(rotation & OLED_ROTATION_90);
+    }
+}
+
+TEST_F(OledDriverTest, RotatedPixelsLandInTheRightPlace) {
+    init(OLED_ROTATION_90);
+    oled_write_pixel(0, 0, true);
+    oled_write_pixel(OLED_DISPLAY_HEIGHT - 1, OLED_DISPLAY_WIDTH - 1, true);
+    oled_render();
+    EXPECT_EQ(i2c_mock_ram[OLED_DISPLAY_HEIGHT / 8 - 1][0], 0x80);
+    EXPECT_EQ(i2c_mock_ram[0][OLED_DISPLAY_WIDTH - 1], 0x01);
+}
+
+TEST_F(OledDriverTest, CoalescesContiguousDirtyBlocks) {
+    init(OLED_ROTATION_0);
+    fill_random(42);
+    oled_render();
+    // A full redraw goes out in as few transfers as the span limit allows
+    EXPECT_EQ(i2c_mock_data_transfers(), OLED_BLOCK_COUNT / OLED_RENDER_MAX_BLOCKS);
+    EXPECT_EQ(i2c_mock_log[1].length, OLED_BLOCK_SIZE * OLED_RENDER_MAX_BLOCKS);
+    expect_ram_matches_buffer(false);
+
+    i2c_mock_clear_log();
+    mark_dirty({1, 2, 6});
+    oled_render();
+    EXPECT_EQ(i2c_mock_data_transfers(), 2);
+    expect_ram_matches_buffer(false);
+}
+
+TEST_F(OledDriverTest, TransfersDontCrossPartialPages) {
+    init(OLED_ROTATION_0);
+    const uint8_t blocks_per_page = OLED_DISPLAY_WIDTH / OLED_BLOCK_SIZE;
+    mark_dirty({blocks_per_page - 1, blocks_per_page});
+    oled_render();
+    EXPECT_EQ(i2c_mock_data_transfers(), 2);
+    expect_ram_matches_buffer(false);
+}
+
+TEST_F(OledDriverTest, CoalescesRotatedBlocks) {
+    init(OLED_ROTATION_90);
+    fill_random(7);
+    oled_render();
+    EXPECT_EQ(i2c_mock_data_transfers(), OLED_BLOCK_COUNT / OLED_RENDER_MAX_BLOCKS);
+    expect_ram_matches_buffer(true);
+
+    i2c_mock_clear_log();
+    mark_dirty({0, 1, 5});
+    oled_render();
+    EXPECT_EQ(i2c_mock_data_transfers(), 2);
+    expect_ram_matches_buffer(true);
+}
+
+TEST_F(OledDriverTest, StopsWhenTimeBudgetIsSpent) {
+    init(OLED_ROTATION_0);
+    fill_random(3);
+    i2c_mock_data_time = 1;
+
+    uint8_t calls = 0;
+    while (oled_dirty) {
+        i2c_mock_clear_log();
+        oled_render();
+        EXPECT_LE(i2c_mock_data_transfers(), OLED_RENDER_TIME_BUDGET);
+        calls++;
+    }
+    EXPECT_EQ(calls, OLED_BLOCK_COUNT / OLED_RENDER_MAX_BLOCKS / OLED_RENDER_TIME_BUDGET);
+    expect_ram_matches_buffer(false);
+}
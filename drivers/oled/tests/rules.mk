@@ -0,0 +1,12 @@
+oled_DEFS := -DNO_DEBUG -DNO_PRINT
+
+oled_INC := \
+	$(DRIVER_PATH)/oled/tests \
+	$(DRIVER_PATH)/oled \
+	$(TMK_PATH)/common
+
+oled_SRC := \
+	$(DRIVER_PATH)/oled/tests/i2c_mock.c \
+	$(DRIVER_PATH)/oled/tests/oled_driver_tests.cpp \
+	$(DRIVER_PATH)/oled/oled_driver.c \
+	$(TMK_PATH)/common/test/timer.c
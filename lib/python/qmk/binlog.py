@@ -0,0 +1,235 @@
+"""Functions for decoding the dictionary-encoded log output of firmware built with `BINLOG_ENABLE = yes`.
+
+The firmware sends each log call as a frame holding the id of its format string and the raw arguments, see quantum/binlog/binlog.h. The format strings only exist in the .qmk_binlog section of the ELF file, with the offset of each one being its id.
+"""
+import json
+import re
+import struct
+
+SECTION = '.qmk_binlog'
+FRAME_START = 0x1E
+
+format_spec_regex = re.compile(r'%(?P<flags>[-+ 0#]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d+))?(?:hh|h|ll|l|z|j|t)?(?P<conversion>[diouxXcsSpb%])')
+
+
+def read_elf_section(elf_file, name=SECTION):
+    """Returns the contents of a section of an ELF file, or None if it doesn't have one with that name.
+
+    Args:
+        elf_file
+            The path to the ELF file.
+
+        name
+            The name of the section.
+    """
+    with open(elf_file, 'rb') as fd:
+        elf = fd.read()
+
+    if elf[:4] != b'\x7fELF':
+        raise ValueError('%s is not an ELF file' % elf_file)
+
+    is_64_bit = elf[4] == 2
+    endian = '<' if elf[5] == 1 else '>'
+
+    if is_64_bit:
+        section_offset, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        section_size, section_count, names_index = struct.unpack_from(endian + 'HHH', elf, 0x3A)
+        header_format = endian + 'IIQQQQIIQQ'
+    else:
+        section_offset, = struct.unpack_from(endian + 'I', elf, 0x20)
+        section_size, section_count, names_index = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+        header_format = endian + 'IIIIIIIIII'
+
+    headers = [struct.unpack_from(header_format, elf, section_offset + i * section_size) for i in range(section_count)]
+    names_offset = headers[names_index][4]
+
+    for header in headers:
+        name_start = names_offset + header[0]
+        section_name = elf[name_start:elf.index(b'\0', name_start)].decode('ascii')
+        if section_name == name:
+            return elf[header[4]:header[4] + header[5]]
+
+    return None
+
+
+def format_table(section):
+    """Returns the format strings of a .qmk_binlog section, keyed by their id.
+
+    The strings follow each other, separated by their terminating 0 and any padding.
+    """
+    table = {}
+    offset = 0
+
+    while offset < len(section):
+        end = section.index(b'\0', offset)
+        if end > offset:
+            table[offset] = section[offset:end].decode('utf-8', errors='replace')
+        offset = end + 1
+
+    return table
+
+
+def load_table(table_file):
+    """Loads a table written by `qmk generate-binlog-table`.
+    """
+    with open(table_file, encoding='utf-8') as fd:
+        return {int(key): value for key, value in json.load(fd).items()}
+
+
+def cobs_decode(data):
+    """Decodes the COBS encoded payload of a frame.
+    """
+    decoded = bytearray()
+    i = 0
+
+    while i < len(data):
+        code = data[i]
+        decoded += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            decoded.append(0)
+
+    return bytes(decoded)
+
+
+class Arguments:
+    """Reads the arguments of a log call from its payload.
+    """
+    def __init__(self, payload):
+        self.payload = payload
+        self.offset = 0
+
+    def number(self):
+        """Returns the next number, or None if the frame was cut off before it.
+        """
+        value = 0
+        shift = 0
+
+        while self.offset < len(self.payload):
+            byte = self.payload[self.offset]
+            self.offset += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value & 0xFFFFFFFF
+
+        return None
+
+    def string(self):
+        """Returns the next string, or None if the frame was cut off before it.
+        """
+        if self.offset >= len(self.payload):
+            return None
+
+        end = self.payload.find(b'\0', self.offset)
+        if end < 0:
+            self.offset = len(self.payload)
+            return None
+
+        value = self.payload[self.offset:end].decode('utf-8', errors='replace')
+        self.offset = end + 1
+        return value
+
+
+def format_message(format_string, payload):
+    """Formats a log call like printf would have on the keyboard. Arguments missing from the payload are shown as `?`.
+
+    Args:
+        format_string
+            The format string of the log site.
+
+        payload
+            The arguments, as sent by the firmware.
+    """
+    arguments = Arguments(payload)
+
+    def replace(match):
+        conversion = match.group('conversion')
+        if conversion == '%':
+            return '%'
+
+        width = match.group('width')
+        if width == '*':
+            width = arguments.number()
+            width = '' if width is None else str(width)
+        precision = match.group('precision')
+        if precision == '*':
+            precision = arguments.number()
+            precision = None if precision is None else str(precision)
+        flags = match.group('flags')
+
+        if conversion in 'sS':
+            value = arguments.string()
+        else:
+            value = arguments.number()
+
+        if value is None:
+            return '?'
+
+        if conversion in 'di':
+            # int is 16 bits on AVR, but the sign survives the conversion to uint32_t either way
+            value = value - (1 << 32) if value & 0x80000000 else value
+            conversion = 'd'
+        elif conversion == 'u':
+            conversion = 'd'
+        elif conversion == 'c':
+            value = chr(value & 0xFF)
+        elif conversion == 'p':
+            conversion = 'x'
+            flags += '#'
+        elif conversion == 'b':
+            value = format(value, 'b')
+            fill = '0' if '0' in flags and '-' not in flags else ' '
+            width = int(width or 0)
+            return value.ljust(width) if '-' in flags else value.rjust(width, fill)
+        elif conversion == 'S':
+            conversion = 's'
+
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '') + conversion
+        return spec % value
+
+    return format_spec_regex.sub(replace, format_string)
+
+
+class Decoder:
+    """Turns console output into text, decoding the log frames in it as they come in.
+    """
+    def __init__(self, table):
+        self.table = table
+        self.frame = None
+        self.frame_size = None
+
+    def decode_frame(self, frame):
+        payload = cobs_decode(frame)
+        if len(payload) < 2:
+            return '<short binlog frame>\n'
+
+        log_id = payload[0] | payload[1] << 8
+        if log_id not in self.table:
+            return '<unknown binlog id 0x%04X>\n' % log_id
+
+        return format_message(self.table[log_id], payload[2:])
+
+    def feed(self, data):
+        """Returns the text for the console output in data, holding back a frame that isn't complete yet.
+        """
+        text = []
+
+        for byte in data:
+            if byte == 0:
+                # The console pads its reports with 0, which never appears in a frame
+                continue
+            elif self.frame_size is None and self.frame is not None:
+                self.frame_size = byte
+            elif self.frame is not None:
+                self.frame.append(byte)
+                if len(self.frame) == self.frame_size:
+                    text.append(self.decode_frame(self.frame))
+                    self.frame = None
+                    self.frame_size = None
+            elif byte == FRAME_START:
+                self.frame = bytearray()
+            else:
+                text.append(chr(byte))
+
+        return ''.join(text)
@@ -6,6 +6,7 @@ import sys
 
 from milc import cli
 
+from . import binlog
 from . import c2json
 from . import cformat
 from . import chibios
@@ -26,6 +27,7 @@ from . import list
 from . import kle2json
 from . import new
 from . import pyformat
+from . import profile
 from . import pytest
 
 # Supported version information
@@ -0,0 +1,42 @@
+"""Decode the log output of firmware built with `BINLOG_ENABLE = yes`.
+"""
+import sys
+
+from milc import cli
+
+import qmk.binlog
+import qmk.path
+
+
+@cli.argument('-t', '--table', arg_only=True, type=qmk.path.normpath, help='The table written by `qmk generate-binlog-table`')
+@cli.argument('-e', '--elf', arg_only=True, type=qmk.path.normpath, help='The firmware ELF file, instead of a table')
+@cli.argument('filename', arg_only=True, nargs='?', default='-', help='Console output to decode, defaults to stdin')
+@cli.subcommand('Decodes binlog console output into text.')
+def binlog(cli):
+    """Prints console output, with the log frames in it turned back into the messages they stand for.
+
+    The output is read as it comes in, so the output of a console listener can be piped into this.
+    """
+    if cli.args.table:
+        table = qmk.binlog.load_table(cli.args.table)
+    elif cli.args.elf:
+        section = qmk.binlog.read_elf_section(cli.args.elf)
+        if section is None:
+            cli.log.error('%s has no %s section, was it built with BINLOG_ENABLE = yes?', cli.args.elf, qmk.binlog.SECTION)
+            return False
+        table = qmk.binlog.format_table(section)
+    else:
+        cli.log.error('Either --table or --elf is needed to decode the log.')
+        cli.print_usage()
+        return False
+
+    decoder = qmk.binlog.Decoder(table)
+    source = sys.stdin.buffer if cli.args.filename == '-' else open(qmk.path.normpath(cli.args.filename), 'rb')
+
+    with source:
+        while True:
+            data = source.read1(1024) if hasattr(source, 'read1') else source.read(1024)
+            if not data:
+                break
+            sys.stdout.write(decoder.feed(data))
+            sys.stdout.flush()
@@ -1,4 +1,5 @@
 from . import api
+from . import binlog_table
 from . import config_h
 from . import dfu_header
 from . import docs
@@ -0,0 +1,40 @@
+"""Generate the table `qmk binlog` decodes log output with.
+"""
+import json
+
+from milc import cli
+
+import qmk.binlog
+import qmk.path
+
+
+@cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help='Quiet mode, only output error messages')
+@cli.argument('elf', arg_only=True, type=qmk.path.normpath, help='The firmware ELF file')
+@cli.subcommand('Generates the table of binlog format strings from a firmware ELF file.')
+def generate_binlog_table(cli):
+    """Extracts the format strings that firmware built with `BINLOG_ENABLE = yes` logs by id.
+    """
+    if not cli.args.elf.exists():
+        cli.log.error('ELF file does not exist!')
+        return False
+
+    section = qmk.binlog.read_elf_section(cli.args.elf)
+    if section is None:
+        cli.log.error('%s has no %s section, was it built with BINLOG_ENABLE = yes?', cli.args.elf, qmk.binlog.SECTION)
+        return False
+
+    if len(section) > 0x10000:
+        cli.log.warning('The format strings take up %d bytes, so the ids of the ones after the first 64KiB are ambiguous.', len(section))
+
+    table = qmk.binlog.format_table(section)
+    table_json = json.dumps({str(key): value for key, value in table.items()}, indent=4)
+
+    if cli.args.output:
+        cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+        cli.args.output.write_text(table_json + '\n')
+
+        if not cli.args.quiet:
+            cli.log.info('Wrote %d format strings to %s.', len(table), cli.args.output)
+    else:
+        print(table_json)
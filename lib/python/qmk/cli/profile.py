@@ -0,0 +1,59 @@
+"""Read the stage timings of firmware built with `TASK_PROFILER_ENABLE = yes`.
+"""
+from milc import cli
+
+import qmk.task_profiler
+
+
+def find_device(device):
+    """Returns the raw HID interface of the first keyboard matching the optional `VID:PID`.
+    """
+    import hid
+
+    for interface in hid.enumerate():
+        if interface['usage_page'] != qmk.task_profiler.RAW_USAGE_PAGE or interface['usage'] != qmk.task_profiler.RAW_USAGE:
+            continue
+        if device and '%04x:%04x' % (interface['vendor_id'], interface['product_id']) != device.lower():
+            continue
+        return interface
+
+    return None
+
+
+@cli.argument('-d', '--device', help='The VID:PID of the keyboard, defaults to the first one with a raw HID interface')
+@cli.argument('-r', '--reset', arg_only=True, action='store_true', help='Start the timings over after reading them')
+@cli.subcommand('Prints how long each stage of the keyboard task takes.')
+def profile(cli):
+    """Reads the timings from a keyboard over raw HID, and prints them in microseconds.
+
+    The percentiles are estimates, that can be up to twice the real value.
+    """
+    try:
+        import hid
+    except ImportError:
+        cli.log.error('The hid package is needed to talk to the keyboard, install it with `python3 -m pip install hid`.')
+        return False
+
+    interface = find_device(cli.config.profile.device)
+    if not interface:
+        cli.log.error('No keyboard with a raw HID interface found.')
+        return False
+
+    timings = []
+    with hid.Device(path=interface['path']) as device:
+        stage_count = len(qmk.task_profiler.STAGES)
+        stage = 0
+        while stage < stage_count:
+            # The first byte is the report id, which raw HID doesn't use
+            device.write(b'\0' + qmk.task_profiler.request(stage, cli.args.reset))
+            response = qmk.task_profiler.parse_response(device.read(qmk.task_profiler.REPORT_SIZE, 1000))
+            if not response:
+                cli.log.error('%s did not answer, was it built with TASK_PROFILER_ENABLE = yes?', interface['product_string'])
+                return False
+            stage_count = response['stage_count']
+            timings.append(response)
+            stage += 1
+
+    cli.echo('Keyboard task timings of %s in microseconds:', interface['product_string'])
+    for line in qmk.task_profiler.format_table(timings):
+        cli.echo(line)
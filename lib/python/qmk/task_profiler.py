@@ -0,0 +1,55 @@
+"""Functions for reading the stage timings of firmware built with `TASK_PROFILER_ENABLE = yes`.
+
+See tmk_core/common/task_profiler.h for the raw HID request and response.
+"""
+import struct
+
+RAW_HID_ID = 0x17
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE = 0x61
+REPORT_SIZE = 32
+RESET = 0x01
+
+# In the order of task_profiler_stage_t
+STAGES = ['housekeeping', 'matrix_scan', 'action_exec', 'rgblight', 'rgb_matrix', 'backlight', 'encoder', 'oled', 'mouse', 'midi', 'led_sync', 'other', 'total']
+COLUMNS = ['count', 'min', 'avg', 'max', 'p50', 'p90', 'p99']
+
+response_format = '>BBBBH6I'
+
+
+def request(stage, reset=False):
+    """Returns the raw HID report asking for the timings of a stage.
+    """
+    report = bytes([RAW_HID_ID, stage, RESET if reset else 0])
+    return report + bytes(REPORT_SIZE - len(report))
+
+
+def parse_response(data):
+    """Returns the timings in a response as a dict, or None if it isn't a response from the profiler.
+
+    The stage is given by its name when this knows it, and the times are in microseconds.
+    """
+    if len(data) < struct.calcsize(response_format) or data[0] != RAW_HID_ID:
+        return None
+
+    _, stage, _, stage_count, *values = struct.unpack_from(response_format, data)
+    timings = dict(zip(COLUMNS, values))
+    timings['stage'] = STAGES[stage] if stage < len(STAGES) else 'stage %d' % stage
+    timings['stage_count'] = stage_count
+
+    return timings
+
+
+def format_table(timings):
+    """Returns the lines of a table of the stages that ran, as returned by parse_response().
+    """
+    rows = [['stage'] + COLUMNS + ['%']]
+    total = next((stage['avg'] * stage['count'] for stage in timings if stage['stage'] == 'total'), 0)
+
+    for stage in timings:
+        if stage['count']:
+            share = '%.1f' % (100 * stage['avg'] * stage['count'] / total) if total else ''
+            rows.append([stage['stage']] + [str(stage[column]) for column in COLUMNS] + [share])
+
+    widths = [max(len(row[i]) for row in rows) for i in range(len(rows[0]))]
+    return [' '.join([row[0].ljust(widths[0])] + [cell.rjust(width) for cell, width in zip(row[1:], widths[1:])]).rstrip() for row in rows]
@@ -0,0 +1,99 @@
+import struct
+
+import qmk.binlog
+
+
+def encode_number(value):
+    """Encodes a number like binlog_number() does.
+    """
+    value &= 0xFFFFFFFF
+    encoded = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        encoded.append(byte | 0x80 if value else byte)
+        if not value:
+            return bytes(encoded)
+
+
+def frame(log_id, *args):
+    """Builds the frame binlog() sends for a log call, COBS encoding the payload like binlog_end() does.
+    """
+    payload = bytes([log_id & 0xFF, log_id >> 8])
+    for arg in args:
+        payload += arg.encode() + b'\0' if isinstance(arg, str) else encode_number(arg)
+
+    encoded = b''.join(bytes([len(block) + 1]) + block for block in payload.split(b'\0'))
+    return bytes([qmk.binlog.FRAME_START, len(encoded)]) + encoded
+
+
+def elf32(sections):
+    """Builds a little endian 32 bit ELF file with the given sections and nothing else.
+    """
+    names = b'\0' + b''.join(name.encode() + b'\0' for name in sections) + b'.shstrtab\0'
+    contents = list(sections.values()) + [names]
+    data_offset = 0x34
+    headers = [struct.pack('<IIIIIIIIII', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)]
+    name_offset = 1
+    data = b''
+    for name, content in zip(list(sections) + ['.shstrtab'], contents):
+        headers.append(struct.pack('<IIIIIIIIII', name_offset, 1, 0, 0, data_offset + len(data), len(content), 0, 0, 1, 0))
+        name_offset += len(name) + 1
+        data += content
+
+    section_offset = data_offset + len(data)
+    header = b'\x7fELF\x01\x01\x01' + bytes(9) + struct.pack('<HHIIIIIHHHHHH', 1, 0x53, 1, 0, 0, section_offset, 0, 0x34, 0, 0, 40, len(headers), len(headers) - 1)
+    return header + data + b''.join(headers)
+
+
+def test_format_table_skips_padding():
+    section = b'first %u\n\0\0\0\0second\0'
+    assert qmk.binlog.format_table(section) == {0: 'first %u\n', 13: 'second'}
+
+
+def test_read_elf_section(tmp_path):
+    elf_file = tmp_path / 'firmware.elf'
+    elf_file.write_bytes(elf32({'.text': b'\x01\x02\x03', '.qmk_binlog': b'hello %s\0'}))
+    assert qmk.binlog.read_elf_section(elf_file) == b'hello %s\0'
+    assert qmk.binlog.read_elf_section(elf_file, '.data') is None
+
+
+def test_format_numbers():
+    payload = encode_number(0) + encode_number(127) + encode_number(128) + encode_number(-1) + encode_number(0xABCD) + encode_number(5)
+    assert qmk.binlog.format_message('%u %u %u %d %04X %08b', payload) == '0 127 128 -1 ABCD 00000101'
+
+
+def test_format_strings_and_chars():
+    payload = b'ab\0' + encode_number(ord('x')) + b'\0'
+    assert qmk.binlog.format_message('[%s] %c [%s] 100%%', payload) == '[ab] x [] 100%'
+
+
+def test_format_width_from_argument():
+    payload = encode_number(4) + encode_number(7)
+    assert qmk.binlog.format_message('%*u|', payload) == '   7|'
+
+
+def test_format_missing_arguments():
+    assert qmk.binlog.format_message('%u %s %u', encode_number(1)) == '1 ? ?'
+
+
+def test_cobs_decode():
+    assert qmk.binlog.cobs_decode(b'\x03ab\x01\x02c') == b'ab\0\0c'
+
+
+def test_decoder_mixes_frames_and_text():
+    decoder = qmk.binlog.Decoder({0: 'key %u/%u\n', 10: 'layer %s\n'})
+    output = b'boot\n' + frame(0, 3, 7) + b'\0\0\0' + frame(10, 'nav') + frame(42)
+    assert decoder.feed(output) == 'boot\nkey 3/7\nlayer nav\n<unknown binlog id 0x002A>\n'
+
+
+def test_decoder_holds_back_partial_frames():
+    decoder = qmk.binlog.Decoder({0: 'value %u\n'})
+    output = frame(0, 300)
+    assert decoder.feed(output[:3]) == ''
+    assert decoder.feed(output[3:]) == 'value 300\n'
+
+
+def test_decoder_frame_containing_frame_start():
+    decoder = qmk.binlog.Decoder({qmk.binlog.FRAME_START: '%u\n'})
+    assert decoder.feed(frame(qmk.binlog.FRAME_START, qmk.binlog.FRAME_START)) == '30\n'
@@ -0,0 +1,43 @@
+import struct
+
+import qmk.task_profiler
+
+
+def response(stage, count, *values, flags=0, stage_count=13):
+    """Builds the response task_profiler_raw_hid() sends.
+    """
+    data = struct.pack('>BBBBH6I', qmk.task_profiler.RAW_HID_ID, stage, flags, stage_count, count, *values)
+    return data + bytes(qmk.task_profiler.REPORT_SIZE - len(data))
+
+
+def test_request():
+    report = qmk.task_profiler.request(2, reset=True)
+    assert len(report) == qmk.task_profiler.REPORT_SIZE
+    assert report[:4] == bytes([0x17, 2, 1, 0])
+
+
+def test_parse_response():
+    timings = qmk.task_profiler.parse_response(response(1, 300, 10, 20, 0x123456, 15, 31, 63))
+    assert timings == {'stage': 'matrix_scan', 'stage_count': 13, 'count': 300, 'min': 10, 'avg': 20, 'max': 0x123456, 'p50': 15, 'p90': 31, 'p99': 63}
+
+
+def test_parse_response_unknown_stage():
+    assert qmk.task_profiler.parse_response(response(20, 0, 0, 0, 0, 0, 0, 0, stage_count=21))['stage'] == 'stage 20'
+
+
+def test_parse_response_from_something_else():
+    assert qmk.task_profiler.parse_response(bytes([0xFF]) + bytes(31)) is None
+    assert qmk.task_profiler.parse_response(b'') is None
+
+
+def test_format_table_skips_stages_that_didnt_run():
+    timings = [qmk.task_profiler.parse_response(data) for data in (
+        response(0, 10, 100, 300, 500, 255, 511, 511),
+        response(3, 0, 0, 0, 0, 0, 0, 0),
+        response(12, 10, 1000, 1200, 2000, 1023, 2000, 2000),
+    )]
+    assert qmk.task_profiler.format_table(timings) == [
+        'stage        count  min  avg  max  p50  p90  p99     %',
+        'housekeeping    10  100  300  500  255  511  511  25.0',
+        'total           10 1000 1200 2000 1023 2000 2000 100.0',
+    ]
@@ -324,7 +324,7 @@ void  audio_play_click(uint16_t delay, float pitch, uint16_t duration) {
     uint16_t duration_tone  = audio_ms_to_duration(duration);
     uint16_t duration_delay = audio_ms_to_duration(delay);
 
-    if (delay <= 0.0f) {
+    if (delay == 0) {
         click[0][0] = pitch;
         click[0][1] = duration_tone;
         click[1][0] = 0.0f;
@@ -520,20 +520,10 @@ void audio_decrease_tempo(uint8_t tempo_change) {
         note_tempo -= tempo_change;
 }
 
-// TODO in the int-math version are some bugs; songs sometimes abruptly end - maybe an issue with the timer/system-tick wrapping around?
+// integer math, the 32 bit intermediate results can not overflow for any duration and tempo
 uint16_t audio_duration_to_ms(uint16_t duration_bpm) {
-#if defined(__AVR__)
-    // doing int-math saves us some bytes in the overall firmware size, but the intermediate result is less accurate before being cast to/returned as uint
-    return ((uint32_t)duration_bpm * 60 * 1000) / (64 * note_tempo);
-    // NOTE: beware of uint16_t overflows when note_tempo is low and/or the duration is long
-#else
-    return ((float)duration_bpm * 60) / (64 * note_tempo) * 1000;
-#endif
-}
-uint16_t audio_ms_to_duration(uint16_t duration_ms) {
-#if defined(__AVR__)
-    return ((uint32_t)duration_ms * 64 * note_tempo) / 60 / 1000;
-#else
-    return ((float)duration_ms * 64 * note_tempo) / 60 / 1000;
-#endif
+    uint32_t ms = ((uint32_t)duration_bpm * 60 * 1000) / (64 * note_tempo);
+    // 0xffff would be taken for an indefinitely playing tone
+    return ms < 0xffff ? ms : 0xfffe;
 }
+uint16_t audio_ms_to_duration(uint16_t duration_ms) { return ((uint32_t)duration_ms * 64 * note_tempo) / 60 / 1000; }
@@ -0,0 +1,5 @@
+audio_DEFS := -DNO_DEBUG
+
+audio_SRC := \
+	$(QUANTUM_PATH)/audio/tests/wavetable_tests.cpp \
+	$(QUANTUM_PATH)/audio/wavetable.c
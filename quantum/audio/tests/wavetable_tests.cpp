@@ -0,0 +1,137 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+extern "C" {
+#include "wavetable.h"
+}
+
+#define TABLE_BITS 8
+#define TABLE_SIZE (1 << TABLE_BITS)
+#define SAMPLE_MAX 4095
+// the additive DAC driver's default: 16384Hz, with the 2/3 of its timer setup
+#define SAMPLE_RATE 24576.0f
+
+class WavetableTest : public ::testing::Test {
+   protected:
+    uint16_t table[TABLE_SIZE];
+
+    void SetUp() override {
+        // the same shape as the DAC driver's sine: one period, starting at 0
+        for (int i = 0; i < TABLE_SIZE; i++) {
+            table[i] = std::lround(SAMPLE_MAX / 2.0 * (1 - std::cos(2 * M_PI * i / TABLE_SIZE)));
+        }
+    }
+
+    std::vector<uint16_t> render(std::vector<float> frequencies, size_t length) {
+        std::vector<wavetable_phase_t> phases(frequencies.size(), 0), increments;
+        for (float frequency : frequencies) {
+            increments.push_back(wavetable_phase_increment(frequency, SAMPLE_RATE));
+        }
+        std::vector<uint16_t> samples;
+        for (size_t s = 0; s < length; s++) {
+            samples.push_back(wavetable_mix(table, TABLE_BITS, phases.data(), increments.data(), frequencies.size()));
+        }
+        return samples;
+    }
+
+    // The floating point generator the DAC driver used before
+    std::vector<uint16_t> render_float(std::vector<float> frequencies, size_t length) {
+        std::vector<float>    positions(frequencies.size(), 0.0f);
+        std::vector<uint16_t> samples;
+        for (size_t s = 0; s < length; s++) {
+            uint16_t value = 0;
+            for (size_t i = 0; i < frequencies.size(); i++) {
+                positions[i] = positions[i] + (frequencies[i] * TABLE_SIZE) / SAMPLE_RATE;
+                positions[i] = fmod(positions[i], TABLE_SIZE);
+                value += table[(uint16_t)positions[i]] / frequencies.size();
+            }
+            samples.push_back(value);
+        }
+        return samples;
+    }
+
+    // Counts periods by upward crossings of the midpoint, over one second of samples this is the frequency
+    static unsigned count_periods(const std::vector<uint16_t> &samples) {
+        unsigned periods = 0;
+        for (size_t s = 1; s < samples.size(); s++) {
+            if (samples[s - 1] < SAMPLE_MAX / 2 && samples[s] >= SAMPLE_MAX / 2) {
+                periods++;
+            }
+        }
+        return periods;
+    }
+
+    // Relative power at a frequency, using the Goertzel algorithm
+    static double power_at(const std::vector<uint16_t> &samples, double frequency) {
+        double coeff = 2 * std::cos(2 * M_PI * frequency / SAMPLE_RATE);
+        double s1 = 0, s2 = 0;
+        for (uint16_t sample : samples) {
+            double s0 = sample - SAMPLE_MAX / 2.0 + coeff * s1 - s2;
+            s2        = s1;
+            s1        = s0;
+        }
+        return (s1 * s1 + s2 * s2 - coeff * s1 * s2) / samples.size() / samples.size();
+    }
+};
+
+TEST_F(WavetableTest, MatchesFloatGeneratorFrequencies) {
+    for (float frequency : {65.41f, 261.63f, 440.0f, 1046.5f, 4186.0f, 7902.13f}) {
+        SCOPED_TRACE(frequency);
+        auto samples   = render({frequency}, (size_t)SAMPLE_RATE);
+        auto reference = render_float({frequency}, (size_t)SAMPLE_RATE);
+
+        EXPECT_NEAR(count_periods(samples), frequency, 1);
+        EXPECT_NEAR(count_periods(samples), count_periods(reference), 1);
+        EXPECT_NEAR(power_at(samples, frequency), power_at(reference, frequency), power_at(reference, frequency) * 0.01);
+    }
+}
+
+TEST_F(WavetableTest, MatchesFloatGeneratorSpectrum) {
+    auto samples   = render({440.0f, 659.25f}, (size_t)SAMPLE_RATE);
+    auto reference = render_float({440.0f, 659.25f}, (size_t)SAMPLE_RATE);
+
+    double fundamental = power_at(reference, 440.0);
+    for (double frequency = 100; frequency < 2000; frequency += 7.5) {
+        EXPECT_NEAR(power_at(samples, frequency), power_at(reference, frequency), fundamental * 0.01) << "at " << frequency << "Hz";
+    }
+    EXPECT_GT(power_at(samples, 440.0), fundamental * 0.99);
+    EXPECT_GT(power_at(samples, 659.25), fundamental * 0.99);
+}
+
+TEST_F(WavetableTest, PhaseDoesNotDrift) {
+    wavetable_phase_t increment = wavetable_phase_increment(440.0f, SAMPLE_RATE);
+    wavetable_phase_t phase     = 0;
+    uint64_t          periods   = 0;
+    for (uint32_t s = 0; s < 60 * (uint32_t)SAMPLE_RATE; s++) {
+        wavetable_phase_t previous = phase;
+        phase += increment;
+        periods += phase < previous;
+    }
+    // one minute of A4, to within a period
+    EXPECT_NEAR(periods, 60 * 440, 1);
+}
+
+TEST_F(WavetableTest, SkipsSilentAndUnreproducibleTones) {
+    EXPECT_EQ(wavetable_phase_increment(0.0f, SAMPLE_RATE), 0);
+    EXPECT_EQ(wavetable_phase_increment(-440.0f, SAMPLE_RATE), 0);
+    EXPECT_EQ(wavetable_phase_increment(SAMPLE_RATE / 2, SAMPLE_RATE), 0);
+    EXPECT_GT(wavetable_phase_increment(SAMPLE_RATE / 2 - 1, SAMPLE_RATE), 0);
+}
@@ -0,0 +1,36 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wavetable.h"
+
+wavetable_phase_t wavetable_phase_increment(float frequency, float sample_rate) {
+    if (frequency <= 0.0f || frequency * 2 >= sample_rate) {
+        return 0;
+    }
+    // one period is 2^32, split into two factors to stay within float range without losing precision
+    return (wavetable_phase_t)(frequency / sample_rate * 65536.0f * 65536.0f);
+}
+
+uint16_t wavetable_mix(const uint16_t *table, uint8_t table_bits, wavetable_phase_t *phases, const wavetable_phase_t *increments, uint8_t count) {
+    uint16_t value = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        value += table[WAVETABLE_INDEX(phases[i], table_bits)] / count;
+        phases[i] += increments[i];
+    }
+
+    return value;
+}
@@ -0,0 +1,39 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Wavetable synthesis with a fixed-point phase accumulator
+ *
+ * the phase of a tone is a 32 bit fraction of one period, which simply wraps
+ * around at the end of it; the top bits index the sample table. the increment
+ * per sample is calculated once whenever the tone changes, so generating a
+ * sample only takes integer additions and shifts.
+ */
+typedef uint32_t wavetable_phase_t;
+
+// Phase increment per sample for a tone of the given frequency, 0 if it is above half the sample rate
+wavetable_phase_t wavetable_phase_increment(float frequency, float sample_rate);
+
+// Index into a table of 2^table_bits samples for the given phase
+#define WAVETABLE_INDEX(phase, table_bits) ((phase) >> (32 - (table_bits)))
+
+/* Generates one sample by adding up the table samples of all tones, each scaled by the number of
+ * tones, then advances the phase of each tone by its increment.
+ */
+uint16_t wavetable_mix(const uint16_t *table, uint8_t table_bits, wavetable_phase_t *phases, const wavetable_phase_t *increments, uint8_t count);
@@ -0,0 +1,83 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include "binlog.h"
+#include "sendchar.h"
+
+// So the encoded frame fits the size byte, and its blocks never need to be split
+#if BINLOG_BUFFER_SIZE > 253
+#    error "BINLOG_BUFFER_SIZE must be at most 253"
+#endif
+
+// The payload of the frame being logged. Once an argument doesn't fit, it and the ones after it are left out, which
+// the decoder shows as missing.
+static uint8_t binlog_buffer[BINLOG_BUFFER_SIZE];
+static uint8_t binlog_size;
+static bool    binlog_full;
+
+void binlog_begin(uint16_t id) {
+    binlog_buffer[0] = id & 0xFF;
+    binlog_buffer[1] = id >> 8;
+    binlog_size      = 2;
+    binlog_full      = false;
+}
+
+void binlog_number(uint32_t value) {
+    uint8_t size = binlog_size;
+    do {
+        if (binlog_full || size == BINLOG_BUFFER_SIZE) {
+            binlog_full = true;
+            return;
+        }
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        binlog_buffer[size++] = value ? byte | 0x80 : byte;
+    } while (value);
+    binlog_size = size;
+}
+
+void binlog_string(const char *str) {
+    uint8_t size = binlog_size;
+    do {
+        if (binlog_full || size == BINLOG_BUFFER_SIZE) {
+            binlog_full = true;
+            return;
+        }
+        binlog_buffer[size++] = *str;
+    } while (*str++);
+    binlog_size = size;
+}
+
+/** \brief Sends the frame, with the payload COBS encoded so that there's no 0 in it for the console to drop as padding
+ */
+void binlog_end(void) {
+    // Each 0 is replaced by the size of the block of bytes after it, plus one for the size of the first block
+    sendchar(BINLOG_FRAME_START);
+    sendchar(binlog_size + 1);
+    uint8_t start = 0;
+    while (start <= binlog_size) {
+        uint8_t end = start;
+        while (end < binlog_size && binlog_buffer[end] != 0) {
+            end++;
+        }
+        sendchar(end - start + 1);
+        for (uint8_t i = start; i < end; i++) {
+            sendchar(binlog_buffer[i]);
+        }
+        start = end + 1;
+    }
+}
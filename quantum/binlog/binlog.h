@@ -0,0 +1,102 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Dictionary-encoded logging. Instead of formatting messages on the keyboard, each log site sends the id of its
+// format string and the raw arguments, and `qmk binlog` turns them back into text on the host.
+//
+// The format strings are placed in the .qmk_binlog section of the ELF file, which binlog.ld keeps out of flash and RAM.
+// The id of a log site is the offset of its format string in that section, which the linker assigns when building.
+// `qmk generate-binlog-table` extracts the strings into the table the decoder uses.
+//
+// A log call is sent to the console as a frame, which can be mixed with ordinary text:
+//   BINLOG_FRAME_START, the size of the encoded payload, the COBS encoded payload
+// There is no 0 in a frame, as the console pads its reports with 0.
+// The payload is the id as two little endian bytes, followed by the arguments:
+//   - strings as their bytes and a 0
+//   - everything else converted to uint32_t, and sent 7 bits at a time starting from the lowest, with the top bit
+//     set on every byte but the last
+// As the format string isn't available here, signed, 64-bit and floating point arguments are only supported as far as
+// the decoder can recover them from the uint32_t they were converted to. Pointers for %p are sent as numbers, and have
+// to be passed as void * in C, like for printf. Strings have to be in RAM, so %S isn't supported.
+
+#include <stdint.h>
+
+#ifndef BINLOG_BUFFER_SIZE
+#    define BINLOG_BUFFER_SIZE 64
+#endif
+
+#define BINLOG_FRAME_START 0x1E
+
+// The id of a format string, which is stored in the ELF file only
+#define BINLOG_ID(fmt)                                                                                   \
+    ({                                                                                                   \
+        static const char binlog_format[] __attribute__((section(".qmk_binlog"), used, aligned(1))) = fmt; \
+        (uint16_t)(uintptr_t)binlog_format;                                                              \
+    })
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void binlog_begin(uint16_t id);
+void binlog_number(uint32_t value);
+void binlog_string(const char *str);
+void binlog_end(void);
+
+static inline void binlog_pointer(const void *ptr) { binlog_number((uintptr_t)ptr); }
+
+#ifdef __cplusplus
+}
+
+static inline void binlog_arg(const char *str) { binlog_string(str); }
+static inline void binlog_arg(char *str) { binlog_string(str); }
+template <typename T>
+static inline void binlog_arg(T *ptr) {
+    binlog_pointer(ptr);
+}
+template <typename T>
+static inline void binlog_arg(T value) {
+    binlog_number((uint32_t)value);
+}
+#else
+#    define binlog_arg(x) _Generic((x), char * : binlog_string, const char * : binlog_string, void * : binlog_pointer, const void * : binlog_pointer, default : binlog_number)(x)
+#endif
+
+// clang-format off
+#define BINLOG_ARGS_0()
+#define BINLOG_ARGS_1(a) binlog_arg(a);
+#define BINLOG_ARGS_2(a, ...) binlog_arg(a); BINLOG_ARGS_1(__VA_ARGS__)
+#define BINLOG_ARGS_3(a, ...) binlog_arg(a); BINLOG_ARGS_2(__VA_ARGS__)
+#define BINLOG_ARGS_4(a, ...) binlog_arg(a); BINLOG_ARGS_3(__VA_ARGS__)
+#define BINLOG_ARGS_5(a, ...) binlog_arg(a); BINLOG_ARGS_4(__VA_ARGS__)
+#define BINLOG_ARGS_6(a, ...) binlog_arg(a); BINLOG_ARGS_5(__VA_ARGS__)
+#define BINLOG_ARGS_7(a, ...) binlog_arg(a); BINLOG_ARGS_6(__VA_ARGS__)
+#define BINLOG_ARGS_8(a, ...) binlog_arg(a); BINLOG_ARGS_7(__VA_ARGS__)
+#define BINLOG_COUNT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define BINLOG_COUNT(...) BINLOG_COUNT_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_CAT_(a, b) a##b
+#define BINLOG_CAT(a, b) BINLOG_CAT_(a, b)
+// clang-format on
+
+// Logs the format string and up to 8 arguments, like printf
+#define binlog(fmt, ...)                                                    \
+    do {                                                                    \
+        binlog_begin(BINLOG_ID(fmt));                                       \
+        BINLOG_CAT(BINLOG_ARGS_, BINLOG_COUNT(__VA_ARGS__))(__VA_ARGS__) \
+        binlog_end();                                                       \
+    } while (0)
@@ -0,0 +1,217 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+extern "C" {
+#include "print.h"
+void binlog_c_args(void* ptr, const void* const_ptr, const char* str, uint8_t number);
+}
+#include "binlog.h"
+#include "debug.h"
+
+// Everything sent to the console
+static std::vector<uint8_t> console;
+
+extern "C" int8_t sendchar(uint8_t c) {
+    console.push_back(c);
+    return 0;
+}
+
+// The .qmk_binlog section of this executable, which is what the table is generated from
+static std::vector<char> format_strings() {
+    std::ifstream     file("/proc/self/exe", std::ios::binary);
+    std::vector<char> elf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const Elf64_Ehdr* header   = (const Elf64_Ehdr*)elf.data();
+    const Elf64_Shdr* sections = (const Elf64_Shdr*)(elf.data() + header->e_shoff);
+    const char*       names    = elf.data() + sections[header->e_shstrndx].sh_offset;
+    for (int i = 0; i < header->e_shnum; i++) {
+        if (strcmp(names + sections[i].sh_name, ".qmk_binlog") == 0) {
+            EXPECT_EQ(sections[i].sh_flags & SHF_ALLOC, 0u) << "the format strings would be loaded";
+            return std::vector<char>(elf.data() + sections[i].sh_offset, elf.data() + sections[i].sh_offset + sections[i].sh_size);
+        }
+    }
+    return {};
+}
+
+// The payloads of the frames sent to the console
+static std::vector<std::vector<uint8_t>> frames() {
+    std::vector<std::vector<uint8_t>> result;
+    size_t                            i = 0;
+    while (i < console.size()) {
+        if (console[i++] != BINLOG_FRAME_START) {
+            continue;
+        }
+        EXPECT_LT(i, console.size()) << "frame has no size";
+        size_t end = i + 1 + console[i];
+        EXPECT_LE(end, console.size()) << "frame is cut off";
+        EXPECT_EQ(std::count(console.begin() + i, console.begin() + end, 0), 0) << "0 in a frame";
+        std::vector<uint8_t> payload;
+        for (i++; i < end;) {
+            uint8_t code = console[i++];
+            payload.insert(payload.end(), console.begin() + i, console.begin() + i + code - 1);
+            i += code - 1;
+            if (i < end) {
+                payload.push_back(0);
+            }
+        }
+        result.push_back(payload);
+    }
+    return result;
+}
+
+static uint16_t id(const std::vector<uint8_t>& payload) { return payload[0] | (payload[1] << 8); }
+
+static std::vector<uint8_t> args(const std::vector<uint8_t>& payload) { return std::vector<uint8_t>(payload.begin() + 2, payload.end()); }
+
+class Binlog : public testing::Test {
+   protected:
+    Binlog() { console.clear(); }
+};
+
+TEST_F(Binlog, IdIsTheOffsetOfTheFormatString) {
+    binlog("first %u\n", 1);
+    binlog("second\n");
+    std::vector<char> strings = format_strings();
+    auto              sent    = frames();
+    ASSERT_EQ(sent.size(), 2u);
+    ASSERT_LT(id(sent[0]), strings.size());
+    ASSERT_LT(id(sent[1]), strings.size());
+    EXPECT_STREQ(&strings[id(sent[0])], "first %u\n");
+    EXPECT_STREQ(&strings[id(sent[1])], "second\n");
+    EXPECT_EQ(args(sent[1]).size(), 0u);
+}
+
+TEST_F(Binlog, NumbersAreSentSevenBitsAtATime) {
+    int16_t  minus_one = -1;
+    uint32_t big       = 0x12345678;
+    binlog("%u %u %u %d %lX", 0, 127, 128, minus_one, big);
+    auto sent = frames();
+    ASSERT_EQ(sent.size(), 1u);
+    std::vector<uint8_t> expected = {0x00, 0x7F, 0x80, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xF8, 0xAC, 0xD1, 0x91, 0x01};
+    EXPECT_EQ(args(sent[0]), expected);
+}
+
+TEST_F(Binlog, StringsAreSentWithTheirTerminator) {
+    char        name[] = "ab";
+    const char* empty  = "";
+    binlog("%s=%u%s", name, 3, empty);
+    auto sent = frames();
+    ASSERT_EQ(sent.size(), 1u);
+    std::vector<uint8_t> expected = {'a', 'b', 0, 3, 0};
+    EXPECT_EQ(args(sent[0]), expected);
+}
+
+TEST_F(Binlog, PointersAreSentAsNumbers) {
+    int value;
+    binlog("%p %p", (void*)0x1234, &value);
+    binlog_c_args((void*)0x81, (const void*)0x02, "c", 3);
+    auto sent = frames();
+    ASSERT_EQ(sent.size(), 2u);
+    uint32_t             address  = (uint32_t)(uintptr_t)&value;
+    std::vector<uint8_t> expected = {0xB4, 0x24};
+    for (; address > 0x7F; address >>= 7) {
+        expected.push_back((address & 0x7F) | 0x80);
+    }
+    expected.push_back(address);
+    EXPECT_EQ(args(sent[0]), expected);
+    expected = {0x81, 0x01, 0x02, 'c', 0, 3};
+    EXPECT_EQ(args(sent[1]), expected);
+}
+
+TEST_F(Binlog, ArgumentsThatDontFitAreLeftOut) {
+    std::string long_string(BINLOG_BUFFER_SIZE, 'x');
+    binlog("%u %s %u", 1, long_string.c_str(), 2);
+    auto sent = frames();
+    ASSERT_EQ(sent.size(), 1u);
+    // Not even the number after the string, which would fit, so the decoder can tell where the frame was cut off
+    std::vector<uint8_t> expected = {1};
+    EXPECT_EQ(args(sent[0]), expected);
+}
+
+TEST_F(Binlog, FramesCanBeMixedWithText) {
+    print_set_sendchar(sendchar);
+    printf_("text ");
+    binlog("%u", 0);
+    printf_("more text\n");
+    auto sent = frames();
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(args(sent[0]), std::vector<uint8_t>{0});
+    EXPECT_EQ(std::string(console.begin(), console.begin() + 5), "text ");
+    EXPECT_EQ(std::string(console.end() - 10, console.end()), "more text\n");
+}
+
+TEST_F(Binlog, DprintfSendsFramesWhenDebugIsEnabled) {
+    debug_enable = false;
+    dprintf("not sent %u\n", 1);
+    EXPECT_TRUE(console.empty());
+    debug_enable = true;
+    dprintf("sent %u\n", 1);
+    debug_enable = false;
+    auto sent = frames();
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_STREQ(&format_strings()[id(sent[0])], "sent %u\n");
+}
+
+// Bytes sent and time taken per call, for messages like the ones the debug options print
+TEST_F(Binlog, BytesAndTimePerCallComparedToPrintf) {
+    struct Profile {
+        const char* name;
+        void (*binlog_call)(void);
+        void (*printf_call)(void);
+    };
+#define PROFILE(name, fmt, ...) \
+    { name, [] { binlog(fmt, __VA_ARGS__); }, [] { printf_(fmt, __VA_ARGS__); } }
+    static volatile uint8_t  row = 3, col = 7, mods = 0x02;
+    static volatile uint16_t keycode = 0x0004, time = 12345;
+    static volatile uint32_t layers  = 0x00000005;
+    Profile                  profiles[] = {
+        PROFILE("key event", "%u/%u pressed at %u\n", row, col, time),
+        PROFILE("keycode", "process_record: kc: %04X, col: %u, row: %u, pressed: %u, time: %u\n", keycode, col, row, 1, time),
+        PROFILE("report", "keyboard_report: %02X | %02X %02X %02X %02X %02X %02X\n", mods, 4, 5, 6, 0, 0, 0),
+        PROFILE("layer state", "layer_state: %08lX(%u)\n", layers, 2),
+    };
+#undef PROFILE
+    print_set_sendchar(sendchar);
+    const int calls        = 20000;
+    size_t    total_binlog = 0;
+    size_t    total_printf = 0;
+    fprintf(stdout, "\n  %-12s %14s %14s %12s %12s\n", "message", "binlog bytes", "printf bytes", "binlog ns", "printf ns");
+    for (auto& profile : profiles) {
+        double bytes[2], ns[2];
+        for (int which = 0; which < 2; which++) {
+            console.clear();
+            console.reserve(calls * 80);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; i++) {
+                (which == 0 ? profile.binlog_call : profile.printf_call)();
+            }
+            ns[which]    = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+            bytes[which] = (double)console.size() / calls;
+        }
+        fprintf(stdout, "  %-12s %14.1f %14.1f %12.1f %12.1f\n", profile.name, bytes[0], bytes[1], ns[0], ns[1]);
+        total_binlog += bytes[0];
+        total_printf += bytes[1];
+    }
+    EXPECT_LT(total_binlog * 3, total_printf);
+}
@@ -0,0 +1,14 @@
+binlog_DEFS := -DBINLOG_ENABLE -fno-pie
+
+binlog_SRC := \
+	$(QUANTUM_PATH)/binlog/tests/binlog_tests.cpp \
+	$(QUANTUM_PATH)/binlog/binlog.c \
+	$(QUANTUM_PATH)/binlog/tests/binlog_c_args.c \
+	$(TMK_PATH)/common/debug.c \
+	$(TMK_PATH)/common/printf.c \
+	$(LIB_PATH)/printf/printf.c
+
+# The ids are the offsets the format strings are linked at, which a position independent executable would relocate
+ifeq ($(strip $(TEST)), binlog)
+    LDFLAGS += -no-pie -Wl,-T,$(QUANTUM_PATH)/binlog/binlog.ld
+endif
@@ -0,0 +1,83 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Per-key algorithm using vertical counters, works like sym_eager_pk.
+After pressing a key, it immediately changes state, and starts its counter.
+No further inputs are accepted for that key until DEBOUNCE milliseconds have occurred.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include "vertical_counter.h"
+
+#if DEBOUNCE > 0
+static vc_row_t debounce_counters[MATRIX_ROWS];
+static uint16_t last_time;
+static bool     counters_need_update;
+static bool     matrix_need_update;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        vc_load(&debounce_counters[row], ~(matrix_row_t)0, 0);
+    }
+    counters_need_update = false;
+    matrix_need_update   = false;
+    last_time            = timer_read();
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint8_t elapsed = vc_elapsed(&last_time);
+    if (counters_need_update) {
+        counters_need_update = false;
+        for (uint8_t row = 0; row < num_rows; row++) {
+            vc_count_down(&debounce_counters[row], elapsed);
+            if (vc_active(&debounce_counters[row])) {
+                counters_need_update = true;
+            }
+        }
+    }
+
+    if (changed || matrix_need_update) {
+        matrix_need_update = false;
+        for (uint8_t row = 0; row < num_rows; row++) {
+            matrix_row_t delta  = raw[row] ^ cooked[row];
+            matrix_row_t locked = vc_active(&debounce_counters[row]);
+            matrix_row_t ready  = delta & ~locked;
+            if (ready) {
+                vc_load(&debounce_counters[row], ready, DEBOUNCE);
+                cooked[row] ^= ready;
+                counters_need_update = true;
+            }
+            if (delta & locked) {
+                matrix_need_update = true;
+            }
+        }
+    }
+}
+
+bool debounce_active(void) { return counters_need_update; }
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        cooked[row] = raw[row];
+    }
+}
+
+bool debounce_active(void) { return false; }
+#endif
@@ -0,0 +1,31 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "matrix.h"
+
+#define DEBOUNCE_ALGORITHM(name)                                                                \
+    void name##_debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed); \
+    bool name##_debounce_active(void);                                                         \
+    void name##_debounce_init(uint8_t num_rows);
+
+DEBOUNCE_ALGORITHM(sym_defer_g)
+DEBOUNCE_ALGORITHM(sym_eager_pr)
+DEBOUNCE_ALGORITHM(sym_eager_pk)
+DEBOUNCE_ALGORITHM(sym_defer_pk)
+DEBOUNCE_ALGORITHM(sym_eager_vc)
+DEBOUNCE_ALGORITHM(sym_defer_vc)
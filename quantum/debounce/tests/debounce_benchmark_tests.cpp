@@ -0,0 +1,308 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs every debounce algorithm over simulated switches, and prints how each one did:
+ * - events: presses and releases of the simulated switches
+ * - missed: events that never showed up in the debounced matrix
+ * - ghost: extra changes in the debounced matrix, caused by bounce or noise
+ * - latency: time from the switch event to the debounced change, in ms
+ * - ns/scan: host time per scan, to compare the algorithms' cost
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "debounce_algorithms.h"
+void advance_time(uint32_t ms);
+}
+
+struct Algorithm {
+    const char *name;
+    bool        eager;
+    bool        per_key;
+    void (*init)(uint8_t num_rows);
+    void (*debounce)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+};
+
+static const Algorithm algorithms[] = {
+    {"sym_defer_g", false, false, sym_defer_g_debounce_init, sym_defer_g_debounce},
+    {"sym_eager_pr", true, false, sym_eager_pr_debounce_init, sym_eager_pr_debounce},
+    {"sym_eager_pk", true, true, sym_eager_pk_debounce_init, sym_eager_pk_debounce},
+    {"sym_defer_pk", false, true, sym_defer_pk_debounce_init, sym_defer_pk_debounce},
+    {"sym_eager_vc", true, true, sym_eager_vc_debounce_init, sym_eager_vc_debounce},
+    {"sym_defer_vc", false, true, sym_defer_vc_debounce_init, sym_defer_vc_debounce},
+};
+
+// A press or release of a switch, and how long its contacts bounce afterwards
+struct Event {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+    uint8_t  bounce;
+};
+
+// A single scan where a switch reads the wrong way
+struct Spike {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+};
+
+struct Profile {
+    std::vector<Event> events;
+    std::vector<Spike> spikes;
+    uint32_t           length;
+};
+
+struct Result {
+    unsigned              events = 0;
+    unsigned              missed = 0;
+    unsigned              ghost  = 0;
+    std::vector<uint32_t> latency;
+    double                ns_per_scan = 0;
+};
+
+class DebounceBenchmark : public ::testing::Test {
+   protected:
+    std::mt19937 rng{1234};
+
+    uint32_t random(uint32_t min, uint32_t max) { return std::uniform_int_distribution<uint32_t>(min, max)(rng); }
+
+    // Picks count different keys anywhere in the matrix
+    std::vector<std::pair<uint8_t, uint8_t>> random_keys(unsigned count) {
+        std::vector<std::pair<uint8_t, uint8_t>> keys;
+        while (keys.size() < count) {
+            std::pair<uint8_t, uint8_t> key = {random(0, MATRIX_ROWS - 1), random(0, MATRIX_COLS - 1)};
+            if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+                keys.push_back(key);
+            }
+        }
+        return keys;
+    }
+
+    // Presses and releases keys one after the other, at random times, each with bounce_min to bounce_max ms of bounce
+    Profile typing(unsigned keys, uint8_t bounce_min, uint8_t bounce_max) {
+        Profile profile = {{}, {}, 0};
+        for (auto &key : random_keys(keys)) {
+            uint32_t time = random(0, 50);
+            for (bool pressed : {true, false, true, false, true, false}) {
+                profile.events.push_back({time, key.first, key.second, pressed, (uint8_t)random(bounce_min, bounce_max)});
+                time += random(bounce_max + 30, bounce_max + 120);
+            }
+            profile.length = std::max(profile.length, time);
+        }
+        return profile;
+    }
+
+    // Presses a group of keys at the same time, spread over all rows, then releases them all together
+    Profile chords(unsigned count, unsigned size) {
+        Profile  profile = {{}, {}, 0};
+        uint32_t time    = 10;
+        for (unsigned chord = 0; chord < count; chord++) {
+            std::vector<std::pair<uint8_t, uint8_t>> keys = random_keys(size);
+            for (bool pressed : {true, false}) {
+                for (auto &key : keys) {
+                    profile.events.push_back({time, key.first, key.second, pressed, (uint8_t)random(1, DEBOUNCE - 1)});
+                }
+                time += 60;
+            }
+        }
+        profile.length = time;
+        return profile;
+    }
+
+    // No key is pressed, but switches read as pressed for a single scan now and then
+    Profile noise(unsigned count) {
+        Profile profile = {{}, {}, 0};
+        for (unsigned i = 0; i < count; i++) {
+            profile.spikes.push_back({random(0, count * 20), (uint8_t)random(0, MATRIX_ROWS - 1), (uint8_t)random(0, MATRIX_COLS - 1)});
+        }
+        profile.length = count * 20;
+        return profile;
+    }
+
+    // Builds the raw matrix for every ms of the profile
+    std::vector<std::vector<matrix_row_t>> render(Profile &profile) {
+        std::sort(profile.events.begin(), profile.events.end(), [](const Event &a, const Event &b) { return a.time < b.time; });
+        profile.length += 100;
+        std::vector<std::vector<matrix_row_t>> scans(profile.length, std::vector<matrix_row_t>(MATRIX_ROWS, 0));
+        for (auto &event : profile.events) {
+            matrix_row_t mask = MATRIX_ROW_SHIFTER << event.col;
+            for (uint32_t t = event.time; t < profile.length; t++) {
+                bool level = event.pressed;
+                // The first sample after the edge reads the new level, after that it bounces until it settles
+                if (t > event.time && t < event.time + event.bounce) {
+                    level = random(0, 1);
+                }
+                scans[t][event.row] = level ? scans[t][event.row] | mask : scans[t][event.row] & ~mask;
+            }
+        }
+        for (auto &spike : profile.spikes) {
+            scans[spike.time][spike.row] ^= MATRIX_ROW_SHIFTER << spike.col;
+        }
+        return scans;
+    }
+
+    Result run(const Algorithm &algorithm, const Profile &profile, const std::vector<std::vector<matrix_row_t>> &scans) {
+        Result                                 result;
+        std::vector<std::vector<matrix_row_t>> cooked(scans.size(), std::vector<matrix_row_t>(MATRIX_ROWS, 0));
+        matrix_row_t                           raw[MATRIX_ROWS];
+        matrix_row_t                           state[MATRIX_ROWS] = {};
+        std::vector<matrix_row_t>              last(MATRIX_ROWS, 0);
+        std::chrono::steady_clock::duration    busy{0};
+
+        algorithm.init(MATRIX_ROWS);
+        for (uint32_t t = 0; t < scans.size(); t++) {
+            std::copy(scans[t].begin(), scans[t].end(), raw);
+            bool changed = scans[t] != last;
+            last         = scans[t];
+            auto start   = std::chrono::steady_clock::now();
+            algorithm.debounce(raw, state, MATRIX_ROWS, changed);
+            busy += std::chrono::steady_clock::now() - start;
+            std::copy(state, state + MATRIX_ROWS, cooked[t].begin());
+            advance_time(1);
+        }
+        result.ns_per_scan = std::chrono::duration<double, std::nano>(busy).count() / scans.size();
+
+        // Match the changes of every key in the debounced matrix against the events of its switch
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                matrix_row_t       mask = MATRIX_ROW_SHIFTER << col;
+                std::vector<Event> events;
+                for (auto &event : profile.events) {
+                    if (event.row == row && event.col == col) {
+                        events.push_back(event);
+                    }
+                }
+                size_t next    = 0;
+                bool   level   = false;
+                bool   matched = true;
+                for (uint32_t t = 0; t < scans.size(); t++) {
+                    while (next < events.size() && events[next].time <= t) {
+                        if (!matched) {
+                            result.missed++;
+                        }
+                        result.events++;
+                        matched = false;
+                        next++;
+                    }
+                    bool cooked_level = cooked[t][row] & mask;
+                    if (cooked_level == level) {
+                        continue;
+                    }
+                    level = cooked_level;
+                    if (!matched && next > 0 && events[next - 1].pressed == level) {
+                        result.latency.push_back(t - events[next - 1].time);
+                        matched = true;
+                    } else {
+                        result.ghost++;
+                    }
+                }
+                if (!matched) {
+                    result.missed++;
+                }
+            }
+        }
+        std::sort(result.latency.begin(), result.latency.end());
+        return result;
+    }
+
+    std::vector<Result> benchmark(const char *name, Profile profile) {
+        std::vector<std::vector<matrix_row_t>> scans = render(profile);
+        std::vector<Result>                    results;
+        printf("\n%s (%zu events, %zu noise spikes, %u scans)\n", name, profile.events.size(), profile.spikes.size(), profile.length);
+        printf("  %-14s %7s %7s %7s %22s %9s\n", "algorithm", "events", "missed", "ghost", "latency min/avg/p95/max", "ns/scan");
+        for (auto &algorithm : algorithms) {
+            Result result = run(algorithm, profile, scans);
+            if (result.latency.empty()) {
+                printf("  %-14s %7u %7u %7u %22s %9.1f\n", algorithm.name, result.events, result.missed, result.ghost, "-", result.ns_per_scan);
+            } else {
+                double sum = 0;
+                for (auto latency : result.latency) {
+                    sum += latency;
+                }
+                printf("  %-14s %7u %7u %7u %7u/%4.1f/%4u/%4u %9.1f\n", algorithm.name, result.events, result.missed, result.ghost, result.latency.front(), sum / result.latency.size(), result.latency[result.latency.size() * 95 / 100], result.latency.back(), result.ns_per_scan);
+            }
+            results.push_back(result);
+        }
+        return results;
+    }
+};
+
+// Only the per-key algorithms are expected to keep up with every key; sym_defer_g waits for the whole matrix
+// to settle, and sym_eager_pr locks a whole row after each change.
+
+TEST_F(DebounceBenchmark, CleanSwitches) {
+    std::vector<Result> results = benchmark("Clean switches", typing(12, 0, 0));
+    for (size_t i = 0; i < results.size(); i++) {
+        EXPECT_EQ(results[i].ghost, 0u) << algorithms[i].name;
+        if (algorithms[i].per_key) {
+            EXPECT_EQ(results[i].missed, 0u) << algorithms[i].name;
+            EXPECT_EQ(results[i].latency.back(), algorithms[i].eager ? 0u : DEBOUNCE) << algorithms[i].name;
+        }
+    }
+}
+
+TEST_F(DebounceBenchmark, ChatterBursts) {
+    // Bounce shorter than DEBOUNCE should never get through
+    std::vector<Result> results = benchmark("Chatter bursts", typing(12, 1, DEBOUNCE - 1));
+    for (size_t i = 0; i < results.size(); i++) {
+        EXPECT_EQ(results[i].ghost, 0u) << algorithms[i].name;
+        if (algorithms[i].per_key) {
+            EXPECT_EQ(results[i].missed, 0u) << algorithms[i].name;
+        }
+    }
+}
+
+TEST_F(DebounceBenchmark, LongBounces) {
+    // Bounce longer than DEBOUNCE gets through the eager algorithms, but the final state must still be right
+    std::vector<Result> results = benchmark("Long bounces", typing(12, DEBOUNCE + 1, 3 * DEBOUNCE));
+    for (size_t i = 0; i < results.size(); i++) {
+        if (algorithms[i].per_key) {
+            EXPECT_EQ(results[i].missed, 0u) << algorithms[i].name;
+        }
+        if (!algorithms[i].eager) {
+            EXPECT_EQ(results[i].ghost, 0u) << algorithms[i].name;
+        }
+    }
+}
+
+TEST_F(DebounceBenchmark, SimultaneousPresses) {
+    std::vector<Result> results = benchmark("Simultaneous presses", chords(20, 12));
+    for (size_t i = 0; i < results.size(); i++) {
+        EXPECT_EQ(results[i].missed, 0u) << algorithms[i].name;
+        EXPECT_EQ(results[i].ghost, 0u) << algorithms[i].name;
+    }
+}
+
+TEST_F(DebounceBenchmark, NoiseSpikes) {
+    // Deferred algorithms filter out single scan spikes, eager ones can't
+    std::vector<Result> results = benchmark("Noise spikes", noise(200));
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!algorithms[i].eager) {
+            EXPECT_EQ(results[i].ghost, 0u) << algorithms[i].name;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+debounce_vertical_counter_DEFS := -DNO_DEBUG -DNO_PRINT -DMATRIX_ROWS=4 -DMATRIX_COLS=32 -DDEBOUNCE=5
+
+debounce_vertical_counter_INC := \
+	$(QUANTUM_PATH)/debounce
+
+debounce_vertical_counter_SRC := \
+	$(QUANTUM_PATH)/debounce/tests/vertical_counter_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_vc_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_vc_prefixed.c \
+	$(TMK_PATH)/common/test/timer.c
+
+debounce_benchmark_DEFS := $(debounce_vertical_counter_DEFS)
+
+debounce_benchmark_INC := $(debounce_vertical_counter_INC)
+
+debounce_benchmark_SRC := \
+	$(QUANTUM_PATH)/debounce/tests/debounce_benchmark_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_g_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pr_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_vc_prefixed.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_vc_prefixed.c \
+	$(TMK_PATH)/common/test/timer.c
@@ -0,0 +1,23 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Build sym_eager_pr with its public functions prefixed, so it can be linked next to the other algorithms
+#define debounce sym_eager_pr_debounce
+#define debounce_init sym_eager_pr_debounce_init
+#define debounce_active sym_eager_pr_debounce_active
+#define update_debounce_counters sym_eager_pr_update_debounce_counters
+#define transfer_matrix_values sym_eager_pr_transfer_matrix_values
+#include "sym_eager_pr.c"
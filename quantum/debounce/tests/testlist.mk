@@ -0,0 +1,2 @@
+TEST_LIST += debounce_vertical_counter
+TEST_LIST += debounce_benchmark
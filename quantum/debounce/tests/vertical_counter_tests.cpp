@@ -0,0 +1,154 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "debounce_algorithms.h"
+#include "vertical_counter.h"
+void advance_time(uint32_t ms);
+}
+
+typedef void (*debounce_fn)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+
+// One scan: the raw matrix, and how long after the previous scan it happens
+struct Scan {
+    uint8_t      delay;
+    matrix_row_t raw[MATRIX_ROWS];
+};
+
+class VerticalCounter : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        sym_eager_pk_debounce_init(MATRIX_ROWS);
+        sym_defer_pk_debounce_init(MATRIX_ROWS);
+        sym_eager_vc_debounce_init(MATRIX_ROWS);
+        sym_defer_vc_debounce_init(MATRIX_ROWS);
+    }
+
+    // Runs both algorithms over the trace, and checks that they produce the same matrix after every scan
+    void expect_equivalent(debounce_fn reference, debounce_fn vertical, const std::vector<Scan> &trace) {
+        matrix_row_t last_raw[MATRIX_ROWS]   = {};
+        matrix_row_t ref_cooked[MATRIX_ROWS] = {};
+        matrix_row_t vc_cooked[MATRIX_ROWS]  = {};
+        matrix_row_t raw[MATRIX_ROWS];
+        for (size_t i = 0; i < trace.size(); i++) {
+            advance_time(trace[i].delay);
+            bool changed = memcmp(trace[i].raw, last_raw, sizeof(last_raw)) != 0;
+            memcpy(last_raw, trace[i].raw, sizeof(last_raw));
+            memcpy(raw, trace[i].raw, sizeof(raw));
+            reference(raw, ref_cooked, MATRIX_ROWS, changed);
+            memcpy(raw, trace[i].raw, sizeof(raw));
+            vertical(raw, vc_cooked, MATRIX_ROWS, changed);
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                ASSERT_EQ(ref_cooked[row], vc_cooked[row]) << "scan " << i << ", row " << (int)row;
+            }
+        }
+    }
+
+    // Keys are pressed and released at random, each change bouncing for up to 10ms, with the
+    // occasional single scan noise spike. Scans are 1 to 3ms apart.
+    std::vector<Scan> bouncy_trace(uint32_t seed, size_t length) {
+        std::mt19937                           rng(seed);
+        std::uniform_int_distribution<uint8_t> delay(1, 3);
+        std::uniform_int_distribution<uint8_t> bounce(0, 10);
+        std::uniform_int_distribution<int>     percent(0, 99);
+        std::vector<Scan>                      trace;
+        bool                                   state[MATRIX_ROWS][MATRIX_COLS]    = {};
+        uint8_t                                bouncing[MATRIX_ROWS][MATRIX_COLS] = {};
+
+        for (size_t i = 0; i < length; i++) {
+            Scan scan = {delay(rng), {}};
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    bool level = state[row][col];
+                    if (bouncing[row][col] > 0) {
+                        bouncing[row][col] = bouncing[row][col] > scan.delay ? bouncing[row][col] - scan.delay : 0;
+                        level              = percent(rng) < 50;
+                    } else if (percent(rng) < 2) {
+                        state[row][col]    = !state[row][col];
+                        level              = state[row][col];
+                        bouncing[row][col] = bounce(rng);
+                    } else if (percent(rng) == 0) {
+                        level = !level;
+                    }
+                    if (level) {
+                        scan.raw[row] |= MATRIX_ROW_SHIFTER << col;
+                    }
+                }
+            }
+            trace.push_back(scan);
+        }
+        return trace;
+    }
+};
+
+TEST_F(VerticalCounter, CountsDownAndStopsAtZero) {
+    vc_row_t counter = {};
+    vc_load(&counter, 0x0F, 5);
+    vc_load(&counter, 0x30, 1);
+    EXPECT_EQ(vc_active(&counter), 0x3Fu);
+    vc_count_down(&counter, 1);
+    EXPECT_EQ(vc_active(&counter), 0x0Fu);
+    vc_count_down(&counter, 3);
+    EXPECT_EQ(vc_active(&counter), 0x0Fu);
+    vc_load(&counter, 0x01, 5);
+    vc_count_down(&counter, 1);
+    EXPECT_EQ(vc_active(&counter), 0x01u);
+    vc_count_down(&counter, 5);
+    EXPECT_EQ(vc_active(&counter), 0u);
+}
+
+TEST_F(VerticalCounter, EagerMatchesPerKeyOnSimpleBounce) {
+    // A press that bounces for 3ms, held for a while, then a release that bounces for 4ms
+    std::vector<Scan> trace = {
+        {1, {0x0}}, {1, {0x1}}, {1, {0x0}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x0}},
+        {1, {0x1}}, {1, {0x0}}, {1, {0x1}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}},
+    };
+    expect_equivalent(sym_eager_pk_debounce, sym_eager_vc_debounce, trace);
+}
+
+TEST_F(VerticalCounter, DeferMatchesPerKeyOnSimpleBounce) {
+    std::vector<Scan> trace = {
+        {1, {0x0}}, {1, {0x1}}, {1, {0x0}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x1}}, {1, {0x0}},
+        {1, {0x1}}, {1, {0x0}}, {1, {0x1}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}}, {1, {0x0}},
+    };
+    expect_equivalent(sym_defer_pk_debounce, sym_defer_vc_debounce, trace);
+}
+
+TEST_F(VerticalCounter, EagerMatchesPerKeyOnRandomBounce) {
+    for (uint32_t seed = 1; seed <= 5; seed++) {
+        expect_equivalent(sym_eager_pk_debounce, sym_eager_vc_debounce, bouncy_trace(seed, 2000));
+    }
+}
+
+TEST_F(VerticalCounter, DeferMatchesPerKeyOnRandomBounce) {
+    for (uint32_t seed = 1; seed <= 5; seed++) {
+        expect_equivalent(sym_defer_pk_debounce, sym_defer_vc_debounce, bouncy_trace(seed, 2000));
+    }
+}
+
+TEST_F(VerticalCounter, LongGapsBetweenScans) {
+    std::vector<Scan> trace = {
+        {1, {0x0, 0x3}}, {1, {0x1, 0x3}}, {20, {0x0, 0x1}}, {2, {0x1, 0x1}}, {100, {0x1, 0x0}}, {3, {0x0, 0x0}}, {7, {0x0, 0x0}},
+    };
+    expect_equivalent(sym_eager_pk_debounce, sym_eager_vc_debounce, trace);
+    expect_equivalent(sym_defer_pk_debounce, sym_defer_vc_debounce, trace);
+}
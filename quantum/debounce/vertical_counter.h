@@ -0,0 +1,97 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Vertical counters for the *_vc debounce algorithms.
+Every key has a down counter of VC_BITS bits, but bit n of all the counters in a row
+is stored together in plane n of that row. Loading, counting down and testing the
+counters of a whole row then takes a few bitwise operations per plane, no matter how
+many of its keys are bouncing.
+*/
+
+#pragma once
+
+#include "matrix.h"
+#include "timer.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+#if DEBOUNCE < 2
+#    define VC_BITS 1
+#elif DEBOUNCE < 4
+#    define VC_BITS 2
+#elif DEBOUNCE < 8
+#    define VC_BITS 3
+#elif DEBOUNCE < 16
+#    define VC_BITS 4
+#elif DEBOUNCE < 32
+#    define VC_BITS 5
+#elif DEBOUNCE < 64
+#    define VC_BITS 6
+#elif DEBOUNCE < 128
+#    define VC_BITS 7
+#elif DEBOUNCE < 256
+#    define VC_BITS 8
+#else
+#    error "DEBOUNCE must be less than 256"
+#endif
+
+typedef struct {
+    matrix_row_t plane[VC_BITS];
+} vc_row_t;
+
+// Keys whose counter hasn't reached zero yet
+static inline matrix_row_t vc_active(const vc_row_t *counter) {
+    matrix_row_t active = 0;
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        active |= counter->plane[i];
+    }
+    return active;
+}
+
+// Set the counters of the keys in mask to value
+static inline void vc_load(vc_row_t *counter, matrix_row_t mask, uint8_t value) {
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        counter->plane[i] = (counter->plane[i] & ~mask) | ((value & (1 << i)) ? mask : 0);
+    }
+}
+
+// Subtract amount from every counter in the row, stopping at zero
+static inline void vc_count_down(vc_row_t *counter, uint8_t amount) {
+    matrix_row_t borrow = 0;
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        matrix_row_t bit = counter->plane[i];
+        if (amount & (1 << i)) {
+            counter->plane[i] = ~(bit ^ borrow);
+            borrow            = ~bit | borrow;
+        } else {
+            counter->plane[i] = bit ^ borrow;
+            borrow            = ~bit & borrow;
+        }
+    }
+    // Counters that went below zero
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        counter->plane[i] &= ~borrow;
+    }
+}
+
+// Milliseconds since the last call, capped at DEBOUNCE so that it fits the counters
+static inline uint8_t vc_elapsed(uint16_t *last_time) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, *last_time);
+    *last_time       = now;
+    return elapsed > DEBOUNCE ? DEBOUNCE : elapsed;
+}
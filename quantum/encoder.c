@@ -47,9 +47,24 @@ static uint8_t encoder_resolutions[] = ENCODER_RESOLUTIONS;
 #endif
 static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
 
+#ifndef ENCODER_QUEUE_SIZE
+#    define ENCODER_QUEUE_SIZE 16
+#endif
+_Static_assert(ENCODER_QUEUE_SIZE && (ENCODER_QUEUE_SIZE & (ENCODER_QUEUE_SIZE - 1)) == 0, "ENCODER_QUEUE_SIZE must be a power of 2");
+_Static_assert(ENCODER_QUEUE_SIZE <= 128, "the queue indices are a byte, so they can be read atomically");
+
+// Only touched by encoder_sample()
 static uint8_t encoder_state[NUMBER_OF_ENCODERS]  = {0};
 static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
 
+// Steps decoded by encoder_sample(), waiting for encoder_read(). Each is the index of the encoder shifted left by one,
+// with ENCODER_STEP_UP set if it increments encoder_value. There's a single producer and a single consumer, which only
+// write step_head and step_tail respectively, so no locking is needed.
+#define ENCODER_STEP_UP 0x01
+static volatile uint8_t step_queue[ENCODER_QUEUE_SIZE];
+static volatile uint8_t step_head = 0;
+static volatile uint8_t step_tail = 0;
+
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
 static uint8_t encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
@@ -85,8 +100,10 @@ void encoder_init(void) {
         setPinInputHigh(encoders_pad_a[i]);
         setPinInputHigh(encoders_pad_b[i]);
 
-        encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+        encoder_state[i]  = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+        encoder_pulses[i] = 0;
     }
+    step_head = step_tail = 0;
 
 #ifdef SPLIT_KEYBOARD
     thisHand = isLeftHand ? 0 : NUMBER_OF_ENCODERS;
@@ -94,40 +111,71 @@ void encoder_init(void) {
 #endif
 }
 
-static bool encoder_update(int8_t index, uint8_t state) {
-    bool    changed = false;
-    uint8_t i       = index;
+static bool step_push(uint8_t step) {
+    uint8_t head = step_head;
+    uint8_t next = (head + 1) & (ENCODER_QUEUE_SIZE - 1);
+    if (next == step_tail) {
+        return false;
+    }
+    step_queue[head] = step;
+    step_head        = next;
+    return true;
+}
 
+void encoder_sample(void) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
 #ifdef ENCODER_RESOLUTIONS
-    int8_t resolution = encoder_resolutions[i];
+        int8_t resolution = encoder_resolutions[i];
 #else
-    int8_t resolution = ENCODER_RESOLUTION;
+        int8_t resolution = ENCODER_RESOLUTION;
 #endif
 
-#ifdef SPLIT_KEYBOARD
-    index += thisHand;
-#endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
-    if (encoder_pulses[i] >= resolution) {
-        encoder_value[index]++;
-        changed = true;
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-    }
-    if (encoder_pulses[i] <= -resolution) {  // direction is arbitrary here, but this clockwise
-        encoder_value[index]--;
-        changed = true;
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
+        encoder_state[i] <<= 2;
+        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+
+        // While the queue is full, the pulses are held back to be queued by a later sample, up to what fits in them
+        int8_t pulses = encoder_pulses[i];
+        int8_t change = encoder_LUT[encoder_state[i] & 0xF];
+        if ((change > 0 && pulses < INT8_MAX) || (change < 0 && pulses > INT8_MIN)) {
+            pulses += change;
+        }
+        while (pulses >= resolution && step_push((i << 1) | ENCODER_STEP_UP)) {
+            pulses -= resolution;
+        }
+        while (pulses <= -resolution && step_push(i << 1)) {  // direction is arbitrary here, but this clockwise
+            pulses += resolution;
+        }
+        encoder_pulses[i] = pulses;
     }
-    encoder_pulses[i] %= resolution;
-    return changed;
 }
 
 bool encoder_read(void) {
     bool changed = false;
-    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
-        encoder_state[i] <<= 2;
-        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        changed |= encoder_update(i, encoder_state[i]);
+
+#ifndef ENCODER_INTERRUPT_SAMPLING
+    encoder_sample();
+#endif
+
+    // Only the steps queued so far, so that a fast spinning encoder can't keep the main loop here
+    uint8_t head = step_head;
+    uint8_t tail = step_tail;
+    while (tail != head) {
+        uint8_t step  = step_queue[tail];
+        uint8_t index = step >> 1;
+        tail          = (tail + 1) & (ENCODER_QUEUE_SIZE - 1);
+        step_tail     = tail;
+
+#ifdef SPLIT_KEYBOARD
+        index += thisHand;
+#endif
+        if (step & ENCODER_STEP_UP) {
+            encoder_value[index]++;
+            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
+        } else {
+            encoder_value[index]--;
+            encoder_update_kb(index, ENCODER_CLOCKWISE);
+        }
+        changed = true;
     }
     return changed;
 }
@@ -139,6 +187,8 @@ void encoder_state_raw(uint8_t* slave_state) { memcpy(slave_state, &encoder_valu
 
 void encoder_update_raw(uint8_t* slave_state) {
     bool changed = false;
+    // The slave sends the running count of its steps, so the delta is whatever the master hasn't applied yet, and
+    // nothing is lost when a transfer is
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
         uint8_t index = i + thatHand;
         int8_t  delta = slave_state[i] - encoder_value[index];
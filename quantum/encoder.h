@@ -17,10 +17,16 @@
 
 #pragma once
 
-#include "quantum.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
 
 void encoder_init(void);
+// Drains the steps queued by encoder_sample() to encoder_update_kb(), sampling the encoders first unless
+// ENCODER_INTERRUPT_SAMPLING is defined
 bool encoder_read(void);
+// Reads the encoder pins and queues any steps, can be called from a timer or pin change interrupt
+void encoder_sample(void);
 
 void encoder_update_kb(int8_t index, bool clockwise);
 void encoder_update_user(int8_t index, bool clockwise);
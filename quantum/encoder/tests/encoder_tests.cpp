@@ -0,0 +1,140 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "encoder.h"
+
+bool mock_pins[4];
+}
+
+static int clockwise_steps[2];
+static int counter_clockwise_steps[2];
+
+extern "C" void encoder_update_kb(int8_t index, bool clockwise) { (clockwise ? clockwise_steps : counter_clockwise_steps)[index]++; }
+
+// The quadrature waveform of an encoder, which rests at the detent with both pins pulled high, as A | B << 1. Going
+// forward through it is a clockwise step.
+static const uint8_t waveform[] = {3, 2, 0, 1};
+
+class Encoder : public ::testing::Test {
+   protected:
+    uint8_t phase[2];
+
+    void SetUp() override {
+        encoder_init();
+        for (uint8_t i = 0; i < 2; i++) {
+            phase[i]                   = 0;
+            clockwise_steps[i]         = 0;
+            counter_clockwise_steps[i] = 0;
+        }
+    }
+
+    // Moves the encoder to the next edge of the waveform
+    void edge(uint8_t index, bool clockwise) {
+        phase[index]             = (phase[index] + (clockwise ? 1 : 3)) % 4;
+        mock_pins[index * 2]     = waveform[phase[index]] & 1;
+        mock_pins[index * 2 + 1] = waveform[phase[index]] >> 1;
+    }
+
+    // Turns the encoder by a number of detents, with the interrupt sampling every edge
+    void turn(uint8_t index, bool clockwise, int steps) {
+        for (int i = 0; i < steps * 4; i++) {
+            edge(index, clockwise);
+            encoder_sample();
+        }
+    }
+};
+
+TEST_F(Encoder, StepsEachWay) {
+    turn(0, true, 1);
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(clockwise_steps[0], 1);
+    EXPECT_EQ(counter_clockwise_steps[0], 0);
+
+    turn(0, false, 2);
+    turn(1, true, 1);
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(clockwise_steps[0], 1);
+    EXPECT_EQ(counter_clockwise_steps[0], 2);
+    EXPECT_EQ(clockwise_steps[1], 1);
+
+    EXPECT_FALSE(encoder_read());
+}
+
+TEST_F(Encoder, HalfStepIsNotReported) {
+    edge(0, true);
+    encoder_sample();
+    edge(0, true);
+    encoder_sample();
+    EXPECT_FALSE(encoder_read());
+
+    edge(0, false);
+    encoder_sample();
+    edge(0, false);
+    encoder_sample();
+    EXPECT_FALSE(encoder_read());
+    EXPECT_EQ(clockwise_steps[0] + counter_clockwise_steps[0], 0);
+}
+
+// Both encoders spinning as fast as the sampling can follow, or a third of that, with the main loop only draining the
+// queue every 20 or 60 samples, which is more than the queue holds
+TEST_F(Encoder, FastSpinWithSlowMainLoop) {
+    const int samples = 12000;
+
+    for (int sample = 1; sample <= samples; sample++) {
+        edge(0, true);
+        if (sample % 3 == 0) {
+            edge(1, false);
+        }
+        encoder_sample();
+        if (sample % 80 == 20 || sample % 80 == 0) {
+            encoder_read();
+        }
+    }
+    do {
+        encoder_sample();
+    } while (encoder_read());
+
+    EXPECT_EQ(clockwise_steps[0], samples / 4);
+    EXPECT_EQ(counter_clockwise_steps[0], 0);
+    EXPECT_EQ(counter_clockwise_steps[1], samples / 3 / 4);
+    EXPECT_EQ(clockwise_steps[1], 0);
+}
+
+// Steps that don't fit in the queue are held back until it has room again
+TEST_F(Encoder, BacklogBeyondQueue) {
+    turn(0, true, 24);
+    encoder_read();
+    EXPECT_LT(clockwise_steps[0], 24);
+
+    // The next sample, even without an edge, queues the rest
+    encoder_sample();
+    encoder_read();
+    EXPECT_EQ(clockwise_steps[0], 24);
+}
+
+// Turning back while steps are held back takes them off first, so the encoder ends up where it is
+TEST_F(Encoder, BacklogTurnedBack) {
+    turn(0, true, 30);
+    turn(0, false, 10);
+    do {
+        encoder_sample();
+    } while (encoder_read());
+
+    EXPECT_EQ(clockwise_steps[0] - counter_clockwise_steps[0], 20);
+}
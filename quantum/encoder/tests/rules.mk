@@ -0,0 +1,6 @@
+encoder_CONFIG := $(QUANTUM_PATH)/encoder/tests/config_mock.h
+encoder_INC := $(QUANTUM_PATH)/encoder/tests
+
+encoder_SRC := \
+	$(QUANTUM_PATH)/encoder/tests/encoder_tests.cpp \
+	$(QUANTUM_PATH)/encoder.c
@@ -52,6 +52,8 @@ bool matrix_is_modified(void) __attribute__((deprecated));
 bool matrix_is_on(uint8_t row, uint8_t col);
 /* matrix state on row */
 matrix_row_t matrix_get_row(uint8_t row);
+/* when the last change of a row happened */
+uint16_t matrix_get_row_time(uint8_t row);
 /* print matrix for debug */
 void matrix_print(void);
 /* delay between changing matrix pin state and reading values */
@@ -0,0 +1,63 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mouse_accumulator.h"
+#include "timer.h"
+
+void mouse_accumulator_add(mouse_accumulator_t *accumulator, int32_t x, int32_t y, int32_t v, int32_t h) {
+    accumulator->x += x;
+    accumulator->y += y;
+    accumulator->v += v;
+    accumulator->h += h;
+}
+
+static bool has_whole_unit(int32_t value) { return value >= MOUSE_UNITS(1) || value <= -MOUSE_UNITS(1); }
+
+bool mouse_accumulator_ready(mouse_accumulator_t *accumulator) {
+    if (!has_whole_unit(accumulator->x) && !has_whole_unit(accumulator->y) && !has_whole_unit(accumulator->v) && !has_whole_unit(accumulator->h)) {
+        return false;
+    }
+    return timer_elapsed(accumulator->last_report) >= MOUSE_REPORT_INTERVAL;
+}
+
+// Takes the whole units that fit into a report out of the value, leaving the remainder and the fraction
+static int8_t take_units(int32_t *value) {
+    // division truncates towards zero, so the fraction keeps the sign of the motion
+    int32_t units = *value / MOUSE_UNITS(1);
+    if (units > 127) {
+        units = 127;
+    } else if (units < -127) {
+        units = -127;
+    }
+    *value -= MOUSE_UNITS(units);
+    return units;
+}
+
+bool mouse_accumulator_take(mouse_accumulator_t *accumulator, report_mouse_t *report) {
+    report->x                = take_units(&accumulator->x);
+    report->y                = take_units(&accumulator->y);
+    report->v                = take_units(&accumulator->v);
+    report->h                = take_units(&accumulator->h);
+    accumulator->last_report = timer_read();
+    return report->x || report->y || report->v || report->h;
+}
+
+void mouse_accumulator_clear(mouse_accumulator_t *accumulator) {
+    accumulator->x = 0;
+    accumulator->y = 0;
+    accumulator->v = 0;
+    accumulator->h = 0;
+}
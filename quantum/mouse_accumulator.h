@@ -0,0 +1,66 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "report.h"
+
+/* Mouse motion accumulator
+ *
+ * Collects cursor and wheel motion between reports, so that motion arriving faster than the
+ * host polls for it goes out as one report, instead of queueing up or being dropped. Motion is
+ * kept in fixed point with MOUSE_FRACTION_BITS below the unit, so sub-unit movement (from
+ * diagonal scaling or sensor resolution scaling) adds up instead of being rounded away. Only
+ * whole units are reported, anything beyond the report range is left for the next report.
+ */
+
+#define MOUSE_FRACTION_BITS 8
+// Converts whole report units to accumulator units
+#define MOUSE_UNITS(n) ((int32_t)(n) * (1 << MOUSE_FRACTION_BITS))
+
+// Minimum time between reports, in ms. Defaults to USB_POLLING_INTERVAL_MS when the keyboard sets it, and otherwise to
+// 1ms, the fastest the endpoints can be polled, as their default interval is only known to the protocol.
+#ifndef MOUSE_REPORT_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define MOUSE_REPORT_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define MOUSE_REPORT_INTERVAL 1
+#    endif
+#endif
+
+typedef struct {
+    int32_t  x;
+    int32_t  y;
+    int32_t  v;
+    int32_t  h;
+    uint16_t last_report;
+} mouse_accumulator_t;
+
+// Adds motion, in accumulator units
+void mouse_accumulator_add(mouse_accumulator_t *accumulator, int32_t x, int32_t y, int32_t v, int32_t h);
+
+// Whether there is at least one whole unit of motion to report, and the last report was long enough ago
+bool mouse_accumulator_ready(mouse_accumulator_t *accumulator);
+
+/* Moves the whole units of motion into the report, clamped to its range, and restarts the report
+ * interval. Returns true if the report has any motion.
+ */
+bool mouse_accumulator_take(mouse_accumulator_t *accumulator, report_mouse_t *report);
+
+// Forgets any pending motion
+void mouse_accumulator_clear(mouse_accumulator_t *accumulator);
@@ -22,6 +22,7 @@
 #include "print.h"
 #include "debug.h"
 #include "mousekey.h"
+#include "mouse_accumulator.h"
 
 inline int8_t times_inv_sqrt2(int8_t x) {
     // 181/256 is pretty close to 1/sqrt(2)
@@ -31,11 +32,16 @@ inline int8_t times_inv_sqrt2(int8_t x) {
     return (x * 181) >> 8;
 }
 
-static report_mouse_t mouse_report = {0};
-static void           mousekey_debug(void);
-static uint8_t        mousekey_accel        = 0;
-static uint8_t        mousekey_repeat       = 0;
-static uint8_t        mousekey_wheel_repeat = 0;
+// 1/sqrt(2) for motion in accumulator units, which keeps the fraction for the next move
+static inline int32_t times_inv_sqrt2_units(int32_t x) { return x * 46341 / 65536; }
+
+static report_mouse_t      mouse_report = {0};
+static mouse_accumulator_t mouse_motion = {0};
+static void                mousekey_debug(void);
+static void                mousekey_move(int32_t x, int32_t y, int32_t v, int32_t h);
+static uint8_t             mousekey_accel        = 0;
+static uint8_t             mousekey_repeat       = 0;
+static uint8_t             mousekey_wheel_repeat = 0;
 #ifdef MK_KINETIC_SPEED
 static uint16_t mouse_timer = 0;
 #endif
@@ -210,48 +216,34 @@ static uint8_t wheel_unit(void) {
 void mousekey_task(void) {
     // report cursor and scroll movement independently
     report_mouse_t const tmpmr = mouse_report;
-
-    mouse_report.x = 0;
-    mouse_report.y = 0;
-    mouse_report.v = 0;
-    mouse_report.h = 0;
+    int32_t              x = 0, y = 0, v = 0, h = 0;
 
     if ((tmpmr.x || tmpmr.y) && timer_elapsed(last_timer_c) > (mousekey_repeat ? mk_interval : mk_delay * 10)) {
         if (mousekey_repeat != UINT8_MAX) mousekey_repeat++;
-        if (tmpmr.x != 0) mouse_report.x = move_unit() * ((tmpmr.x > 0) ? 1 : -1);
-        if (tmpmr.y != 0) mouse_report.y = move_unit() * ((tmpmr.y > 0) ? 1 : -1);
+        if (tmpmr.x != 0) x = MOUSE_UNITS(move_unit()) * ((tmpmr.x > 0) ? 1 : -1);
+        if (tmpmr.y != 0) y = MOUSE_UNITS(move_unit()) * ((tmpmr.y > 0) ? 1 : -1);
 
         /* diagonal move [1/sqrt(2)] */
-        if (mouse_report.x && mouse_report.y) {
-            mouse_report.x = times_inv_sqrt2(mouse_report.x);
-            if (mouse_report.x == 0) {
-                mouse_report.x = 1;
-            }
-            mouse_report.y = times_inv_sqrt2(mouse_report.y);
-            if (mouse_report.y == 0) {
-                mouse_report.y = 1;
-            }
+        if (x && y) {
+            x = times_inv_sqrt2_units(x);
+            y = times_inv_sqrt2_units(y);
         }
+        last_timer_c = timer_read();
     }
     if ((tmpmr.v || tmpmr.h) && timer_elapsed(last_timer_w) > (mousekey_wheel_repeat ? mk_wheel_interval : mk_wheel_delay * 10)) {
         if (mousekey_wheel_repeat != UINT8_MAX) mousekey_wheel_repeat++;
-        if (tmpmr.v != 0) mouse_report.v = wheel_unit() * ((tmpmr.v > 0) ? 1 : -1);
-        if (tmpmr.h != 0) mouse_report.h = wheel_unit() * ((tmpmr.h > 0) ? 1 : -1);
+        if (tmpmr.v != 0) v = MOUSE_UNITS(wheel_unit()) * ((tmpmr.v > 0) ? 1 : -1);
+        if (tmpmr.h != 0) h = MOUSE_UNITS(wheel_unit()) * ((tmpmr.h > 0) ? 1 : -1);
 
         /* diagonal move [1/sqrt(2)] */
-        if (mouse_report.v && mouse_report.h) {
-            mouse_report.v = times_inv_sqrt2(mouse_report.v);
-            if (mouse_report.v == 0) {
-                mouse_report.v = 1;
-            }
-            mouse_report.h = times_inv_sqrt2(mouse_report.h);
-            if (mouse_report.h == 0) {
-                mouse_report.h = 1;
-            }
+        if (v && h) {
+            v = times_inv_sqrt2_units(v);
+            h = times_inv_sqrt2_units(h);
         }
+        last_timer_w = timer_read();
     }
 
-    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
+    mousekey_move(x, y, v, h);
     mouse_report = tmpmr;
 }
 
@@ -341,21 +333,20 @@ uint16_t        w_intervals[mkspd_COUNT] = {MK_W_INTERVAL_UNMOD, MK_W_INTERVAL_0
 void mousekey_task(void) {
     // report cursor and scroll movement independently
     report_mouse_t const tmpmr = mouse_report;
-    mouse_report.x             = 0;
-    mouse_report.y             = 0;
-    mouse_report.v             = 0;
-    mouse_report.h             = 0;
+    int32_t              x = 0, y = 0, v = 0, h = 0;
 
     if ((tmpmr.x || tmpmr.y) && timer_elapsed(last_timer_c) > c_intervals[mk_speed]) {
-        mouse_report.x = tmpmr.x;
-        mouse_report.y = tmpmr.y;
+        x            = MOUSE_UNITS(tmpmr.x);
+        y            = MOUSE_UNITS(tmpmr.y);
+        last_timer_c = timer_read();
     }
     if ((tmpmr.h || tmpmr.v) && timer_elapsed(last_timer_w) > w_intervals[mk_speed]) {
-        mouse_report.v = tmpmr.v;
-        mouse_report.h = tmpmr.h;
+        v            = MOUSE_UNITS(tmpmr.v);
+        h            = MOUSE_UNITS(tmpmr.h);
+        last_timer_w = timer_read();
     }
 
-    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
+    mousekey_move(x, y, v, h);
     mouse_report = tmpmr;
 }
 
@@ -458,16 +449,35 @@ void mousekey_send(void) {
     uint16_t time = timer_read();
     if (mouse_report.x || mouse_report.y) last_timer_c = time;
     if (mouse_report.v || mouse_report.h) last_timer_w = time;
+    mouse_motion.last_report = time;
     host_mouse_send(&mouse_report);
 }
 
+/* Adds the motion of a mousekey_task run, in accumulator units, and sends the whole units
+ * once the report interval has passed. Several runs within one interval go out as one report.
+ */
+static void mousekey_move(int32_t x, int32_t y, int32_t v, int32_t h) {
+    mouse_accumulator_add(&mouse_motion, x, y, v, h);
+    if (mouse_accumulator_ready(&mouse_motion)) {
+        mouse_accumulator_take(&mouse_motion, &mouse_report);
+        mousekey_debug();
+        host_mouse_send(&mouse_report);
+    }
+}
+
 void mousekey_clear(void) {
     mouse_report          = (report_mouse_t){};
+    mouse_accumulator_clear(&mouse_motion);
     mousekey_repeat       = 0;
     mousekey_wheel_repeat = 0;
     mousekey_accel        = 0;
 }
 
+/* Whether no mouse key is moving the pointer or holding a button. The host already has an
+ * empty report then, so clearing the mouse keys needs nothing sent.
+ */
+bool mousekey_is_idle(void) { return !mouse_report.buttons && !mouse_report.x && !mouse_report.y && !mouse_report.v && !mouse_report.h; }
+
 static void mousekey_debug(void) {
     if (!debug_mouse) return;
     print("mousekey [btn|x y v h](rep/acl): [");
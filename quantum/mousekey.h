@@ -173,6 +173,7 @@ void mousekey_on(uint8_t code);
 void mousekey_off(uint8_t code);
 void mousekey_clear(void);
 void mousekey_send(void);
+bool mousekey_is_idle(void);
 
 #ifdef __cplusplus
 }
@@ -22,8 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 #include "pointing_device.h"
+#include "mouse_accumulator.h"
 
-static report_mouse_t mouseReport = {};
+static report_mouse_t      mouseReport = {};
+static mouse_accumulator_t motion      = {};
 
 __attribute__((weak)) bool has_mouse_report_changed(report_mouse_t new, report_mouse_t old) { return (new.buttons != old.buttons) || (new.x&& new.x != old.x) || (new.y&& new.y != old.y) || (new.h&& new.h != old.h) || (new.v&& new.v != old.v); }
 
@@ -34,9 +36,14 @@ __attribute__((weak)) void pointing_device_init(void) {
 __attribute__((weak)) void pointing_device_send(void) {
     static report_mouse_t old_report = {};
 
-    // If you need to do other things, like debugging, this is the place to do it.
-    if (has_mouse_report_changed(mouseReport, old_report)) {
-        host_mouse_send(&mouseReport);
+    // Motion is collected and sent at most once per MOUSE_REPORT_INTERVAL, button changes go out straight away
+    mouse_accumulator_add(&motion, MOUSE_UNITS(mouseReport.x), MOUSE_UNITS(mouseReport.y), MOUSE_UNITS(mouseReport.v), MOUSE_UNITS(mouseReport.h));
+    if (mouseReport.buttons != old_report.buttons || mouse_accumulator_ready(&motion)) {
+        mouse_accumulator_take(&motion, &mouseReport);
+        // If you need to do other things, like debugging, this is the place to do it.
+        if (has_mouse_report_changed(mouseReport, old_report)) {
+            host_mouse_send(&mouseReport);
+        }
     }
     // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
     mouseReport.x = 0;
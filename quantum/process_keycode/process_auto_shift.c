@@ -18,6 +18,7 @@
 
 #    include <stdbool.h>
 #    include <stdio.h>
+#    include <string.h>
 
 #    include "process_auto_shift.h"
 
@@ -30,51 +31,153 @@ static struct {
     // Whether the last auto-shifted key was released after the timeout.  This
     // is used to replicate the last key for a tap-then-hold.
     bool lastshifted : 1;
-    // Whether an auto-shiftable key has been pressed but not processed.
-    bool in_progress : 1;
-    // Whether the auto-shifted keypress has been registered.
-    bool holding_shift : 1;
-} autoshift_flags = {true, false, false, false};
+} autoshift_flags = {true, false};
 
-/** \brief Record the press of an autoshiftable key
+// Auto-shiftable keys that have been pressed but not sent yet, in the order
+// they were pressed. Each is decided on its own, when it's released or times
+// out, but they're sent in order, so a key waits for the ones before it.
+typedef struct {
+    uint16_t keycode;
+    uint16_t time;
+    // Whether it's known if the key is shifted.
+    bool decided : 1;
+    bool shifted : 1;
+    // Whether it timed out while still held, so it can keyrepeat.
+    bool held : 1;
+} autoshift_key_t;
+
+static autoshift_key_t autoshift_keys[AUTO_SHIFT_PENDING_KEYS];
+static uint8_t         autoshift_key_count = 0;
+
+/** \brief Sends a decided auto-shiftable key
  *
- *  \return Whether the record should be further processed.
+ * Registers the key, with a shift if it was held past the timeout, and
+ * releases it again unless it's keyrepeating.
  */
-static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record) {
+static void autoshift_send(const autoshift_key_t *key, uint16_t now) {
+    autoshift_lastkey = key->keycode;
+    if (!key->shifted) {
+        // A key before this one may be keyrepeating shifted.
+        del_weak_mods(MOD_BIT(KC_LSFT));
+        register_code(key->keycode);
+        autoshift_flags.lastshifted = false;
+    } else {
+        // Simulate pressing the shift key.
+        add_weak_mods(MOD_BIT(KC_LSFT));
+        register_code(key->keycode);
+        autoshift_flags.lastshifted = true;
+#    if defined(AUTO_SHIFT_REPEAT) && !defined(AUTO_SHIFT_NO_AUTO_REPEAT)
+        if (key->held) {
+            // Prevents release.
+            return;
+        }
+#    endif
+    }
+
+#    if TAP_CODE_DELAY > 0
+    wait_ms(TAP_CODE_DELAY);
+#    endif
+    unregister_code(key->keycode);
+    del_weak_mods(MOD_BIT(KC_LSFT));
+    send_keyboard_report();  // del_weak_mods doesn't send one.
+    // Roll the autoshift_time forward for detecting tap-and-hold.
+    autoshift_time = now;
+}
+
+/** \brief Sends the pending keys that are decided, up to the first that isn't
+ */
+static void autoshift_send_decided(uint16_t now) {
+    uint8_t sent = 0;
+    while (sent < autoshift_key_count && autoshift_keys[sent].decided) {
+        autoshift_send(&autoshift_keys[sent], now);
+        sent++;
+    }
+    if (sent) {
+        autoshift_key_count -= sent;
+        memmove(autoshift_keys, &autoshift_keys[sent], autoshift_key_count * sizeof(autoshift_key_t));
+    }
+}
+
+static void autoshift_decide(autoshift_key_t *key, uint16_t now) {
+    key->decided = true;
+    key->shifted = TIMER_DIFF_16(now, key->time) >= autoshift_timeout;
+}
+
+/** \brief Decides and sends every pending key
+ *
+ * Called when a key that isn't auto-shifted is pressed, which has to be sent
+ * after them.
+ */
+static void autoshift_flush(uint16_t now) {
+    for (uint8_t i = 0; i < autoshift_key_count; i++) {
+        if (!autoshift_keys[i].decided) {
+            autoshift_decide(&autoshift_keys[i], now);
+        }
+    }
+    autoshift_send_decided(now);
+}
+
+/** \brief Whether auto shift applies to a press at all
+ */
+static bool autoshift_applies(void) {
     if (!autoshift_flags.enabled) {
-        return true;
+        return false;
     }
 
 #    ifndef AUTO_SHIFT_MODIFIERS
     if (get_mods()) {
-        return true;
+        return false;
     }
 #    endif
+    return true;
+}
+
+/** \brief Whether a press is the hold of a tap-then-hold, which keyrepeats the last key
+ */
+static bool autoshift_is_repeat(uint16_t keycode, uint16_t now) {
 #    ifdef AUTO_SHIFT_REPEAT
-    const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
-#        ifndef AUTO_SHIFT_NO_AUTO_REPEAT
-    if (!autoshift_flags.lastshifted) {
-#        endif
-        if (elapsed < TAPPING_TERM && keycode == autoshift_lastkey) {
-            // Allow a tap-then-hold for keyrepeat.
-            if (!autoshift_flags.lastshifted) {
-                register_code(autoshift_lastkey);
-            } else {
-                // Simulate pressing the shift key.
-                add_weak_mods(MOD_BIT(KC_LSFT));
-                register_code(autoshift_lastkey);
-            }
-            return false;
-        }
 #        ifndef AUTO_SHIFT_NO_AUTO_REPEAT
+    if (autoshift_flags.lastshifted) {
+        return false;
     }
 #        endif
+    return !autoshift_key_count && keycode == autoshift_lastkey && TIMER_DIFF_16(now, autoshift_time) < TAPPING_TERM;
+#    else
+    return false;
 #    endif
+}
+
+/** \brief Whether the press of an autoshiftable key will be added to the pending keys
+ */
+static bool autoshift_will_queue(uint16_t keycode, uint16_t now) { return autoshift_applies() && !autoshift_is_repeat(keycode, now); }
+
+/** \brief Record the press of an autoshiftable key
+ *
+ *  \return Whether the record should be further processed.
+ */
+static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record) {
+    if (!autoshift_applies()) {
+        return true;
+    }
+
+    if (autoshift_is_repeat(keycode, now)) {
+        // Allow a tap-then-hold for keyrepeat.
+        if (autoshift_flags.lastshifted) {
+            // Simulate pressing the shift key.
+            add_weak_mods(MOD_BIT(KC_LSFT));
+        }
+        register_code(autoshift_lastkey);
+        return false;
+    }
+
+    if (autoshift_key_count == AUTO_SHIFT_PENDING_KEYS) {
+        // Make room by deciding the oldest key now.
+        autoshift_decide(&autoshift_keys[0], now);
+        autoshift_send_decided(now);
+    }
 
     // Record the keycode so we can simulate it later.
-    autoshift_lastkey           = keycode;
-    autoshift_time              = now;
-    autoshift_flags.in_progress = true;
+    autoshift_keys[autoshift_key_count++] = (autoshift_key_t){.keycode = keycode, .time = now};
 
 #    if !defined(NO_ACTION_ONESHOT) && !defined(NO_ACTION_TAPPING)
     clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
@@ -82,51 +185,27 @@ static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record)
     return false;
 }
 
-/** \brief Registers an autoshiftable key under the right conditions
+/** \brief Handles the release of an autoshiftable key
  *
- * If the autoshift delay has elapsed, register a shift and the key.
- *
- * If the autoshift key is released before the delay has elapsed, register the
- * key without a shift.
+ * If the key is pending, it's shifted if the delay has elapsed. Otherwise it's
+ * keyrepeating, or wasn't auto-shifted at all, and is released.
  */
-static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
-    // Called on key down with KC_NO, auto-shifted key up, and timeout.
-    if (autoshift_flags.in_progress) {
-        // Process the auto-shiftable key.
-        autoshift_flags.in_progress = false;
-
-        // Time since the initial press was recorded.
-        const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
-        if (elapsed < autoshift_timeout) {
-            register_code(autoshift_lastkey);
-            autoshift_flags.lastshifted = false;
-        } else {
-            // Simulate pressing the shift key.
-            add_weak_mods(MOD_BIT(KC_LSFT));
-            register_code(autoshift_lastkey);
-            autoshift_flags.lastshifted = true;
-#    if defined(AUTO_SHIFT_REPEAT) && !defined(AUTO_SHIFT_NO_AUTO_REPEAT)
-            if (matrix_trigger) {
-                // Prevents release.
-                return;
-            }
-#    endif
+static void autoshift_release(uint16_t keycode, uint16_t now) {
+    for (uint8_t i = 0; i < autoshift_key_count; i++) {
+        if (autoshift_keys[i].keycode == keycode && !autoshift_keys[i].decided) {
+            autoshift_decide(&autoshift_keys[i], now);
+            autoshift_send_decided(now);
+            return;
         }
+    }
 
-#    if TAP_CODE_DELAY > 0
-        wait_ms(TAP_CODE_DELAY);
-#    endif
-        unregister_code(autoshift_lastkey);
+    // Release after keyrepeat.
+    unregister_code(keycode);
+    if (keycode == autoshift_lastkey) {
+        // This will only fire when the key was the last auto-shiftable
+        // pressed. That prevents aaaaBBBB then releasing a from unshifting
+        // later Bs (if B wasn't auto-shiftable).
         del_weak_mods(MOD_BIT(KC_LSFT));
-    } else {
-        // Release after keyrepeat.
-        unregister_code(keycode);
-        if (keycode == autoshift_lastkey) {
-            // This will only fire when the key was the last auto-shiftable
-            // pressed. That prevents aaaaBBBB then releasing a from unshifting
-            // later Bs (if B wasn't auto-shiftable).
-            del_weak_mods(MOD_BIT(KC_LSFT));
-        }
     }
     send_keyboard_report();  // del_weak_mods doesn't send one.
     // Roll the autoshift_time forward for detecting tap-and-hold.
@@ -140,13 +219,20 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
  *  to be released.
  */
 void autoshift_matrix_scan(void) {
-    if (autoshift_flags.in_progress) {
-        const uint16_t now     = timer_read();
-        const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
-        if (elapsed >= autoshift_timeout) {
-            autoshift_end(autoshift_lastkey, now, true);
+    if (!autoshift_key_count) {
+        return;
+    }
+
+    const uint16_t now = timer_read();
+    for (uint8_t i = 0; i < autoshift_key_count; i++) {
+        autoshift_key_t *key = &autoshift_keys[i];
+        if (!key->decided && TIMER_DIFF_16(now, key->time) >= autoshift_timeout) {
+            key->decided = true;
+            key->shifted = true;
+            key->held    = true;
         }
     }
+    autoshift_send_decided(now);
 }
 
 void autoshift_toggle(void) {
@@ -177,16 +263,35 @@ uint16_t get_autoshift_timeout(void) { return autoshift_timeout; }
 
 void set_autoshift_timeout(uint16_t timeout) { autoshift_timeout = timeout; }
 
+static bool autoshift_is_shiftable(uint16_t keycode) {
+    switch (keycode) {
+#    ifndef NO_AUTO_SHIFT_ALPHA
+        case KC_A ... KC_Z:
+#    endif
+#    ifndef NO_AUTO_SHIFT_NUMERIC
+        case KC_1 ... KC_0:
+#    endif
+#    ifndef NO_AUTO_SHIFT_SPECIAL
+        case KC_TAB:
+        case KC_MINUS ... KC_SLASH:
+        case KC_NONUS_BSLASH:
+#    endif
+            return true;
+    }
+    return false;
+}
+
 bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
     // Note that record->event.time isn't reliable, see:
     // https://github.com/qmk/qmk_firmware/pull/9826#issuecomment-733559550
     const uint16_t now = timer_read();
 
     if (record->event.pressed) {
-        if (autoshift_flags.in_progress) {
-            // Evaluate previous key if there is one. Doing this elsewhere is
-            // more complicated and easier to break.
-            autoshift_end(KC_NO, now, false);
+        if (autoshift_key_count && !(autoshift_is_shiftable(keycode) && autoshift_will_queue(keycode, now))) {
+            // Send the pending keys before one that isn't going to wait for
+            // its own timeout. Doing this elsewhere is more complicated and
+            // easier to break.
+            autoshift_flush(now);
         }
         // For pressing another key while keyrepeating shifted autoshift.
         del_weak_mods(MOD_BIT(KC_LSFT));
@@ -217,24 +322,13 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
         }
     }
 
-    switch (keycode) {
-#    ifndef NO_AUTO_SHIFT_ALPHA
-        case KC_A ... KC_Z:
-#    endif
-#    ifndef NO_AUTO_SHIFT_NUMERIC
-        case KC_1 ... KC_0:
-#    endif
-#    ifndef NO_AUTO_SHIFT_SPECIAL
-        case KC_TAB:
-        case KC_MINUS ... KC_SLASH:
-        case KC_NONUS_BSLASH:
-#    endif
-            if (record->event.pressed) {
-                return autoshift_press(keycode, now, record);
-            } else {
-                autoshift_end(keycode, now, false);
-                return false;
-            }
+    if (autoshift_is_shiftable(keycode)) {
+        if (record->event.pressed) {
+            return autoshift_press(keycode, now, record);
+        } else {
+            autoshift_release(keycode, now);
+            return false;
+        }
     }
     return true;
 }
@@ -22,6 +22,11 @@
 #    define AUTO_SHIFT_TIMEOUT 175
 #endif
 
+// How many auto-shiftable keys can be pressed before the first one is decided
+#ifndef AUTO_SHIFT_PENDING_KEYS
+#    define AUTO_SHIFT_PENDING_KEYS 4
+#endif
+
 bool process_auto_shift(uint16_t keycode, keyrecord_t *record);
 
 void     autoshift_enable(void);
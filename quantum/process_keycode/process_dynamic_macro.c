@@ -17,6 +17,9 @@
 
 /* Author: Wojciech Siewierski < wojciech dot siewierski at onet dot pl > */
 #include "process_dynamic_macro.h"
+#ifdef DYNAMIC_MACRO_EEPROM_ENABLE
+#    include "eeprom.h"
+#endif
 
 // default feedback method
 void dynamic_macro_led_blink(void) {
@@ -37,103 +40,403 @@ __attribute__((weak)) void dynamic_macro_record_key_user(int8_t direction, keyre
 
 __attribute__((weak)) void dynamic_macro_record_end_user(int8_t direction) { dynamic_macro_led_blink(); }
 
-/* Convenience macros used for retrieving the debug info. All of them
- * need a `direction` variable accessible at the call site.
+#define DYNAMIC_MACRO_DIRECTION(id) ((id) == 1 ? +1 : -1)
+
+/* Both macros use the same buffer but read/write on different
+ * ends of it.
+ *
+ * Macro1 is written left-to-right starting from the beginning of
+ * the buffer.
+ *
+ * Macro2 is written right-to-left starting from the end of the
+ * buffer.
+ *
+ *  macro_buffer     macro_length[0]
+ *  v                   v
+ * +------------------------------------------------------------+
+ * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
+ * +------------------------------------------------------------+
+ *                          ^                                   ^
+ *                     macro_length[1]       macro_buffer + DYNAMIC_MACRO_BUFFER_SIZE - 1
+ *
+ * During the recording when one macro encounters the end of the
+ * other macro, the recording is stopped. Apart from this, there
+ * are no arbitrary limits for the macros' length in relation to
+ * each other: for example one can either have two medium sized
+ * macros or one long macro and one short macro. Or even one empty
+ * and one using the whole buffer.
+ *
+ * The buffer holds encoded events (see dynamic_macro_encode_event())
+ * rather than whole keyrecord_t structs, so both macros are byte
+ * streams and the lengths are in bytes.
+ */
+static uint8_t  macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE];
+static uint16_t macro_length[2] = {0, 0};
+
+/* 0   - no macro is being recorded right now
+ * 1,2 - either macro 1 or 2 is being recorded */
+static uint8_t  macro_id      = 0;
+static uint16_t record_length = 0;
+
+/* 0   - no macro is being played back right now
+ * 1,2 - either macro 1 or 2 is being played back */
+static uint8_t       playing_id        = 0;
+static uint16_t      playing_offset    = 0;
+static layer_state_t saved_layer_state = 0;
+static bool          in_playback_event = false;
+
+/* Layers as the playback last left them, and the layers that other keys
+ * changed in between, which are kept when the playback ends. */
+static layer_state_t playing_layer_state = 0;
+static layer_state_t user_layer_changes  = 0;
+
+/* Keys pressed by the playback and not released yet */
+static matrix_row_t playing_keys[MATRIX_ROWS];
+
+static inline uint8_t *macro_byte(uint8_t id, uint16_t offset) { return id == 1 ? &macro_buffer[offset] : &macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - 1 - offset]; }
+
+/**
+ * Encode a key record into its compact form.
+ *
+ * An event is a flags byte (pressed, tap interrupted and tap count)
+ * followed by the key's index in the matrix, or by the raw row and
+ * column for positions outside of it.
+ *
+ * @param[out] data   At least DYNAMIC_MACRO_EVENT_MAX_SIZE bytes.
+ * @param[in]  record The key record to encode.
+ * @return The encoded size in bytes.
+ */
+uint8_t dynamic_macro_encode_event(uint8_t *data, const keyrecord_t *record) {
+    uint8_t flags = record->event.pressed ? DYNAMIC_MACRO_EVENT_PRESSED : 0;
+#ifndef NO_ACTION_TAPPING
+    if (record->tap.interrupted) flags |= DYNAMIC_MACRO_EVENT_INTERRUPTED;
+    flags |= record->tap.count & DYNAMIC_MACRO_EVENT_TAP_COUNT;
+#endif
+
+    keypos_t key = record->event.key;
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS && (uint16_t)key.row * MATRIX_COLS + key.col <= UINT8_MAX) {
+        data[0] = flags;
+        data[1] = key.row * MATRIX_COLS + key.col;
+        return 2;
+    }
+
+    data[0] = flags | DYNAMIC_MACRO_EVENT_RAW_POSITION;
+    data[1] = key.row;
+    data[2] = key.col;
+    return 3;
+}
+
+/**
+ * Size of an encoded event, from its first (flags) byte.
+ */
+uint8_t dynamic_macro_event_size(uint8_t flags) { return flags & DYNAMIC_MACRO_EVENT_RAW_POSITION ? 3 : 2; }
+
+/**
+ * Decode a compact event back into a key record.
+ *
+ * The event time is left at zero, it is filled in on playback.
+ *
+ * @return The encoded size in bytes.
+ */
+uint8_t dynamic_macro_decode_event(const uint8_t *data, keyrecord_t *record) {
+    uint8_t flags = data[0];
+
+    *record               = (keyrecord_t){0};
+    record->event.pressed = flags & DYNAMIC_MACRO_EVENT_PRESSED;
+#ifndef NO_ACTION_TAPPING
+    record->tap.interrupted = flags & DYNAMIC_MACRO_EVENT_INTERRUPTED;
+    record->tap.count       = flags & DYNAMIC_MACRO_EVENT_TAP_COUNT;
+#endif
+
+    if (flags & DYNAMIC_MACRO_EVENT_RAW_POSITION) {
+        record->event.key = (keypos_t){.row = data[1], .col = data[2]};
+        return 3;
+    }
+    record->event.key = (keypos_t){.row = data[1] / MATRIX_COLS, .col = data[1] % MATRIX_COLS};
+    return 2;
+}
+
+static uint8_t read_event(uint8_t id, uint16_t offset, keyrecord_t *record) {
+    uint8_t data[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    data[0] = *macro_byte(id, offset);
+    for (uint8_t i = 1; i < dynamic_macro_event_size(data[0]); i++) {
+        data[i] = *macro_byte(id, offset + i);
+    }
+    return dynamic_macro_decode_event(data, record);
+}
+
+#ifdef DYNAMIC_MACRO_EEPROM_ENABLE
+#    define DYNAMIC_MACRO_EEPROM_MAGIC (uint16_t)0xD3AC
+#    define DYNAMIC_MACRO_EEPROM_MAGIC_ADDR (uint16_t *)(DYNAMIC_MACRO_EEPROM_ADDR)
+#    define DYNAMIC_MACRO_EEPROM_LENGTH_ADDR (uint16_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 2)
+#    define DYNAMIC_MACRO_EEPROM_BUFFER_ADDR (uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 6)
+
+_Static_assert(DYNAMIC_MACRO_EEPROM_ADDR + 6 + DYNAMIC_MACRO_BUFFER_SIZE - 1 <= DYNAMIC_MACRO_EEPROM_MAX_ADDR, "The dynamic macros don't fit in the EEPROM, reduce DYNAMIC_MACRO_SIZE or move DYNAMIC_MACRO_EEPROM_ADDR");
+
+/**
+ * Save both macros to EEPROM.
+ *
+ * The EEPROM region mirrors the RAM buffer layout. The magic number is
+ * invalidated while the data is rewritten, so an interrupted save loses
+ * the macros instead of loading garbage.
+ */
+static void dynamic_macro_save(void) {
+    eeprom_update_word(DYNAMIC_MACRO_EEPROM_MAGIC_ADDR, 0xFFFF);
+    eeprom_update_block(macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER_ADDR, macro_length[0]);
+    eeprom_update_block(macro_buffer + DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1], DYNAMIC_MACRO_EEPROM_BUFFER_ADDR + DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1], macro_length[1]);
+    eeprom_update_block(macro_length, DYNAMIC_MACRO_EEPROM_LENGTH_ADDR, sizeof(macro_length));
+    eeprom_update_word(DYNAMIC_MACRO_EEPROM_MAGIC_ADDR, DYNAMIC_MACRO_EEPROM_MAGIC);
+}
+
+static void dynamic_macro_load(void) {
+    macro_length[0] = macro_length[1] = 0;
+    if (eeprom_read_word(DYNAMIC_MACRO_EEPROM_MAGIC_ADDR) != DYNAMIC_MACRO_EEPROM_MAGIC) {
+        return;
+    }
+
+    uint16_t length[2];
+    eeprom_read_block(length, DYNAMIC_MACRO_EEPROM_LENGTH_ADDR, sizeof(length));
+    if ((uint32_t)length[0] + length[1] > DYNAMIC_MACRO_BUFFER_SIZE) {
+        dprintln("dynamic macro: ignoring invalid macros in EEPROM");
+        return;
+    }
+
+    eeprom_read_block(macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER_ADDR, length[0]);
+    eeprom_read_block(macro_buffer + DYNAMIC_MACRO_BUFFER_SIZE - length[1], DYNAMIC_MACRO_EEPROM_BUFFER_ADDR + DYNAMIC_MACRO_BUFFER_SIZE - length[1], length[1]);
+    macro_length[0] = length[0];
+    macro_length[1] = length[1];
+    dprintf("dynamic macro: loaded, lengths: %d, %d\n", macro_length[0], macro_length[1]);
+}
+
+/**
+ * Forget the macros stored in EEPROM, called from eeconfig_init().
+ */
+void dynamic_macro_eeprom_reset(void) { eeprom_update_word(DYNAMIC_MACRO_EEPROM_MAGIC_ADDR, 0xFFFF); }
+#endif
+
+/**
+ * Initialize the dynamic macros, loading them from EEPROM if enabled.
  */
-#define DYNAMIC_MACRO_CURRENT_SLOT() (direction > 0 ? 1 : 2)
-#define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
-#define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
+void dynamic_macro_init(void) {
+#ifdef DYNAMIC_MACRO_EEPROM_ENABLE
+    dynamic_macro_load();
+#endif
+}
 
 /**
  * Start recording of the dynamic macro.
  *
- * @param[out] macro_pointer The new macro buffer iterator.
- * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
+ * @param[in] id The macro to record, either 1 or 2.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer) {
+void dynamic_macro_record_start(uint8_t id) {
     dprintln("dynamic macro recording: started");
 
     dynamic_macro_record_start_user();
 
     clear_keyboard();
     layer_clear();
-    *macro_pointer = macro_buffer;
+    macro_id             = id;
+    record_length        = 0;
+    macro_length[id - 1] = 0;
+}
+
+/**
+ * Process a single event of a macro being played back.
+ *
+ * @return The offset of the next event.
+ */
+static uint16_t dynamic_macro_play_event(uint8_t id, uint16_t offset) {
+    keyrecord_t record;
+    offset += read_event(id, offset, &record);
+    record.event.time = timer_read() | 1;
+
+    keypos_t key = record.event.key;
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        if (record.event.pressed) {
+            playing_keys[key.row] |= (matrix_row_t)1 << key.col;
+        } else {
+            playing_keys[key.row] &= ~((matrix_row_t)1 << key.col);
+        }
+    }
+
+    bool was_in_playback_event = in_playback_event;
+    in_playback_event          = true;
+    process_record(&record);
+    in_playback_event = was_in_playback_event;
+
+    return offset;
+}
+
+/**
+ * Release the keys the playback left pressed.
+ */
+static void dynamic_macro_release_keys(void) {
+    in_playback_event = true;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (playing_keys[row] & ((matrix_row_t)1 << col)) {
+                keyrecord_t record = {.event = {.key = (keypos_t){.row = row, .col = col}, .pressed = false, .time = timer_read() | 1}};
+                process_record(&record);
+            }
+        }
+        playing_keys[row] = 0;
+    }
+    in_playback_event = false;
+}
+
+/**
+ * End a playback that ran to completion before returning, nothing else
+ * changed the keyboard in the meantime.
+ */
+static void dynamic_macro_play_end(uint8_t id, layer_state_t layers) {
+    layer_state = layers;
+
+    dynamic_macro_play_user(DYNAMIC_MACRO_DIRECTION(id));
+}
+
+/**
+ * End a playback run by dynamic_macro_task(). Only the keys and layers
+ * the playback changed are put back, the ones changed by keys pressed
+ * during the playback are kept.
+ */
+static void dynamic_macro_play_task_end(uint8_t id) {
+    user_layer_changes |= layer_state ^ playing_layer_state;
+    dynamic_macro_release_keys();
+
+    layer_state = (layer_state & user_layer_changes) | (saved_layer_state & ~user_layer_changes);
+
+    dynamic_macro_play_user(DYNAMIC_MACRO_DIRECTION(id));
 }
 
 /**
  * Play the dynamic macro.
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * Playback is started here and continued by dynamic_macro_task(), one
+ * event per scan, so the keyboard keeps scanning while a long macro
+ * plays. A macro played from within another macro is played back
+ * completely before returning, as the outer macro can't continue until
+ * it is done.
+ *
+ * @param[in] id The macro to play, either 1 or 2.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
-    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+void dynamic_macro_play(uint8_t id) {
+    if (playing_id && !in_playback_event) {
+        dprintln("dynamic macro: ignoring play key during playback");
+        return;
+    }
 
-    layer_state_t saved_layer_state = layer_state;
+    dprintf("dynamic macro: slot %d playback\n", id);
+
+    layer_state_t layers = layer_state;
 
     clear_keyboard();
     layer_clear();
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
+    if (playing_id) {
+        uint16_t length = macro_length[id - 1];
+        for (uint16_t offset = 0; offset < length;) {
+            offset = dynamic_macro_play_event(id, offset);
+        }
+        dynamic_macro_play_end(id, layers);
+        return;
     }
 
-    clear_keyboard();
+    if (!macro_length[id - 1]) {
+        dynamic_macro_play_end(id, layers);
+        return;
+    }
 
-    layer_state = saved_layer_state;
+    playing_id          = id;
+    playing_offset      = 0;
+    saved_layer_state   = layers;
+    playing_layer_state = layer_state;
+    user_layer_changes  = 0;
+}
+
+/**
+ * Continue the playback of a dynamic macro, called every scan.
+ */
+void dynamic_macro_task(void) {
+    if (!playing_id) return;
 
-    dynamic_macro_play_user(direction);
+    if (playing_offset < macro_length[playing_id - 1]) {
+        user_layer_changes |= layer_state ^ playing_layer_state;
+        playing_offset      = dynamic_macro_play_event(playing_id, playing_offset);
+        playing_layer_state = layer_state;
+    }
+    if (playing_offset >= macro_length[playing_id - 1]) {
+        uint8_t id = playing_id;
+        playing_id = 0;
+        dynamic_macro_play_task_end(id);
+    }
 }
 
+bool dynamic_macro_is_playing(void) { return playing_id != 0; }
+
 /**
  * Record a single key in a dynamic macro.
  *
- * @param macro_buffer[in] The start of the used macro buffer.
- * @param macro_pointer[in,out] The current buffer position.
- * @param macro2_end[in] The end of the other macro.
- * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
- * @param record[in]     The current keypress.
+ * @param id[in]     The macro being recorded, either 1 or 2.
+ * @param record[in] The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+void dynamic_macro_record_key(uint8_t id, keyrecord_t *record) {
     /* If we've just started recording, ignore all the key releases. */
-    if (!record->event.pressed && *macro_pointer == macro_buffer) {
+    if (!record->event.pressed && record_length == 0) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
-    /* The other end of the other macro is the last buffer element it
-     * is safe to use before overwriting the other macro.
+    uint8_t  event[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    uint8_t  size     = dynamic_macro_encode_event(event, record);
+    uint16_t capacity = DYNAMIC_MACRO_BUFFER_SIZE - macro_length[id == 1 ? 1 : 0];
+
+    /* The other macro's end is the last byte it is safe to use
+     * before overwriting it.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (record_length + size <= capacity) {
+        for (uint8_t i = 0; i < size; i++) {
+            *macro_byte(id, record_length + i) = event[i];
+        }
+        record_length += size;
     } else {
-        dynamic_macro_record_key_user(direction, record);
+        dynamic_macro_record_key_user(DYNAMIC_MACRO_DIRECTION(id), record);
     }
 
-    dprintf("dynamic macro: slot %d length: %d/%d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, *macro_pointer), DYNAMIC_MACRO_CURRENT_CAPACITY(macro_buffer, macro2_end));
+    dprintf("dynamic macro: slot %d length: %d/%d\n", id, record_length, capacity);
 }
 
 /**
  * End recording of the dynamic macro. Essentially just update the
- * pointer to the end of the macro.
+ * length of the macro.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
-    dynamic_macro_record_end_user(direction);
+void dynamic_macro_record_end(uint8_t id) {
+    dynamic_macro_record_end_user(DYNAMIC_MACRO_DIRECTION(id));
 
     /* Do not save the keys being held when stopping the recording,
      * i.e. the keys used to access the layer DYN_REC_STOP is on.
+     * Events can only be decoded front to back, so keep everything
+     * up to the last key-up event.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    uint16_t length = 0;
+    for (uint16_t offset = 0; offset < record_length;) {
+        keyrecord_t record;
+        offset += read_event(id, offset, &record);
+        if (!record.event.pressed) {
+            length = offset;
+        }
+    }
+    if (length != record_length) {
+        dprintln("dynamic macro: trimming trailing key-down events");
     }
 
-    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+    dprintf("dynamic macro: slot %d saved, length: %d\n", id, length);
 
-    *macro_end = macro_pointer;
+    macro_length[id - 1] = length;
+    macro_id             = 0;
+
+#ifdef DYNAMIC_MACRO_EEPROM_ENABLE
+    dynamic_macro_save();
+#endif
 }
 
 /* Handle the key events related to the dynamic macros. Should be
@@ -147,69 +450,21 @@ void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_poin
  *   }
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
-    /* Both macros use the same buffer but read/write on different
-     * ends of it.
-     *
-     * Macro1 is written left-to-right starting from the beginning of
-     * the buffer.
-     *
-     * Macro2 is written right-to-left starting from the end of the
-     * buffer.
-     *
-     * &macro_buffer   macro_end
-     *  v                   v
-     * +------------------------------------------------------------+
-     * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
-     * +------------------------------------------------------------+
-     *                           ^                                 ^
-     *                         r_macro_end                  r_macro_buffer
-     *
-     * During the recording when one macro encounters the end of the
-     * other macro, the recording is stopped. Apart from this, there
-     * are no arbitrary limits for the macros' length in relation to
-     * each other: for example one can either have two medium sized
-     * macros or one long macro and one short macro. Or even one empty
-     * and one using the whole buffer.
-     */
-    static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
-
-    /* Pointer to the first buffer element after the first macro.
-     * Initially points to the very beginning of the buffer since the
-     * macro is empty. */
-    static keyrecord_t *macro_end = macro_buffer;
-
-    /* The other end of the macro buffer. Serves as the beginning of
-     * the second macro. */
-    static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-    /* Like macro_end but for the second macro. */
-    static keyrecord_t *r_macro_end = r_macro_buffer;
-
-    /* A persistent pointer to the current macro position (iterator)
-     * used during the recording. */
-    static keyrecord_t *macro_pointer = NULL;
-
-    /* 0   - no macro is being recorded right now
-     * 1,2 - either macro 1 or 2 is being recorded */
-    static uint8_t macro_id = 0;
-
     if (macro_id == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
             switch (keycode) {
                 case DYN_REC_START1:
-                    dynamic_macro_record_start(&macro_pointer, macro_buffer);
-                    macro_id = 1;
+                    dynamic_macro_record_start(1);
                     return false;
                 case DYN_REC_START2:
-                    dynamic_macro_record_start(&macro_pointer, r_macro_buffer);
-                    macro_id = 2;
+                    dynamic_macro_record_start(2);
                     return false;
                 case DYN_MACRO_PLAY1:
-                    dynamic_macro_play(macro_buffer, macro_end, +1);
+                    dynamic_macro_play(1);
                     return false;
                 case DYN_MACRO_PLAY2:
-                    dynamic_macro_play(r_macro_buffer, r_macro_end, -1);
+                    dynamic_macro_play(2);
                     return false;
             }
         }
@@ -223,15 +478,7 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
                 if (record->event.pressed ^ (keycode != DYN_REC_STOP)) { /* Ignore the initial release
                                                                           * just after the recording
                                                                           * starts for DYN_REC_STOP. */
-                    switch (macro_id) {
-                        case 1:
-                            dynamic_macro_record_end(macro_buffer, macro_pointer, +1, &macro_end);
-                            break;
-                        case 2:
-                            dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
-                            break;
-                    }
-                    macro_id = 0;
+                    dynamic_macro_record_end(macro_id);
                 }
                 return false;
 #ifdef DYNAMIC_MACRO_NO_NESTING
@@ -242,14 +489,7 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
 #endif
             default:
                 /* Store the key in the macro buffer and process it normally. */
-                switch (macro_id) {
-                    case 1:
-                        dynamic_macro_record_key(macro_buffer, &macro_pointer, r_macro_end, +1, record);
-                        break;
-                    case 2:
-                        dynamic_macro_record_key(r_macro_buffer, &macro_pointer, macro_end, -1, record);
-                        break;
-                }
+                dynamic_macro_record_key(macro_id, record);
                 return true;
                 break;
         }
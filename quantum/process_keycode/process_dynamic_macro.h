@@ -28,14 +28,63 @@
  * Usually it should be fine to set the macro size to at least 256 but
  * there have been reports of it being too much in some users' cases,
  * so 128 is considered a safe default.
+ *
+ * The buffer takes as much RAM as DYNAMIC_MACRO_SIZE key records, but
+ * events are stored in a compact 2 byte form, so it actually holds
+ * three to four times as many events.
  */
 #ifndef DYNAMIC_MACRO_SIZE
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+#ifndef DYNAMIC_MACRO_BUFFER_SIZE
+#    define DYNAMIC_MACRO_BUFFER_SIZE (DYNAMIC_MACRO_SIZE * sizeof(keyrecord_t))
+#endif
+
+/* Encoded event flags byte */
+#define DYNAMIC_MACRO_EVENT_PRESSED 0x80
+#define DYNAMIC_MACRO_EVENT_INTERRUPTED 0x40
+#define DYNAMIC_MACRO_EVENT_RAW_POSITION 0x20
+#define DYNAMIC_MACRO_EVENT_TAP_COUNT 0x0F
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE 3
+
+/* The macros are saved to EEPROM when DYNAMIC_MACRO_EEPROM_ENABLE is
+ * defined, taking DYNAMIC_MACRO_BUFFER_SIZE + 6 bytes. The default
+ * location is right after the EECONFIG block, which VIA also uses, so
+ * it has to be set explicitly if VIA is enabled.
+ *
+ * The region has to end at or before DYNAMIC_MACRO_EEPROM_MAX_ADDR,
+ * which is the last EEPROM address of AVR microcontrollers, and has to
+ * be set for others with less than 1KB of EEPROM.
+ */
+#ifdef DYNAMIC_MACRO_EEPROM_ENABLE
+#    ifndef DYNAMIC_MACRO_EEPROM_ADDR
+#        ifdef VIA_ENABLE
+#            error DYNAMIC_MACRO_EEPROM_ADDR must be defined when VIA_ENABLE is used
+#        else
+#            define DYNAMIC_MACRO_EEPROM_ADDR EECONFIG_SIZE
+#        endif
+#    endif
+#    ifndef DYNAMIC_MACRO_EEPROM_MAX_ADDR
+#        ifdef E2END
+#            define DYNAMIC_MACRO_EEPROM_MAX_ADDR E2END
+#        else
+#            define DYNAMIC_MACRO_EEPROM_MAX_ADDR 1023
+#        endif
+#    endif
+#endif
+
 void dynamic_macro_led_blink(void);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
+void dynamic_macro_init(void);
+void dynamic_macro_task(void);
+bool dynamic_macro_is_playing(void);
+void dynamic_macro_eeprom_reset(void);
 void dynamic_macro_record_start_user(void);
 void dynamic_macro_play_user(int8_t direction);
 void dynamic_macro_record_key_user(int8_t direction, keyrecord_t *record);
 void dynamic_macro_record_end_user(int8_t direction);
+
+uint8_t dynamic_macro_encode_event(uint8_t *data, const keyrecord_t *record);
+uint8_t dynamic_macro_decode_event(const uint8_t *data, keyrecord_t *record);
+uint8_t dynamic_macro_event_size(uint8_t flags);
@@ -15,7 +15,7 @@
  */
 #include "process_steno.h"
 #include "quantum_keycodes.h"
-#include "eeprom.h"
+#include "eeconfig.h"
 #include "keymap_steno.h"
 #include "virtser.h"
 #include <string.h>
@@ -70,27 +70,28 @@ static void steno_clear_state(void) {
     memset(chord, 0, sizeof(chord));
 }
 
-static void send_steno_state(uint8_t size, bool send_empty) {
+// Copies the chord into the packet, returning the number of bytes
+static uint8_t pack_steno_state(uint8_t *packet, uint8_t size, bool send_empty) {
+    uint8_t length = 0;
     for (uint8_t i = 0; i < size; ++i) {
         if (chord[i] || send_empty) {
-#ifdef VIRTSER_ENABLE
-            virtser_send(chord[i]);
-#endif
+            packet[length++] = chord[i];
         }
     }
+    return length;
 }
 
 void steno_init() {
     if (!eeconfig_is_enabled()) {
         eeconfig_init();
     }
-    mode = eeprom_read_byte(EECONFIG_STENOMODE);
+    mode = eeconfig_read_byte(EECONFIG_STENOMODE);
 }
 
 void steno_set_mode(steno_mode_t new_mode) {
     steno_clear_state();
     mode = new_mode;
-    eeprom_update_byte(EECONFIG_STENOMODE, mode);
+    eeconfig_update_byte(EECONFIG_STENOMODE, mode);
 }
 
 /* override to intercept chords right before they get sent.
@@ -104,18 +105,22 @@ __attribute__((weak)) bool process_steno_user(uint16_t keycode, keyrecord_t *rec
 
 static void send_steno_chord(void) {
     if (send_steno_chord_user(mode, chord)) {
+        uint8_t packet[MAX_STATE_SIZE + 1];
+        uint8_t length = 0;
         switch (mode) {
             case STENO_MODE_BOLT:
-                send_steno_state(BOLT_STATE_SIZE, false);
-#ifdef VIRTSER_ENABLE
-                virtser_send(0);  // terminating byte
-#endif
+                length           = pack_steno_state(packet, BOLT_STATE_SIZE, false);
+                packet[length++] = 0;  // terminating byte
                 break;
             case STENO_MODE_GEMINI:
                 chord[0] |= 0x80;  // Indicate start of packet
-                send_steno_state(GEMINI_STATE_SIZE, true);
+                length = pack_steno_state(packet, GEMINI_STATE_SIZE, true);
                 break;
         }
+#ifdef VIRTSER_ENABLE
+        // The whole chord in one transfer, rather than a packet per byte
+        virtser_send_buf(packet, length);
+#endif
     }
     steno_clear_state();
 }
@@ -15,7 +15,7 @@
  */
 
 #include "process_unicode_common.h"
-#include "eeprom.h"
+#include "eeconfig.h"
 #include <ctype.h>
 #include <string.h>
 
@@ -30,7 +30,7 @@ static int8_t  selected_index;
 #endif
 
 void unicode_input_mode_init(void) {
-    unicode_config.raw = eeprom_read_byte(EECONFIG_UNICODEMODE);
+    unicode_config.raw = eeconfig_read_byte(EECONFIG_UNICODEMODE);
 #if UNICODE_SELECTED_MODES != -1
 #    if UNICODE_CYCLE_PERSIST
     // Find input_mode in selected modes
@@ -75,7 +75,7 @@ void cycle_unicode_input_mode(int8_t offset) {
 #endif
 }
 
-void persist_unicode_input_mode(void) { eeprom_update_byte(EECONFIG_UNICODEMODE, unicode_config.input_mode); }
+void persist_unicode_input_mode(void) { eeconfig_update_byte(EECONFIG_UNICODEMODE, unicode_config.input_mode); }
 
 __attribute__((weak)) void unicode_input_start(void) {
     unicode_saved_caps_lock = host_keyboard_led_state().caps_lock;
@@ -180,13 +180,13 @@ void register_hex32(uint32_t hex) {
     }
 }
 
-void register_unicode(uint32_t code_point) {
-    if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UC_WIN)) {
-        // Code point out of range, do nothing
-        return;
-    }
+static bool unicode_can_type(uint32_t code_point) {
+    // Code points out of range can't be typed
+    return code_point <= 0x10FFFF && !(code_point > 0xFFFF && unicode_config.input_mode == UC_WIN);
+}
 
-    unicode_input_start();
+// The hex digits of a code point, between unicode_input_start() and unicode_input_finish()
+static void register_unicode_hex(uint32_t code_point) {
     if (code_point > 0xFFFF && unicode_config.input_mode == UC_MAC) {
         // Convert code point to UTF-16 surrogate pair on macOS
         code_point -= 0x10000;
@@ -196,6 +196,15 @@ void register_unicode(uint32_t code_point) {
     } else {
         register_hex32(code_point);
     }
+}
+
+void register_unicode(uint32_t code_point) {
+    if (!unicode_can_type(code_point)) {
+        return;
+    }
+
+    unicode_input_start();
+    register_unicode_hex(code_point);
     unicode_input_finish();
 }
 
@@ -264,14 +273,27 @@ void send_unicode_string(const char *str) {
         return;
     }
 
+    // macOS keeps taking hex digits for as long as Option is held, like for a surrogate pair, so the whole string is
+    // typed in one input session. The other input modes need their keys around each character.
+    bool one_session = unicode_config.input_mode == UC_MAC;
+    if (one_session) {
+        unicode_input_start();
+    }
     while (*str) {
         int32_t code_point = 0;
         str                = decode_utf8(str, &code_point);
 
         if (code_point >= 0) {
-            register_unicode(code_point);
+            if (!one_session) {
+                register_unicode(code_point);
+            } else if (unicode_can_type(code_point)) {
+                register_unicode_hex(code_point);
+            }
         }
     }
+    if (one_session) {
+        unicode_input_finish();
+    }
 }
 
 // clang-format off
@@ -139,6 +139,7 @@ void reset_keyboard(void) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+    eeconfig_flush();
     bootloader_jump();
 }
 
@@ -373,6 +374,9 @@ void matrix_init_quantum() {
 #if defined(BLUETOOTH_ENABLE) && defined(OUTPUT_AUTO_ENABLE)
     set_output(OUTPUT_AUTO);
 #endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
 
     matrix_init_kb();
 }
@@ -434,6 +438,12 @@ void matrix_scan_quantum() {
     autoshift_matrix_scan();
 #endif
 
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_task();
+#endif
+
+    send_string_task();
+
     matrix_scan_kb();
 }
 
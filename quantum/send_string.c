@@ -134,96 +134,60 @@ __attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
 // Note: we bit-pack in "reverse" order to optimize loading
 #define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
 
-void send_string(const char *str) { send_string_with_delay(str, 0); }
+/* Every element of an encoded string (a character, or an SS_TAP/SS_DOWN/SS_UP/SS_DELAY sequence)
+ * is decoded into a short list of primitive operations. Register and unregister operations each
+ * produce exactly one keyboard report, which is what lets the asynchronous engine emit one report
+ * per task call. The longest sequence is a shifted, AltGr'd dead key character.
+ */
+enum send_string_op {
+    SS_OP_REGISTER,
+    SS_OP_UNREGISTER,
+    SS_OP_TAP_DELAY,
+    SS_OP_BELL,
+};
 
-void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
+#define SS_OP(op, keycode) (((uint16_t)(op) << 8) | (uint8_t)(keycode))
+#define SS_OP_TYPE(op) ((op) >> 8)
+#define SS_OP_KEYCODE(op) ((uint8_t)((op)&0xFF))
+#define SS_MAX_OPS 10
 
-void send_string_with_delay(const char *str, uint8_t interval) {
-    while (1) {
-        char ascii_code = *str;
-        if (!ascii_code) break;
-        if (ascii_code == SS_QMK_PREFIX) {
-            ascii_code = *(++str);
-            if (ascii_code == SS_TAP_CODE) {
-                // tap
-                uint8_t keycode = *(++str);
-                tap_code(keycode);
-            } else if (ascii_code == SS_DOWN_CODE) {
-                // down
-                uint8_t keycode = *(++str);
-                register_code(keycode);
-            } else if (ascii_code == SS_UP_CODE) {
-                // up
-                uint8_t keycode = *(++str);
-                unregister_code(keycode);
-            } else if (ascii_code == SS_DELAY_CODE) {
-                // delay
-                int     ms      = 0;
-                uint8_t keycode = *(++str);
-                while (isdigit(keycode)) {
-                    ms *= 10;
-                    ms += keycode - '0';
-                    keycode = *(++str);
-                }
-                while (ms--) wait_ms(1);
-            }
-        } else {
-            send_char(ascii_code);
-        }
-        ++str;
-        // interval
-        {
-            uint8_t ms = interval;
-            while (ms--) wait_ms(1);
-        }
-    }
-}
+typedef struct {
+    uint16_t op[SS_MAX_OPS];
+    uint8_t  count;
+    uint8_t  pos;
+} send_string_ops_t;
 
-void send_string_with_delay_P(const char *str, uint8_t interval) {
-    while (1) {
-        char ascii_code = pgm_read_byte(str);
-        if (!ascii_code) break;
-        if (ascii_code == SS_QMK_PREFIX) {
-            ascii_code = pgm_read_byte(++str);
-            if (ascii_code == SS_TAP_CODE) {
-                // tap
-                uint8_t keycode = pgm_read_byte(++str);
-                tap_code(keycode);
-            } else if (ascii_code == SS_DOWN_CODE) {
-                // down
-                uint8_t keycode = pgm_read_byte(++str);
-                register_code(keycode);
-            } else if (ascii_code == SS_UP_CODE) {
-                // up
-                uint8_t keycode = pgm_read_byte(++str);
-                unregister_code(keycode);
-            } else if (ascii_code == SS_DELAY_CODE) {
-                // delay
-                int     ms      = 0;
-                uint8_t keycode = pgm_read_byte(++str);
-                while (isdigit(keycode)) {
-                    ms *= 10;
-                    ms += keycode - '0';
-                    keycode = pgm_read_byte(++str);
-                }
-                while (ms--) wait_ms(1);
-            }
-        } else {
-            send_char(ascii_code);
-        }
-        ++str;
-        // interval
-        {
-            uint8_t ms = interval;
-            while (ms--) wait_ms(1);
-        }
-    }
+typedef struct {
+    const char *str;
+    uint8_t     interval;
+    bool        progmem;
+} send_string_job_t;
+
+static send_string_job_t ss_queue[SEND_STRING_QUEUE_SIZE];
+static uint8_t           ss_queue_head  = 0;
+static uint8_t           ss_queue_count = 0;
+static send_string_ops_t ss_ops;
+static uint32_t          ss_delay       = 0;
+static bool              ss_waiting     = false;
+static uint32_t          ss_wait_until  = 0;
+
+static inline uint16_t tap_delay_for(uint8_t keycode) { return keycode == KC_CAPS ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY; }
+
+static inline void ops_push(send_string_ops_t *ops, uint8_t op, uint8_t keycode) { ops->op[ops->count++] = SS_OP(op, keycode); }
+
+static void ops_push_tap(send_string_ops_t *ops, uint8_t keycode) {
+    ops_push(ops, SS_OP_REGISTER, keycode);
+    ops_push(ops, SS_OP_TAP_DELAY, keycode);
+    ops_push(ops, SS_OP_UNREGISTER, keycode);
 }
 
-void send_char(char ascii_code) {
+static void decode_char(send_string_ops_t *ops, char ascii_code) {
+    ops->count = 0;
+    ops->pos   = 0;
+
 #if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
     if (ascii_code == '\a') {  // BEL
-        PLAY_SONG(bell_song);
+        ops_push(ops, SS_OP_BELL, 0);
         return;
     }
 #endif
@@ -234,23 +198,205 @@ void send_char(char ascii_code) {
     bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
 
     if (is_shifted) {
-        register_code(KC_LSFT);
+        ops_push(ops, SS_OP_REGISTER, KC_LSFT);
     }
     if (is_altgred) {
-        register_code(KC_RALT);
+        ops_push(ops, SS_OP_REGISTER, KC_RALT);
     }
-    tap_code(keycode);
+    ops_push_tap(ops, keycode);
     if (is_altgred) {
-        unregister_code(KC_RALT);
+        ops_push(ops, SS_OP_UNREGISTER, KC_RALT);
     }
     if (is_shifted) {
-        unregister_code(KC_LSFT);
+        ops_push(ops, SS_OP_UNREGISTER, KC_LSFT);
     }
     if (is_dead) {
-        tap_code(KC_SPACE);
+        ops_push_tap(ops, KC_SPACE);
+    }
+}
+
+static inline char job_read(send_string_job_t *job) { return job->progmem ? pgm_read_byte(job->str) : *job->str; }
+
+/** \brief Decodes the next element of a string job
+ *
+ * Fills `ops` with the operations for the element and `delay` with the time to wait after them,
+ * and advances the job past the element. Returns false once the end of the string is reached.
+ */
+static bool decode_next(send_string_job_t *job, send_string_ops_t *ops, uint32_t *delay) {
+    char ascii_code = job_read(job);
+    if (!ascii_code) return false;
+
+    ops->count = 0;
+    ops->pos   = 0;
+    *delay     = job->interval;
+
+    if (ascii_code == SS_QMK_PREFIX) {
+        ++job->str;
+        ascii_code = job_read(job);
+        if (ascii_code == SS_TAP_CODE) {
+            // tap
+            ++job->str;
+            ops_push_tap(ops, job_read(job));
+        } else if (ascii_code == SS_DOWN_CODE) {
+            // down
+            ++job->str;
+            ops_push(ops, SS_OP_REGISTER, job_read(job));
+        } else if (ascii_code == SS_UP_CODE) {
+            // up
+            ++job->str;
+            ops_push(ops, SS_OP_UNREGISTER, job_read(job));
+        } else if (ascii_code == SS_DELAY_CODE) {
+            // delay
+            uint32_t ms = 0;
+            ++job->str;
+            uint8_t keycode = job_read(job);
+            while (isdigit(keycode)) {
+                ms *= 10;
+                ms += keycode - '0';
+                ++job->str;
+                keycode = job_read(job);
+            }
+            *delay += ms;
+        }
+    } else {
+        decode_char(ops, ascii_code);
+    }
+    ++job->str;
+    return true;
+}
+
+/** \brief Executes the next operation of a sequence
+ *
+ * Returns the number of milliseconds to wait before the following operation.
+ */
+static uint16_t ops_step(send_string_ops_t *ops) {
+    uint16_t op = ops->op[ops->pos++];
+    switch (SS_OP_TYPE(op)) {
+        case SS_OP_REGISTER:
+            register_code(SS_OP_KEYCODE(op));
+            break;
+        case SS_OP_UNREGISTER:
+            unregister_code(SS_OP_KEYCODE(op));
+            break;
+        case SS_OP_TAP_DELAY:
+            return tap_delay_for(SS_OP_KEYCODE(op));
+#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+        case SS_OP_BELL:
+            PLAY_SONG(bell_song);
+            break;
+#endif
+    }
+    return 0;
+}
+
+static void ops_run(send_string_ops_t *ops) {
+    while (ops->pos < ops->count) {
+        for (uint16_t ms = ops_step(ops); ms > 0; ms--) {
+            wait_ms(1);
+        }
+    }
+}
+
+static void send_string_wait(uint32_t ms) {
+    ss_waiting    = true;
+    ss_wait_until = timer_read32() + ms;
+}
+
+/** \brief Runs the asynchronous send_string engine
+ *
+ * Emits at most one keyboard report per call, and returns immediately while a delay is pending.
+ * Called from matrix_scan_quantum(), so matrix scanning and everything else in keyboard_task()
+ * keeps running during playback of long strings.
+ */
+void send_string_task(void) {
+    if (!ss_queue_count) return;
+
+    if (ss_waiting) {
+        if (!timer_expired32(timer_read32(), ss_wait_until)) return;
+        ss_waiting = false;
+    }
+
+    while (ss_queue_count) {
+        if (ss_ops.pos < ss_ops.count) {
+            bool     reports = SS_OP_TYPE(ss_ops.op[ss_ops.pos]) != SS_OP_TAP_DELAY;
+            uint16_t ms      = ops_step(&ss_ops);
+            if (ms) {
+                send_string_wait(ms);
+                return;
+            }
+            if (reports) return;
+            continue;
+        }
+        if (ss_delay) {
+            send_string_wait(ss_delay);
+            ss_delay = 0;
+            return;
+        }
+        if (!decode_next(&ss_queue[ss_queue_head], &ss_ops, &ss_delay)) {
+            ss_queue_head = (ss_queue_head + 1) % SEND_STRING_QUEUE_SIZE;
+            ss_queue_count--;
+        }
+    }
+}
+
+bool send_string_is_busy(void) { return ss_queue_count > 0; }
+
+/** \brief Blocks until every queued asynchronous string has been sent
+ */
+void send_string_flush(void) {
+    while (ss_queue_count) {
+        while (ss_waiting && !timer_expired32(timer_read32(), ss_wait_until)) {
+            wait_ms(1);
+        }
+        send_string_task();
     }
 }
 
+static bool send_string_enqueue(const char *str, uint8_t interval, bool progmem) {
+    if (ss_queue_count >= SEND_STRING_QUEUE_SIZE) return false;
+
+    send_string_job_t *job = &ss_queue[(ss_queue_head + ss_queue_count) % SEND_STRING_QUEUE_SIZE];
+    job->str               = str;
+    job->interval          = interval;
+    job->progmem           = progmem;
+    if (!ss_queue_count++) {
+        ss_ops.count = ss_ops.pos = 0;
+        ss_delay                  = 0;
+    }
+    return true;
+}
+
+bool send_string_async(const char *str) { return send_string_with_delay_async(str, 0); }
+
+bool send_string_async_P(const char *str) { return send_string_with_delay_async_P(str, 0); }
+
+bool send_string_with_delay_async(const char *str, uint8_t interval) { return send_string_enqueue(str, interval, false); }
+
+bool send_string_with_delay_async_P(const char *str, uint8_t interval) { return send_string_enqueue(str, interval, true); }
+
+void send_string(const char *str) { send_string_with_delay(str, 0); }
+
+void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
+
+void send_string_with_delay(const char *str, uint8_t interval) {
+    // Anything already queued goes out first, so output stays in call order
+    send_string_flush();
+    send_string_enqueue(str, interval, false);
+    send_string_flush();
+}
+
+void send_string_with_delay_P(const char *str, uint8_t interval) {
+    send_string_flush();
+    send_string_enqueue(str, interval, true);
+    send_string_flush();
+}
+
+void send_char(char ascii_code) {
+    send_string_ops_t ops;
+    decode_char(&ops, ascii_code);
+    ops_run(&ops);
+}
+
 void send_dword(uint32_t number) {
     send_word(number >> 16);
     send_word(number & 0xFFFFUL);
@@ -15,12 +15,19 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "progmem.h"
 #include "send_string_keycodes.h"
 
+#ifndef SEND_STRING_QUEUE_SIZE
+#    define SEND_STRING_QUEUE_SIZE 4
+#endif
+
 #define SEND_STRING(string) send_string_P(PSTR(string))
 #define SEND_STRING_DELAY(string, interval) send_string_with_delay_P(PSTR(string), interval)
+#define SEND_STRING_ASYNC(string) send_string_async_P(PSTR(string))
+#define SEND_STRING_DELAY_ASYNC(string, interval) send_string_with_delay_async_P(PSTR(string), interval)
 
 // Look-Up Tables (LUTs) to convert ASCII character to keycode sequence.
 extern const uint8_t ascii_to_shift_lut[16];
@@ -46,6 +53,16 @@ void send_string_P(const char *str);
 void send_string_with_delay_P(const char *str, uint8_t interval);
 void send_char(char ascii_code);
 
+// Queue a string to be sent from the scan loop, one report per task call. Return false if the queue is full.
+// Strings in RAM must stay valid until they have been sent, see send_string_is_busy().
+bool send_string_async(const char *str);
+bool send_string_with_delay_async(const char *str, uint8_t interval);
+bool send_string_async_P(const char *str);
+bool send_string_with_delay_async_P(const char *str, uint8_t interval);
+bool send_string_is_busy(void);
+void send_string_flush(void);
+void send_string_task(void);
+
 void send_dword(uint32_t number);
 void send_word(uint16_t number);
 void send_byte(uint8_t number);
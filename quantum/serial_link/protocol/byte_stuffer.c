@@ -97,39 +97,59 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
-    send_data(link, &num_non_zero, 1);
-    if (end > start) {
-        send_data(link, start, end - start);
+// Copy the data bytes of a block straight into the frame, and only go byte by byte for the bytes that end blocks
+void byte_stuffer_recv_buffer(uint8_t link, const uint8_t* data, uint16_t size) {
+    byte_stuffer_state_t* state = &states[link];
+    const uint8_t*        end   = data + size;
+    while (data < end) {
+        if (state->next_zero > 1) {
+            uint16_t run = state->next_zero - 1;
+            if (run > end - data) {
+                run = end - data;
+            }
+            if (run > MAX_FRAME_SIZE - state->data_pos) {
+                run = MAX_FRAME_SIZE - state->data_pos;
+            }
+            uint8_t* out = state->data + state->data_pos;
+            uint16_t i;
+            for (i = 0; i < run && data[i] != 0; i++) {
+                out[i] = data[i];
+            }
+            state->data_pos += i;
+            state->next_zero -= i;
+            data += i;
+        }
+        if (data < end) {
+            byte_stuffer_recv_byte(link, *data++);
+        }
     }
 }
 
+// The length of each block is found before it's sent, so that its code can go in front of its data, which is sent
+// straight from the buffer of the caller
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
     const uint8_t zero = 0;
     if (size > 0) {
-        uint16_t num_non_zero = 1;
-        uint8_t* end          = data + size;
-        uint8_t* start        = data;
-        while (data < end) {
-            if (num_non_zero == 0xFF) {
-                // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start        = data;
-                num_non_zero = 1;
-            } else {
-                if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start        = data + 1;
-                    num_non_zero = 1;
-                } else {
-                    num_non_zero++;
-                }
+        const uint8_t* end = data + size;
+        while (true) {
+            uint8_t num_non_zero = 0;
+            while (num_non_zero < 0xFE && data + num_non_zero < end && data[num_non_zero] != 0) {
+                num_non_zero++;
+            }
+            uint8_t code = num_non_zero + 1;
+            send_data(link, &code, 1);
+            if (num_non_zero > 0) {
+                send_data(link, data, num_non_zero);
+            }
+            data += num_non_zero;
+            if (data == end) {
+                break;
+            }
+            if (num_non_zero < 0xFE) {
+                // The block ended with a zero, which the code of the next block replaces
                 ++data;
             }
         }
-        send_block(link, start, data, num_non_zero);
         send_data(link, &zero, 1);
     }
 }
@@ -27,5 +27,5 @@ SOFTWARE.
 #include <stdint.h>
 
 void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size);
-// The buffer pointed to by the data needs 4 additional bytes
+// The buffer pointed to by the data needs 4 additional bytes, and is overwritten
 void validator_send_frame(uint8_t link, uint8_t* data, uint16_t size);
@@ -62,12 +62,7 @@ static uint32_t read_from_serial(SerialDriver* driver, uint8_t link) {
     const uint32_t buffer_size = 16;
     uint8_t        buffer[buffer_size];
     uint32_t       bytes_read = sdAsynchronousRead(driver, buffer, buffer_size);
-    uint8_t*       current    = buffer;
-    uint8_t*       end        = current + bytes_read;
-    while (current < end) {
-        byte_stuffer_recv_byte(link, *current);
-        current++;
-    }
+    byte_stuffer_recv_buffer(link, buffer, bytes_read);
     return bytes_read;
 }
 
@@ -183,22 +178,19 @@ void serial_link_update(void) {
         serial_link_connected = true;
     }
 
-    matrix_object_t matrix;
-    bool            changed = false;
+    // The write buffer is only published by end_write, so the matrix can go straight into it
+    matrix_object_t* matrix  = begin_write_keyboard_matrix();
+    bool             changed = false;
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        matrix.rows[i] = matrix_get_row(i);
-        changed |= matrix.rows[i] != last_matrix.rows[i];
+        matrix->rows[i] = matrix_get_row(i);
+        changed |= matrix->rows[i] != last_matrix.rows[i];
     }
 
     systime_t current_time = chVTGetSystemTimeX();
     systime_t delta        = current_time - last_update;
     if (changed || delta > TIME_US2I(5000)) {
-        last_update        = current_time;
-        last_matrix        = matrix;
-        matrix_object_t* m = begin_write_keyboard_matrix();
-        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-            m->rows[i] = matrix.rows[i];
-        }
+        last_update = current_time;
+        last_matrix = *matrix;
         end_write_keyboard_matrix();
         *begin_write_serial_link_connected() = true;
         end_write_serial_link_connected();
@@ -26,6 +26,7 @@ SOFTWARE.
 #include "gmock/gmock.h"
 #include <vector>
 #include <algorithm>
+#include <random>
 extern "C" {
 #include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/protocol/frame_validator.h"
@@ -35,6 +36,7 @@ extern "C" {
 using testing::_;
 using testing::Args;
 using testing::ElementsAreArray;
+using testing::Invoke;
 
 class ByteStuffer : public ::testing::Test {
    public:
@@ -47,8 +49,31 @@ class ByteStuffer : public ::testing::Test {
 
     MOCK_METHOD3(validator_recv_frame, void(uint8_t link, uint8_t* data, uint16_t size));
 
-    void                 send_data(uint8_t link, const uint8_t* data, uint16_t size) { std::copy(data, data + size, std::back_inserter(sent_data)); }
-    std::vector<uint8_t> sent_data;
+    void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
+        std::copy(data, data + size, std::back_inserter(sent_data));
+        send_pointers.push_back(data);
+        num_send_calls++;
+    }
+    std::vector<uint8_t>        sent_data;
+    std::vector<const uint8_t*> send_pointers;
+    int                         num_send_calls = 0;
+
+    // Random frames, with runs of zeroes and runs longer than a block, and some bytes of line noise between them
+    std::vector<std::vector<uint8_t>> random_frames(uint32_t seed, int count) {
+        std::mt19937                       rng(seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> length(1, 600);
+        std::vector<std::vector<uint8_t>>  frames;
+        for (int i = 0; i < count; i++) {
+            std::vector<uint8_t> frame(length(rng));
+            int                  zeroes = percent(rng);
+            for (auto& d : frame) {
+                d = percent(rng) < zeroes / 4 ? 0 : 1 + rng() % 255;
+            }
+            frames.push_back(frame);
+        }
+        return frames;
+    }
 
     static ByteStuffer* Instance;
 };
@@ -448,3 +473,55 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes_and_then_zero) {
         byte_stuffer_recv_byte(1, d);
     }
 }
+
+TEST_F(ByteStuffer, sends_data_straight_from_the_callers_buffer) {
+    uint8_t original_data[] = {1, 0, 0, 0, 2, 0, 3, 0, 0, 0, 0, 4};
+    uint8_t data[]          = {1, 0, 0, 0, 2, 0, 3, 0, 0, 0, 0, 4};
+    uint8_t expected[]      = {2, 1, 1, 1, 2, 2, 2, 3, 1, 1, 1, 2, 4, 0};
+    byte_stuffer_send_frame(0, data, sizeof(data));
+    EXPECT_THAT(sent_data, ElementsAreArray(expected));
+    EXPECT_THAT(data, ElementsAreArray(original_data));
+    // A code, then the data of the block, which isn't copied
+    ASSERT_EQ(num_send_calls, 14);
+    EXPECT_EQ(send_pointers[1], &data[0]);
+    EXPECT_EQ(send_pointers[5], &data[4]);
+    EXPECT_EQ(send_pointers[7], &data[6]);
+    EXPECT_EQ(send_pointers[12], &data[11]);
+}
+
+TEST_F(ByteStuffer, receives_buffer_the_same_as_byte_by_byte) {
+    std::vector<std::vector<uint8_t>> frames[2];
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _)).WillRepeatedly(Invoke([&frames](uint8_t link, uint8_t* data, uint16_t size) { frames[link].emplace_back(data, data + size); }));
+
+    std::mt19937                       rng(7);
+    std::uniform_int_distribution<int> chunk(1, 300);
+    for (auto& frame : random_frames(1, 200)) {
+        byte_stuffer_send_frame(0, frame.data(), frame.size());
+        for (int i = 0; i < 5; i++) {
+            sent_data.push_back(rng() % 4 == 0 ? 0 : rng());
+        }
+    }
+    for (auto& d : sent_data) {
+        byte_stuffer_recv_byte(1, d);
+    }
+    size_t pos = 0;
+    while (pos < sent_data.size()) {
+        uint16_t size = std::min<size_t>(chunk(rng), sent_data.size() - pos);
+        byte_stuffer_recv_buffer(0, sent_data.data() + pos, size);
+        pos += size;
+    }
+    EXPECT_GT(frames[1].size(), 100);
+    EXPECT_EQ(frames[0], frames[1]);
+}
+
+TEST_F(ByteStuffer, sends_and_receives_random_frames_roundtrip) {
+    std::vector<std::vector<uint8_t>> received;
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _)).WillRepeatedly(Invoke([&received](uint8_t link, uint8_t* data, uint16_t size) { received.emplace_back(data, data + size); }));
+
+    std::vector<std::vector<uint8_t>> frames = random_frames(2, 100);
+    for (auto frame : frames) {
+        byte_stuffer_send_frame(0, frame.data(), frame.size());
+    }
+    byte_stuffer_recv_buffer(1, sent_data.data(), sent_data.size());
+    EXPECT_EQ(received, frames);
+}
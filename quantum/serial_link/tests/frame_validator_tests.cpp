@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <cstring>
+#include <random>
+#include <vector>
 extern "C" {
 #include "serial_link/protocol/frame_validator.h"
 }
@@ -31,6 +34,7 @@ extern "C" {
 using testing::_;
 using testing::Args;
 using testing::ElementsAreArray;
+using testing::Invoke;
 
 class FrameValidator : public testing::Test {
    public:
@@ -98,3 +102,41 @@ TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
     EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
     validator_send_frame(0, original, 5);
 }
+
+// The CRC-32 worked out one bit at a time, to check the table driven one against
+static uint32_t reference_crc32(const uint8_t* data, uint16_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint16_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+TEST_F(FrameValidator, sends_standard_check_value) {
+    uint8_t  data[9 + 4] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    uint32_t crc         = 0;
+    EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).WillOnce(Invoke([&crc](uint8_t link, uint8_t* data, uint16_t size) { memcpy(&crc, data + size - 4, 4); }));
+    validator_send_frame(0, data, 9);
+    EXPECT_EQ(crc, 0xCBF43926);
+}
+
+TEST_F(FrameValidator, sends_crc_of_any_length_and_alignment) {
+    std::mt19937         rng(1);
+    std::vector<uint8_t> buffer(64 + 3 + 4);
+    for (uint16_t offset = 0; offset < 4; offset++) {
+        for (uint16_t size = 0; size <= 64; size++) {
+            for (auto& d : buffer) {
+                d = rng();
+            }
+            uint8_t* data     = buffer.data() + offset;
+            uint32_t expected = reference_crc32(data, size);
+            uint32_t crc      = 0;
+            EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).WillOnce(Invoke([&crc](uint8_t link, uint8_t* data, uint16_t size) { memcpy(&crc, data + size - 4, 4); }));
+            validator_send_frame(0, data, size);
+            ASSERT_EQ(crc, expected) << "size " << size << ", offset " << offset;
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2021
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+extern "C" {
+#include "serial_link/protocol/byte_stuffer.h"
+#include "serial_link/protocol/frame_validator.h"
+#include "serial_link/protocol/physical.h"
+}
+
+// The wire between the two ends, and what came out of the far end
+static std::vector<uint8_t> wire;
+static uint32_t             frames_received;
+static uint32_t             bytes_received;
+
+extern "C" {
+void send_data(uint8_t link, const uint8_t* data, uint16_t size) { wire.insert(wire.end(), data, data + size); }
+
+void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    frames_received++;
+    bytes_received += size;
+}
+}
+
+// Sends frames through the CRC and the byte stuffer, and receives them at the other end
+class SerialLinkThroughput : public testing::Test {
+   protected:
+    SerialLinkThroughput() {
+        init_byte_stuffer();
+        wire.clear();
+        frames_received = 0;
+        bytes_received  = 0;
+    }
+
+    // Frames per second for frames of the given size, where zeroes is the percentage of zero bytes in them
+    double frames_per_second(uint16_t size, int zeroes, bool by_buffer) {
+        const uint32_t                     num_frames = 20000;
+        std::mt19937                       rng(size);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::vector<uint8_t>               frame(size);
+        for (auto& d : frame) {
+            d = percent(rng) < zeroes ? 0 : 1 + rng() % 255;
+        }
+        // With room for the CRC after the frame
+        std::vector<uint8_t> buffer(size + 4);
+        memcpy(buffer.data(), frame.data(), size);
+        wire.reserve((size + size / 254 + 7) * 16);
+
+        std::chrono::steady_clock::duration busy{0};
+        for (uint32_t i = 0; i < num_frames; i++) {
+            wire.clear();
+            auto start = std::chrono::steady_clock::now();
+            validator_send_frame(0, buffer.data(), size);
+            if (by_buffer) {
+                byte_stuffer_recv_buffer(1, wire.data(), wire.size());
+            } else {
+                for (auto d : wire) {
+                    byte_stuffer_recv_byte(1, d);
+                }
+            }
+            busy += std::chrono::steady_clock::now() - start;
+        }
+        EXPECT_EQ(frames_received, num_frames);
+        EXPECT_EQ(bytes_received, num_frames * size);
+        frames_received = 0;
+        bytes_received  = 0;
+        return num_frames / std::chrono::duration<double>(busy).count();
+    }
+};
+
+TEST_F(SerialLinkThroughput, FramesPerSecond) {
+    struct {
+        const char* name;
+        uint16_t    size;
+        int         zeroes;
+    } profiles[] = {
+        {"matrix", 18, 70},
+        {"small", 32, 10},
+        {"large", 250, 10},
+        {"long runs", 1000, 0},
+    };
+    printf("\n  %-10s %6s %7s %14s %14s\n", "frame", "bytes", "zeroes", "bytewise f/s", "buffered f/s");
+    for (auto& profile : profiles) {
+        double by_byte   = frames_per_second(profile.size, profile.zeroes, false);
+        double by_buffer = frames_per_second(profile.size, profile.zeroes, true);
+        printf("  %-10s %6u %6d%% %14.0f %14.0f\n", profile.name, profile.size, profile.zeroes, by_byte, by_buffer);
+    }
+}
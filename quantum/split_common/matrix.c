@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "util.h"
 #include "matrix.h"
 #include "debounce.h"
@@ -23,8 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "split_util.h"
 #include "config.h"
 #include "transport.h"
-
-#define ERROR_DISCONNECT_COUNT 5
+#include "split_link.h"
 
 #define ROWS_PER_HAND (MATRIX_ROWS / 2)
 
@@ -45,6 +45,39 @@ uint8_t thisHand, thatHand;
 // user-defined overridable functions
 __attribute__((weak)) void matrix_slave_scan_user(void) {}
 
+// Transactions with the slave, so that a missing slave doesn't cost a timeout on every scan
+static split_link_t slave_link;
+static matrix_row_t slave_matrix[ROWS_PER_HAND];
+static bool         transport_result;
+
+// transport_master() is blocking, so the whole transaction still happens within the scan that starts it, and only the
+// retries of a failing one are spaced out
+static bool transport_start(void) {
+    transport_result = transport_master(matrix + thisHand, slave_matrix);
+    return true;
+}
+
+static split_link_state_t transport_poll(void) { return transport_result ? SPLIT_LINK_COMPLETE : SPLIT_LINK_ERROR; }
+
+static const split_link_driver_t transport_driver = {transport_start, transport_poll};
+
+#ifndef DISABLE_SYNC_TIMER
+// Time of the last change of each row of the slave, in sync timer ms. The slave records them, and the master gets
+// them with the slave matrix, so that slave key events aren't delayed by the transport.
+static uint16_t slave_row_times[ROWS_PER_HAND];
+
+// For custom transports that don't send the row times
+__attribute__((weak)) bool transport_master_row_times(uint16_t row_times[]) { return false; }
+__attribute__((weak)) void transport_slave_row_times(uint16_t row_times[]) {}
+
+uint16_t matrix_get_row_time(uint8_t row) {
+    if (row >= thatHand && row < thatHand + ROWS_PER_HAND) {
+        return slave_row_times[row - thatHand];
+    }
+    return timer_read();
+}
+#endif
+
 static inline void setPinOutput_writeLow(pin_t pin) {
     ATOMIC_BLOCK_FORCEON {
         setPinOutput(pin);
@@ -245,6 +278,7 @@ void matrix_init(void) {
     }
 
     debounce_init(ROWS_PER_HAND);
+    split_link_init(&slave_link);
 
     matrix_init_quantum();
 
@@ -254,34 +288,48 @@ void matrix_init(void) {
 bool matrix_post_scan(void) {
     bool changed = false;
     if (is_keyboard_master()) {
-        static uint8_t error_count;
-
-        matrix_row_t slave_matrix[ROWS_PER_HAND] = {0};
-        if (!transport_master(matrix + thisHand, slave_matrix)) {
-            error_count++;
-
-            if (error_count > ERROR_DISCONNECT_COUNT) {
-                // reset other half if disconnected
+        switch (split_link_task(&slave_link, &transport_driver)) {
+            case SPLIT_LINK_COMPLETE: {
+#ifndef DISABLE_SYNC_TIMER
+                uint16_t row_times[ROWS_PER_HAND];
+                bool     has_row_times = transport_master_row_times(row_times);
+#endif
                 for (int i = 0; i < ROWS_PER_HAND; ++i) {
-                    matrix[thatHand + i] = 0;
-                    slave_matrix[i]      = 0;
+                    if (matrix[thatHand + i] != slave_matrix[i]) {
+                        matrix[thatHand + i] = slave_matrix[i];
+                        changed              = true;
+#ifndef DISABLE_SYNC_TIMER
+                        slave_row_times[i] = has_row_times ? row_times[i] : timer_read();
+#endif
+                    }
                 }
-
-                changed = true;
+                break;
             }
-        } else {
-            error_count = 0;
-
-            for (int i = 0; i < ROWS_PER_HAND; ++i) {
-                if (matrix[thatHand + i] != slave_matrix[i]) {
-                    matrix[thatHand + i] = slave_matrix[i];
-                    changed              = true;
+            case SPLIT_LINK_ERROR:
+                if (!split_link_is_connected(&slave_link)) {
+                    // reset other half if disconnected
+                    for (int i = 0; i < ROWS_PER_HAND; ++i) {
+                        if (matrix[thatHand + i]) {
+                            matrix[thatHand + i] = 0;
+                            changed              = true;
+#ifndef DISABLE_SYNC_TIMER
+                            slave_row_times[i] = timer_read();
+#endif
+                        }
+                    }
                 }
-            }
+                break;
+            default:
+                // Keep the last slave matrix until a new one arrives
+                break;
         }
 
         matrix_scan_quantum();
     } else {
+#ifndef DISABLE_SYNC_TIMER
+        // The times go first, so that the master never sees a changed row with an old time
+        transport_slave_row_times(slave_row_times);
+#endif
         transport_slave(matrix + thatHand, matrix + thisHand);
 
         matrix_slave_scan_user();
@@ -305,8 +353,23 @@ uint8_t matrix_scan(void) {
     }
 #endif
 
+#ifndef DISABLE_SYNC_TIMER
+    matrix_row_t previous[ROWS_PER_HAND];
+    memcpy(previous, matrix + thisHand, sizeof(previous));
+#endif
+
     debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, local_changed);
 
+#ifndef DISABLE_SYNC_TIMER
+    if (!is_keyboard_master()) {
+        for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
+            if (matrix[thisHand + i] != previous[i]) {
+                slave_row_times[i] = sync_timer_read();
+            }
+        }
+    }
+#endif
+
     bool remote_changed = matrix_post_scan();
     return (uint8_t)(local_changed || remote_changed);
 }
@@ -0,0 +1,69 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "split_link.h"
+#include "timer.h"
+
+void split_link_init(split_link_t *link) {
+    link->state        = SPLIT_LINK_IDLE;
+    link->errors       = 0;
+    link->backoff      = 0;
+    link->last_failure = 0;
+}
+
+static split_link_state_t split_link_finish(split_link_t *link, split_link_state_t result) {
+    link->state = result;
+    if (result == SPLIT_LINK_COMPLETE) {
+        link->errors  = 0;
+        link->backoff = 0;
+    } else {
+        if (link->errors < UINT8_MAX) {
+            link->errors++;
+        }
+        // A glitch is retried on the next call, so that it doesn't hold up the sync of anything else. Once the other half
+        // is disconnected, wait twice as long after each failure, so that it doesn't cost a timeout on every scan.
+        if (link->errors > SPLIT_LINK_DISCONNECT_COUNT) {
+            link->backoff      = link->backoff == 0 ? 1 : link->backoff * 2;
+            link->backoff      = link->backoff > SPLIT_LINK_BACKOFF_MAX ? SPLIT_LINK_BACKOFF_MAX : link->backoff;
+            link->last_failure = timer_read();
+        }
+    }
+    return result;
+}
+
+split_link_state_t split_link_task(split_link_t *link, const split_link_driver_t *driver) {
+    if (link->state != SPLIT_LINK_IN_FLIGHT) {
+        if (link->backoff && timer_elapsed(link->last_failure) < link->backoff) {
+            link->state = SPLIT_LINK_IDLE;
+            return SPLIT_LINK_IDLE;
+        }
+        if (!driver->start()) {
+            return split_link_finish(link, SPLIT_LINK_ERROR);
+        }
+        link->state = SPLIT_LINK_IN_FLIGHT;
+    }
+
+    switch (driver->poll()) {
+        case SPLIT_LINK_IN_FLIGHT:
+            return SPLIT_LINK_IN_FLIGHT;
+        case SPLIT_LINK_COMPLETE:
+            return split_link_finish(link, SPLIT_LINK_COMPLETE);
+        default:
+            return split_link_finish(link, SPLIT_LINK_ERROR);
+    }
+}
+
+bool split_link_is_connected(const split_link_t *link) { return link->errors <= SPLIT_LINK_DISCONNECT_COUNT; }
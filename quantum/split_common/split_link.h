@@ -0,0 +1,62 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Longest wait between attempts to reach an absent half, in ms
+#ifndef SPLIT_LINK_BACKOFF_MAX
+#    define SPLIT_LINK_BACKOFF_MAX 128
+#endif
+
+// Failed transactions in a row before the other half counts as disconnected
+#ifndef SPLIT_LINK_DISCONNECT_COUNT
+#    define SPLIT_LINK_DISCONNECT_COUNT 5
+#endif
+
+typedef enum {
+    SPLIT_LINK_IDLE,
+    SPLIT_LINK_IN_FLIGHT,
+    SPLIT_LINK_COMPLETE,
+    SPLIT_LINK_ERROR,
+} split_link_state_t;
+
+// A transport that can run a transaction with the other half.
+// start() begins a transaction, and returns false if it couldn't.
+// poll() then returns SPLIT_LINK_IN_FLIGHT until the transaction is done, and then SPLIT_LINK_COMPLETE or SPLIT_LINK_ERROR.
+// A blocking transport can do the whole transaction in start(), and just report the result in poll().
+typedef struct {
+    bool (*start)(void);
+    split_link_state_t (*poll)(void);
+} split_link_driver_t;
+
+typedef struct {
+    split_link_state_t state;
+    uint8_t            errors;   // failed transactions in a row
+    uint16_t           backoff;  // ms to wait after the last failure
+    uint16_t           last_failure;
+} split_link_t;
+
+void split_link_init(split_link_t *link);
+
+// Moves the transaction along, without waiting for it. Call it once per scan.
+// Returns SPLIT_LINK_COMPLETE or SPLIT_LINK_ERROR on the call where a transaction ended,
+// SPLIT_LINK_IN_FLIGHT while one is running, and SPLIT_LINK_IDLE while waiting to retry.
+split_link_state_t split_link_task(split_link_t *link, const split_link_driver_t *driver);
+
+bool split_link_is_connected(const split_link_t *link);
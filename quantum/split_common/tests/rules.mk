@@ -0,0 +1,9 @@
+split_link_DEFS := -DNO_DEBUG -DNO_PRINT
+
+split_link_INC := \
+	$(QUANTUM_PATH)/split_common
+
+split_link_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_link_tests.cpp \
+	$(QUANTUM_PATH)/split_common/split_link.c \
+	$(TMK_PATH)/common/test/timer.c
@@ -0,0 +1,156 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "split_link.h"
+void advance_time(uint32_t ms);
+}
+
+// A simulated link, where a transaction takes latency polls, and fails if the other half isn't connected
+static struct {
+    bool     connected;
+    bool     can_start;
+    unsigned latency;
+    unsigned remaining;
+    unsigned starts;
+} sim;
+
+static bool sim_start(void) {
+    if (!sim.can_start) {
+        return false;
+    }
+    sim.starts++;
+    sim.remaining = sim.latency;
+    return true;
+}
+
+static split_link_state_t sim_poll(void) {
+    if (sim.remaining > 0) {
+        sim.remaining--;
+        return SPLIT_LINK_IN_FLIGHT;
+    }
+    return sim.connected ? SPLIT_LINK_COMPLETE : SPLIT_LINK_ERROR;
+}
+
+static const split_link_driver_t sim_driver = {sim_start, sim_poll};
+
+class SplitLink : public ::testing::Test {
+   protected:
+    split_link_t link;
+
+    void SetUp() override {
+        sim = {true, true, 0, 0, 0};
+        split_link_init(&link);
+    }
+
+    // Runs one task call per ms, and returns the times of the transactions started
+    std::vector<unsigned> run_for(unsigned ms) {
+        std::vector<unsigned> starts;
+        for (unsigned t = 0; t < ms; t++) {
+            unsigned before = sim.starts;
+            split_link_task(&link, &sim_driver);
+            if (sim.starts != before) {
+                starts.push_back(t);
+            }
+            advance_time(1);
+        }
+        return starts;
+    }
+};
+
+TEST_F(SplitLink, BlockingTransportCompletesInOneCall) {
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_COMPLETE);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_COMPLETE);
+    EXPECT_EQ(sim.starts, 2u);
+}
+
+TEST_F(SplitLink, TransactionInFlightIsPolledWithoutRestarting) {
+    sim.latency = 3;
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_IN_FLIGHT);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_IN_FLIGHT);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_IN_FLIGHT);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_COMPLETE);
+    EXPECT_EQ(sim.starts, 1u);
+    // The next call starts a new one
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_IN_FLIGHT);
+    EXPECT_EQ(sim.starts, 2u);
+}
+
+TEST_F(SplitLink, AbsentHalfIsRetriedWithExponentialBackoff) {
+    sim.connected = false;
+    std::vector<unsigned> starts = run_for(600);
+    // Every scan until it counts as disconnected, then backing off
+    std::vector<unsigned> expected = {0, 1, 2, 3, 4, 5, 6, 8, 12, 20, 36, 68, 132, 260, 388, 516};
+    EXPECT_EQ(starts, expected);
+    EXPECT_FALSE(split_link_is_connected(&link));
+}
+
+TEST_F(SplitLink, WaitingForRetryIsIdle) {
+    sim.connected = false;
+    for (int i = 0; i < SPLIT_LINK_DISCONNECT_COUNT; i++) {
+        EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_ERROR);
+    }
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_ERROR);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_IDLE);
+    advance_time(1);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_ERROR);
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_IDLE);
+    EXPECT_EQ(sim.starts, SPLIT_LINK_DISCONNECT_COUNT + 2u);
+}
+
+TEST_F(SplitLink, ReconnectingResetsBackoff) {
+    sim.connected = false;
+    run_for(300);
+    EXPECT_FALSE(split_link_is_connected(&link));
+
+    sim.connected = true;
+    std::vector<unsigned> starts = run_for(200);
+    // Noticed on the next retry, and then a transaction on every call
+    ASSERT_FALSE(starts.empty());
+    EXPECT_LE(starts.front(), (unsigned)SPLIT_LINK_BACKOFF_MAX);
+    EXPECT_EQ(starts.size(), 200 - starts.front());
+    EXPECT_TRUE(split_link_is_connected(&link));
+}
+
+TEST_F(SplitLink, SingleErrorsDontDisconnect) {
+    for (int i = 0; i < SPLIT_LINK_DISCONNECT_COUNT; i++) {
+        sim.connected = false;
+        EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_ERROR);
+        EXPECT_TRUE(split_link_is_connected(&link));
+    }
+    sim.connected = true;
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_COMPLETE);
+    EXPECT_EQ(link.errors, 0);
+}
+
+TEST_F(SplitLink, GlitchesAreRetriedStraightAway) {
+    // Every other transaction fails
+    for (unsigned t = 0; t < 20; t++) {
+        sim.connected = t % 2;
+        EXPECT_EQ(run_for(1), std::vector<unsigned>{0});
+    }
+    EXPECT_EQ(link.backoff, 0);
+}
+
+TEST_F(SplitLink, FailingToStartIsAnError) {
+    sim.can_start = false;
+    EXPECT_EQ(split_link_task(&link, &sim_driver), SPLIT_LINK_ERROR);
+    EXPECT_EQ(link.errors, 1);
+}
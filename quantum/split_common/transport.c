@@ -54,6 +54,10 @@ typedef struct _I2C_slave_buffer_t {
 #    ifdef WPM_ENABLE
     uint8_t current_wpm;
 #    endif
+#    ifndef DISABLE_SYNC_TIMER
+    // Last, as it is only sent if there is room left in the slave registers
+    uint16_t srow_times[ROWS_PER_HAND];
+#    endif
 } I2C_slave_buffer_t;
 
 static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_reg;
@@ -68,6 +72,8 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 #    define I2C_RGB_START offsetof(I2C_slave_buffer_t, rgblight_sync)
 #    define I2C_ENCODER_START offsetof(I2C_slave_buffer_t, encoder_state)
 #    define I2C_WPM_START offsetof(I2C_slave_buffer_t, current_wpm)
+#    define I2C_ROW_TIMES_START offsetof(I2C_slave_buffer_t, srow_times)
+#    define I2C_ROW_TIMES_FIT (I2C_ROW_TIMES_START + sizeof(i2c_buffer->srow_times) <= I2C_SLAVE_REG_COUNT)
 
 #    define TIMEOUT 100
 
@@ -77,7 +83,15 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 
 // Get rows from other half over i2c
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_SLAVE_START, (void *)slave_matrix, sizeof(i2c_buffer->smatrix), TIMEOUT);
+    if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_SLAVE_START, (void *)slave_matrix, sizeof(i2c_buffer->smatrix), TIMEOUT) < 0) {
+        return false;
+    }
+#    ifndef DISABLE_SYNC_TIMER
+    // The row times must belong to the rows just read
+    if (I2C_ROW_TIMES_FIT && i2c_readReg(SLAVE_I2C_ADDRESS, I2C_ROW_TIMES_START, (void *)i2c_buffer->srow_times, sizeof(i2c_buffer->srow_times), TIMEOUT) < 0) {
+        return false;
+    }
+#    endif
 #    ifdef SPLIT_TRANSPORT_MIRROR
     i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_MASTER_START, (void *)master_matrix, sizeof(i2c_buffer->mmatrix), TIMEOUT);
 #    endif
@@ -188,6 +202,22 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 #    endif
 }
 
+#    ifndef DISABLE_SYNC_TIMER
+bool transport_master_row_times(uint16_t slave_row_times[]) {
+    if (!I2C_ROW_TIMES_FIT) {
+        return false;
+    }
+    memcpy((void *)slave_row_times, (void *)i2c_buffer->srow_times, sizeof(i2c_buffer->srow_times));
+    return true;
+}
+
+void transport_slave_row_times(uint16_t slave_row_times[]) {
+    if (I2C_ROW_TIMES_FIT) {
+        memcpy((void *)i2c_buffer->srow_times, (void *)slave_row_times, sizeof(i2c_buffer->srow_times));
+    }
+}
+#    endif
+
 void transport_master_init(void) { i2c_init(); }
 
 void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
@@ -199,6 +229,9 @@ void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
 typedef struct _Serial_s2m_buffer_t {
     // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
     matrix_row_t smatrix[ROWS_PER_HAND];
+#    ifndef DISABLE_SYNC_TIMER
+    uint16_t     srow_times[ROWS_PER_HAND];
+#    endif
 
 #    ifdef ENCODER_ENABLE
     uint8_t      encoder_state[NUMBER_OF_ENCODERS];
@@ -349,6 +382,21 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     return true;
 }
 
+#    ifndef DISABLE_SYNC_TIMER
+bool transport_master_row_times(uint16_t slave_row_times[]) {
+    for (int i = 0; i < ROWS_PER_HAND; ++i) {
+        slave_row_times[i] = serial_s2m_buffer.srow_times[i];
+    }
+    return true;
+}
+
+void transport_slave_row_times(uint16_t slave_row_times[]) {
+    for (int i = 0; i < ROWS_PER_HAND; ++i) {
+        serial_s2m_buffer.srow_times[i] = slave_row_times[i];
+    }
+}
+#    endif
+
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     transport_rgblight_slave();
 #    ifndef DISABLE_SYNC_TIMER
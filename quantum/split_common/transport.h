@@ -8,3 +8,10 @@ void transport_slave_init(void);
 // returns false if valid data not received from slave
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+#ifndef DISABLE_SYNC_TIMER
+// sync timer times of the last change of each slave row, sent along with the slave matrix
+// returns false if the transport doesn't send them
+bool transport_master_row_times(uint16_t slave_row_times[]);
+void transport_slave_row_times(uint16_t slave_row_times[]);
+#endif
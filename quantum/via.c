@@ -47,6 +47,9 @@
 #include "tmk_core/common/eeprom.h"
 #include "version.h"  // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
+#ifdef TASK_PROFILER_ENABLE
+#    include "task_profiler.h"
+#endif
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -59,6 +62,10 @@ void via_qmk_rgblight_set_value(uint8_t *data);
 void via_qmk_rgblight_get_value(uint8_t *data);
 #endif
 
+void via_bulk_transfer_begin(uint8_t *data);
+void via_bulk_transfer_data(uint8_t *data, uint8_t length);
+void via_bulk_transfer_end(uint8_t *data);
+
 // Can be called in an overriding via_init_kb() to test if keyboard level code usage of
 // EEPROM is invalid and use/save defaults.
 bool via_eeprom_is_valid(void) {
@@ -203,6 +210,13 @@ __attribute__((weak)) void raw_hid_receive_kb(uint8_t *data, uint8_t length) {
 void raw_hid_receive(uint8_t *data, uint8_t length) {
     uint8_t *command_id   = &(data[0]);
     uint8_t *command_data = &(data[1]);
+#ifdef TASK_PROFILER_ENABLE
+    // Answered under whatever TASK_PROFILER_RAW_HID_ID is set to
+    if (task_profiler_raw_hid(data, length)) {
+        raw_hid_send(data, length);
+        return;
+    }
+#endif
     switch (*command_id) {
         case id_get_protocol_version: {
             command_data[0] = VIA_PROTOCOL_VERSION >> 8;
@@ -371,6 +385,18 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_buffer(offset, size, &command_data[3]);
             break;
         }
+        case id_bulk_transfer_begin: {
+            via_bulk_transfer_begin(command_data);
+            break;
+        }
+        case id_bulk_transfer_data: {
+            via_bulk_transfer_data(command_data, length - 1);
+            break;
+        }
+        case id_bulk_transfer_end: {
+            via_bulk_transfer_end(command_data);
+            break;
+        }
         default: {
             // The command ID is not known
             // Return the unhandled state
@@ -384,6 +410,229 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
     raw_hid_send(data, length);
 }
 
+// The bulk transfer session, see via.h for the protocol
+static struct {
+    bool     active;
+    bool     write;
+    bool     repeatable;    // a chunk has been through, so its sequence number can be repeated
+    uint8_t  region;
+    uint8_t  sequence;      // the sequence number of the next chunk
+    uint16_t offset;        // where the next chunk starts, in bytes
+    uint16_t chunk_offset;  // where the last chunk started
+} via_bulk;
+
+// Written bytes that aren't in EEPROM yet, from via_bulk_stage_offset on
+static uint8_t  via_bulk_stage[VIA_BULK_STAGE_SIZE];
+static uint16_t via_bulk_stage_offset;
+static uint8_t  via_bulk_stage_length;
+
+static uint16_t via_bulk_region_size(void) { return via_bulk.region == id_bulk_region_keymap ? dynamic_keymap_get_buffer_size() : dynamic_keymap_macro_get_buffer_size(); }
+
+static uint16_t via_bulk_read_word(uint16_t word) {
+    uint8_t data[2];
+    if (via_bulk.region == id_bulk_region_keymap) {
+        dynamic_keymap_get_buffer(word * 2, 2, data);
+    } else {
+        dynamic_keymap_macro_get_buffer(word * 2, 2, data);
+    }
+    return (data[0] << 8) | data[1];
+}
+
+static void via_bulk_flush(void) {
+    if (via_bulk_stage_length == 0) {
+        return;
+    }
+    if (via_bulk.region == id_bulk_region_keymap) {
+        dynamic_keymap_set_buffer(via_bulk_stage_offset, via_bulk_stage_length, via_bulk_stage);
+    } else {
+        dynamic_keymap_macro_set_buffer(via_bulk_stage_offset, via_bulk_stage_length, via_bulk_stage);
+    }
+    via_bulk_stage_length = 0;
+}
+
+static void via_bulk_stage_word(uint16_t word, uint16_t value) {
+    uint8_t data[2] = {value >> 8, value & 0xFF};
+    for (uint8_t i = 0; i < 2; i++) {
+        uint16_t offset = word * 2 + i;
+        if (via_bulk_stage_length > 0 && (offset != via_bulk_stage_offset + via_bulk_stage_length || via_bulk_stage_length == VIA_BULK_STAGE_SIZE)) {
+            via_bulk_flush();
+        }
+        if (via_bulk_stage_length == 0) {
+            via_bulk_stage_offset = offset;
+        }
+        via_bulk_stage[via_bulk_stage_length++] = data[i];
+    }
+}
+
+// Goes through the tokens of a written chunk, staging the data only if apply is set,
+// and returns false if the chunk isn't valid
+static bool via_bulk_decode(const uint8_t *chunk, uint8_t length, bool apply) {
+    uint16_t words = (via_bulk_region_size() + 1) / 2;
+    uint16_t word  = via_bulk.offset / 2;
+    uint16_t i     = 0;
+    while (i < length) {
+        uint8_t token = chunk[i++];
+        uint8_t count = (token & 0x3F) + 1;
+        if (word + count > words) {
+            return false;
+        }
+        switch (token & 0xC0) {
+            case 0x00:
+                if (i + count * 2 > length) {
+                    return false;
+                }
+                for (uint8_t k = 0; apply && k < count; k++) {
+                    via_bulk_stage_word(word + k, (chunk[i + k * 2] << 8) | chunk[i + k * 2 + 1]);
+                }
+                i += count * 2;
+                break;
+            case 0x40:
+                if (i + 2 > length) {
+                    return false;
+                }
+                for (uint8_t k = 0; apply && k < count; k++) {
+                    via_bulk_stage_word(word + k, (chunk[i] << 8) | chunk[i + 1]);
+                }
+                i += 2;
+                break;
+            case 0x80:
+                break;
+            default:
+                return false;
+        }
+        word += count;
+    }
+    if (apply) {
+        via_bulk.offset = word * 2;
+    }
+    return true;
+}
+
+// The number of words from word on that are the same as value, up to what fits in a token
+static uint8_t via_bulk_run_length(uint16_t word, uint16_t words, uint16_t value) {
+    uint8_t run = 1;
+    while (run < 64 && word + run < words && via_bulk_read_word(word + run) == value) {
+        run++;
+    }
+    return run;
+}
+
+// Fills a chunk to be read with as many tokens as fit in space, and returns its length
+static uint8_t via_bulk_encode(uint8_t *chunk, uint8_t space) {
+    uint16_t words  = (via_bulk_region_size() + 1) / 2;
+    uint16_t word   = via_bulk.offset / 2;
+    uint8_t  length = 0;
+    while (word < words && length + 3 <= space) {
+        uint16_t value = via_bulk_read_word(word);
+        uint8_t  run   = via_bulk_run_length(word, words, value);
+        if (run > 1) {
+            chunk[length++] = 0x40 | (run - 1);
+            chunk[length++] = value >> 8;
+            chunk[length++] = value & 0xFF;
+            word += run;
+        } else {
+            // Words that differ from the one after them, up to where the next run starts
+            uint8_t token = length++;
+            uint8_t count = 0;
+            while (word < words && count < 64 && length + 2 <= space) {
+                value = via_bulk_read_word(word);
+                if (count > 0 && via_bulk_run_length(word, words, value) > 1) {
+                    break;
+                }
+                chunk[length++] = value >> 8;
+                chunk[length++] = value & 0xFF;
+                count++;
+                word++;
+            }
+            chunk[token] = count - 1;
+        }
+    }
+    via_bulk.offset = word * 2;
+    return length;
+}
+
+void via_bulk_transfer_begin(uint8_t *data) {
+    uint8_t *region    = &(data[0]);
+    uint8_t *direction = &(data[1]);
+    uint8_t *status    = &(data[2]);
+    // Anything staged by a session that wasn't ended is dropped
+    via_bulk_stage_length = 0;
+    via_bulk.active       = false;
+    if ((*region != id_bulk_region_keymap && *region != id_bulk_region_macro) || *direction > 1) {
+        *status = id_bulk_error_session;
+        return;
+    }
+    via_bulk.active       = true;
+    via_bulk.write        = *direction == 1;
+    via_bulk.repeatable   = false;
+    via_bulk.region       = *region;
+    via_bulk.sequence     = 0;
+    via_bulk.offset       = 0;
+    via_bulk.chunk_offset = 0;
+
+    uint16_t size = via_bulk_region_size();
+    if (via_bulk.write && via_bulk.region == id_bulk_region_macro) {
+        // Macros can't be sent until the last byte is written as zero, see dynamic_keymap.h
+        uint8_t invalid = 0xFF;
+        dynamic_keymap_macro_set_buffer(size - 1, 1, &invalid);
+    }
+    *status = id_bulk_ok;
+    data[3] = size >> 8;
+    data[4] = size & 0xFF;
+}
+
+void via_bulk_transfer_data(uint8_t *data, uint8_t length) {
+    uint8_t *sequence     = &(data[0]);
+    uint8_t *status       = &(data[1]);
+    uint8_t *chunk_length = &(data[2]);
+    uint8_t *chunk        = &(data[3]);
+    uint8_t  space        = length - 3;
+    bool     repeat       = via_bulk.repeatable && *sequence == (uint8_t)(via_bulk.sequence - 1);
+    if (!via_bulk.active) {
+        *status = id_bulk_error_session;
+        return;
+    }
+    if (*sequence != via_bulk.sequence && !repeat) {
+        *status = id_bulk_error_sequence;
+        return;
+    }
+    if (via_bulk.write) {
+        // A repeated chunk has already been written
+        if (!repeat) {
+            if (*chunk_length > space || !via_bulk_decode(chunk, *chunk_length, false)) {
+                *status = id_bulk_error_data;
+                return;
+            }
+            via_bulk_decode(chunk, *chunk_length, true);
+        }
+    } else {
+        if (repeat) {
+            via_bulk.offset = via_bulk.chunk_offset;
+        } else {
+            via_bulk.chunk_offset = via_bulk.offset;
+        }
+        *chunk_length = via_bulk_encode(chunk, space);
+    }
+    if (!repeat) {
+        via_bulk.sequence++;
+        via_bulk.repeatable = true;
+    }
+    *status = id_bulk_ok;
+}
+
+void via_bulk_transfer_end(uint8_t *data) {
+    uint8_t *status = &(data[0]);
+    if (!via_bulk.active) {
+        *status = id_bulk_error_session;
+        return;
+    }
+    if (via_bulk.write) {
+        via_bulk_flush();
+    }
+    via_bulk.active = false;
+    *status         = id_bulk_ok;
+}
+
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
 
 #    if BACKLIGHT_LEVELS == 0
@@ -78,9 +78,49 @@ enum via_command_id {
     id_dynamic_keymap_get_layer_count       = 0x11,
     id_dynamic_keymap_get_buffer            = 0x12,
     id_dynamic_keymap_set_buffer            = 0x13,
+    id_bulk_transfer_begin                  = 0x14,
+    id_bulk_transfer_data                   = 0x15,
+    id_bulk_transfer_end                    = 0x16,
+    // 0x17 is where the task profiler answers by default, see TASK_PROFILER_RAW_HID_ID
     id_unhandled                            = 0xFF,
 };
 
+// Bulk transfers move a whole keymap or macro buffer in a session of
+// compressed chunks, instead of 28 bytes per command.
+//
+// begin: region, direction (0 = read, 1 = write)
+//        returns status, then the size of the region in bytes (big endian)
+// data:  sequence number, status, chunk length, chunk
+//        sequence numbers start at 0 and wrap. Sending the previous
+//        sequence number again repeats it, in case the reply was lost.
+//        When reading, the keyboard fills in the chunk, and a chunk of
+//        length 0 means the end of the region.
+// end:   returns status, after the written data is in EEPROM
+//
+// A chunk is a list of tokens over 16-bit words, which are keycodes for
+// the keymap region. A token is never split between chunks.
+//   0b00nnnnnn  n + 1 words follow
+//   0b01nnnnnn  the word that follows, n + 1 times
+//   0b10nnnnnn  skip n + 1 words, leaving them as they are (write only)
+enum via_bulk_region {
+    id_bulk_region_keymap = 0x00,
+    id_bulk_region_macro  = 0x01,
+};
+
+enum via_bulk_status {
+    id_bulk_ok             = 0x00,
+    id_bulk_error_session  = 0x01,  // no session, or an unknown region or direction
+    id_bulk_error_sequence = 0x02,
+    id_bulk_error_data     = 0x03,  // a bad token, or past the end of the region
+};
+
+// Written data is staged in a buffer of this size, and goes to EEPROM
+// when the buffer is full, when a token skips over data, and at the
+// end of the session.
+#ifndef VIA_BULK_STAGE_SIZE
+#    define VIA_BULK_STAGE_SIZE 64
+#endif
+
 enum via_keyboard_value_id {
     id_uptime              = 0x01,  //
     id_layout_options      = 0x02,
@@ -0,0 +1,145 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+#define A_KEY 0, 0
+#define B_KEY 1, 0
+#define C_KEY 2, 0
+#define D_KEY 3, 0
+#define E_KEY 4, 0
+#define ENTER_KEY 5, 0
+
+#define AT_TIME(t) WillOnce(InvokeWithoutArgs([=]() { EXPECT_EQ(timer_elapsed32(start), t); }))
+
+class AutoShift : public TestFixture {
+   protected:
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start;
+
+    void SetUp() override { start = timer_read32(); }
+
+    void press(uint8_t col, uint8_t row) {
+        press_key(col, row);
+        run_one_scan_loop();
+    }
+
+    void release(uint8_t col, uint8_t row) {
+        release_key(col, row);
+        run_one_scan_loop();
+    }
+
+    // The reports of an auto-shiftable key being sent, starting at the given time
+    void expect_key(uint8_t keycode, bool shifted, uint32_t time) {
+        if (shifted) {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, keycode))).AT_TIME(time);
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+        } else {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(keycode))).AT_TIME(time);
+        }
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+};
+
+TEST_F(AutoShift, TapIsNotShifted) {
+    expect_key(KC_A, false, 20);
+    press(A_KEY);
+    idle_for(19);
+    release(A_KEY);
+}
+
+TEST_F(AutoShift, HoldIsShiftedAtTimeout) {
+    expect_key(KC_A, true, AUTO_SHIFT_TIMEOUT);
+    press(A_KEY);
+    idle_for(AUTO_SHIFT_TIMEOUT + 50);
+    release(A_KEY);
+}
+
+TEST_F(AutoShift, RollIsSentInOrder) {
+    expect_key(KC_A, false, 30);
+    expect_key(KC_B, false, 50);
+    press(A_KEY);
+    idle_for(9);
+    press(B_KEY);
+    idle_for(19);
+    release(A_KEY);
+    idle_for(19);
+    release(B_KEY);
+}
+
+// Pressing another key no longer decides the key before it, so both can be held for shift
+TEST_F(AutoShift, OverlappingHoldsAreBothShifted) {
+    expect_key(KC_A, true, AUTO_SHIFT_TIMEOUT);
+    expect_key(KC_B, true, AUTO_SHIFT_TIMEOUT + 10);
+    press(A_KEY);
+    idle_for(9);
+    press(B_KEY);
+    idle_for(AUTO_SHIFT_TIMEOUT + 50);
+    release(A_KEY);
+    release(B_KEY);
+}
+
+// A key released early waits for the one pressed before it
+TEST_F(AutoShift, LaterKeyWaitsForEarlierKey) {
+    expect_key(KC_A, true, AUTO_SHIFT_TIMEOUT);
+    expect_key(KC_B, false, AUTO_SHIFT_TIMEOUT);
+    press(A_KEY);
+    idle_for(9);
+    press(B_KEY);
+    idle_for(9);
+    release(B_KEY);
+    idle_for(AUTO_SHIFT_TIMEOUT);
+    release(A_KEY);
+}
+
+TEST_F(AutoShift, OtherKeySendsPendingKeys) {
+    expect_key(KC_A, true, AUTO_SHIFT_TIMEOUT);
+    expect_key(KC_B, false, 201);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENT))).AT_TIME(201);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    press(A_KEY);
+    idle_for(190);
+    press(B_KEY);
+    idle_for(9);
+    press(ENTER_KEY);
+    release(ENTER_KEY);
+    release(A_KEY);
+    release(B_KEY);
+}
+
+// With more keys pressed than can be pending, the oldest is decided early
+TEST_F(AutoShift, OldestKeyIsDecidedWhenFull) {
+    expect_key(KC_A, false, 4);
+    expect_key(KC_B, false, 6);
+    expect_key(KC_C, false, 7);
+    expect_key(KC_D, false, 8);
+    expect_key(KC_E, false, 9);
+    press(A_KEY);
+    press(B_KEY);
+    press(C_KEY);
+    press(D_KEY);
+    press(E_KEY);
+    release(A_KEY);
+    release(B_KEY);
+    release(C_KEY);
+    release(D_KEY);
+    release(E_KEY);
+}
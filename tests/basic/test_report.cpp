@@ -0,0 +1,130 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_util.h"
+#include "host.h"
+
+using testing::_;
+using testing::InSequence;
+
+class Report : public TestFixture {};
+
+TEST_F(Report, SameReportIsOnlySentOnce) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);  // KC_A
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    uint16_t suppressed = host_keyboard_reports_suppressed();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    send_keyboard_report();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_keyboard_reports_suppressed(), suppressed + 2);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Report, NewDriverIsSentTheSameReport) {
+    press_key(0, 0);  // KC_A
+    {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        run_one_scan_loop();
+    }
+    {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        send_keyboard_report();
+    }
+    release_key(0, 0);
+}
+
+TEST_F(Report, ForgottenReportIsSentAgain) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);  // KC_A
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+
+    // Like after a USB reset or a suspend, where the driver may have dropped it
+    host_keyboard_forget_last_report();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    send_keyboard_report();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Report, KeysCountFollowsTheReport) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+
+    add_key(KC_A);
+    add_key(KC_A);
+    EXPECT_EQ(get_keys_count(), 1);
+    del_key(KC_B);
+    EXPECT_EQ(get_keys_count(), 1);
+
+    // The report is full after six keys, and the seventh isn't added
+    for (uint8_t key = KC_B; key <= KC_G; key++) {
+        add_key(key);
+    }
+    EXPECT_EQ(get_keys_count(), KEYBOARD_REPORT_KEYS);
+    EXPECT_EQ(has_anykey(keyboard_report), KEYBOARD_REPORT_KEYS);
+    del_key(KC_G);
+    EXPECT_EQ(get_keys_count(), KEYBOARD_REPORT_KEYS);
+
+    del_key(KC_A);
+    EXPECT_EQ(get_keys_count(), KEYBOARD_REPORT_KEYS - 1);
+    EXPECT_EQ(has_anykey(keyboard_report), KEYBOARD_REPORT_KEYS - 1);
+
+    clear_keys();
+    EXPECT_EQ(get_keys_count(), 0);
+    EXPECT_EQ(has_anykey(keyboard_report), 0);
+}
+
+TEST_F(Report, OneshotModsAreClearedWithTheNextKey) {
+    TestDriver driver;
+    InSequence s;
+
+    set_oneshot_mods(MOD_BIT(KC_LSFT));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    send_keyboard_report();
+    EXPECT_EQ(get_oneshot_mods(), MOD_BIT(KC_LSFT));
+
+    press_key(0, 0);  // KC_A
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    EXPECT_EQ(get_oneshot_mods(), 0);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
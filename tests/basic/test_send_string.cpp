@@ -0,0 +1,135 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+class SendString : public TestFixture {};
+
+#define AT_TIME(t) WillOnce(InvokeWithoutArgs([start]() { EXPECT_EQ(timer_elapsed32(start), t); }))
+
+TEST_F(SendString, BlockingStringIsSentImmediately) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_H))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_I))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(20);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(20);
+    SEND_STRING("Hi" SS_DELAY(20) "a");
+    EXPECT_FALSE(send_string_is_busy());
+}
+
+TEST_F(SendString, LongDelaysDontWrap) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(70000);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(70000);
+    SEND_STRING("a" SS_DELAY(70000) "b");
+}
+
+TEST_F(SendString, BlockingStringHonoursInterval) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(10);
+    SEND_STRING_DELAY("ab", 10);
+}
+
+TEST_F(SendString, AsyncStringSendsOneReportPerScan) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    EXPECT_TRUE(SEND_STRING_ASYNC("Hi" SS_TAP(X_END) SS_DOWN(X_LCTL) "c" SS_UP(X_LCTL)));
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    uint32_t start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_H))).AT_TIME(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).AT_TIME(2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_I))).AT_TIME(4);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(5);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_END))).AT_TIME(6);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(7);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL))).AT_TIME(8);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_C))).AT_TIME(9);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL))).AT_TIME(10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(11);
+    idle_for(20);
+    EXPECT_FALSE(send_string_is_busy());
+}
+
+TEST_F(SendString, ScanningContinuesDuringAsyncDelay) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_TRUE(SEND_STRING_ASYNC("a" SS_DELAY(100) "b"));
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(1);
+    idle_for(10);
+
+    // A physical key is processed while the string is still playing
+    press_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C))).AT_TIME(10);
+    run_one_scan_loop();
+    EXPECT_TRUE(send_string_is_busy());
+    release_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(11);
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(102);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(103);
+    idle_for(100);
+    EXPECT_FALSE(send_string_is_busy());
+}
+
+TEST_F(SendString, BlockingStringWaitsForQueuedAsyncStrings) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_TRUE(SEND_STRING_ASYNC("a" SS_DELAY(50)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(50);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(50);
+    SEND_STRING("b");
+}
+
+TEST_F(SendString, AsyncQueueRejectsStringsWhenFull) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    for (uint8_t i = 0; i < SEND_STRING_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(SEND_STRING_ASYNC("x"));
+    }
+    EXPECT_FALSE(SEND_STRING_ASYNC("y"));
+    send_string_flush();
+    EXPECT_FALSE(send_string_is_busy());
+}
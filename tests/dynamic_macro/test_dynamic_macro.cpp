@@ -0,0 +1,262 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "eeprom.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+#define KEY_A 0, 0
+#define KEY_B 1, 0
+#define KEY_C 2, 0
+#define KEY_REC1 5, 0
+#define KEY_REC2 6, 0
+#define KEY_PLAY1 7, 0
+#define KEY_PLAY2 8, 0
+#define KEY_STOP 9, 0
+#define KEY_LSFT 0, 1
+#define KEY_TG1 1, 1
+
+static bool macro_full = false;
+
+extern "C" void dynamic_macro_record_key_user(int8_t direction, keyrecord_t *record) { macro_full = true; }
+
+class DynamicMacro : public TestFixture {
+   protected:
+    void tap_key(uint8_t col, uint8_t row) {
+        press_key(col, row);
+        run_one_scan_loop();
+        release_key(col, row);
+        run_one_scan_loop();
+    }
+
+    void record(uint8_t rec_col, uint8_t rec_row, const std::vector<std::pair<uint8_t, uint8_t>> &keys) {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        tap_key(rec_col, rec_row);
+        for (auto &key : keys) {
+            tap_key(key.first, key.second);
+        }
+        tap_key(KEY_STOP);
+    }
+};
+
+#define AT_TIME(t) WillOnce(InvokeWithoutArgs([start]() { EXPECT_EQ(timer_elapsed32(start), t); }))
+
+TEST_F(DynamicMacro, EventEncodingRoundTrips) {
+    keyrecord_t records[4]     = {};
+    records[0].event.key       = (keypos_t){.col = 0, .row = 0};
+    records[0].event.pressed   = true;
+    records[1].event.key       = (keypos_t){.col = 9, .row = 3};
+    records[1].tap.count       = 2;
+    records[2].event.key       = (keypos_t){.col = 4, .row = 1};
+    records[2].event.pressed   = true;
+    records[2].tap.count       = 1;
+    records[2].tap.interrupted = true;
+    records[3].event.key       = (keypos_t){.col = 255, .row = 255};
+    records[3].event.pressed   = true;
+
+    for (auto &record : records) {
+        uint8_t     data[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+        keyrecord_t decoded;
+        uint8_t     size = dynamic_macro_encode_event(data, &record);
+        EXPECT_EQ(size, dynamic_macro_event_size(data[0]));
+        EXPECT_EQ(size, dynamic_macro_decode_event(data, &decoded));
+        EXPECT_EQ(decoded.event.key.row, record.event.key.row);
+        EXPECT_EQ(decoded.event.key.col, record.event.key.col);
+        EXPECT_EQ(decoded.event.pressed, record.event.pressed);
+        EXPECT_EQ(decoded.tap.count, record.tap.count);
+        EXPECT_EQ(decoded.tap.interrupted, record.tap.interrupted);
+    }
+
+    uint8_t data[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    EXPECT_EQ(dynamic_macro_encode_event(data, &records[0]), 2);
+    EXPECT_EQ(dynamic_macro_encode_event(data, &records[3]), 3);
+}
+
+TEST_F(DynamicMacro, PlaysBackOneEventPerScan) {
+    record(KEY_REC1, {{KEY_A}, {KEY_B}});
+
+    TestDriver driver;
+    InSequence s;
+    press_key(KEY_PLAY1);
+    run_one_scan_loop();
+    release_key(KEY_PLAY1);
+    uint32_t start = timer_read32();
+    // Starting the playback clears the keyboard
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(4);
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+}
+
+TEST_F(DynamicMacro, ScanningContinuesDuringPlayback) {
+    record(KEY_REC2, {{KEY_A}, {KEY_B}, {KEY_A}, {KEY_B}});
+
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(KEY_PLAY2);
+    EXPECT_TRUE(dynamic_macro_is_playing());
+
+    // A key pressed in the middle of the macro is reported along with it
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C))).Times(1);
+    press_key(KEY_C);
+    run_one_scan_loop();
+    release_key(KEY_C);
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+}
+
+TEST_F(DynamicMacro, KeysAndLayersChangedDuringPlaybackAreKept) {
+    record(KEY_REC1, {{KEY_A}, {KEY_B}, {KEY_A}, {KEY_B}});
+
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(KEY_PLAY1);
+    press_key(KEY_LSFT);
+    run_one_scan_loop();
+    tap_key(KEY_TG1);
+    EXPECT_TRUE(dynamic_macro_is_playing());
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Shift is still held and layer 1 still on
+    EXPECT_TRUE(layer_state_is(1));
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_1)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    tap_key(KEY_A);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(KEY_LSFT);
+    run_one_scan_loop();
+    tap_key(KEY_TG1);
+}
+
+TEST_F(DynamicMacro, KeysLeftPressedByTheMacroAreReleased) {
+    {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        tap_key(KEY_REC1);
+        press_key(KEY_A);
+        run_one_scan_loop();
+        // Trailing presses aren't recorded, A stays pressed until after B is released
+        tap_key(KEY_B);
+        tap_key(KEY_STOP);
+        release_key(KEY_A);
+        run_one_scan_loop();
+    }
+
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_key(KEY_PLAY1);
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+}
+
+TEST_F(DynamicMacro, CompactEncodingTriplesCapacity) {
+    // Make sure the other macro is empty, so macro 1 can use the whole buffer
+    record(KEY_REC2, {});
+
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    macro_full = false;
+    tap_key(KEY_REC1);
+    unsigned events = 0;
+    while (!macro_full && events < 16 * DYNAMIC_MACRO_SIZE) {
+        tap_key(KEY_A);
+        events += 2;
+    }
+    tap_key(KEY_STOP);
+    // The last tap didn't fit
+    events -= 2;
+
+    EXPECT_GE(events, 3 * DYNAMIC_MACRO_SIZE);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 2)), events * 2);
+}
+
+TEST_F(DynamicMacro, MacrosAreSavedToEeprom) {
+    record(KEY_REC1, {{KEY_C}});
+    record(KEY_REC2, {{KEY_B}, {KEY_A}});
+
+    uint8_t *data = (uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 6);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 2)), 4);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 4)), 8);
+
+    keyrecord_t record;
+    uint8_t     event[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    eeprom_read_block(event, data, 2);
+    dynamic_macro_decode_event(event, &record);
+    EXPECT_TRUE(record.event.pressed);
+    EXPECT_EQ(record.event.key.col, 2);
+
+    // Macro 2 is stored backwards from the end of the region
+    uint8_t *last = data + DYNAMIC_MACRO_BUFFER_SIZE - 1;
+    event[0]      = eeprom_read_byte(last);
+    event[1]      = eeprom_read_byte(last - 1);
+    dynamic_macro_decode_event(event, &record);
+    EXPECT_TRUE(record.event.pressed);
+    EXPECT_EQ(record.event.key.col, 1);
+}
+
+TEST_F(DynamicMacro, MacrosAreLoadedFromEeprom) {
+    record(KEY_REC1, {{KEY_A}});
+
+    // Replace macro 1 in EEPROM with a tap of C, as if it had been recorded before a power cycle
+    keyrecord_t record   = {};
+    uint8_t     data[4]  = {};
+    record.event.key     = (keypos_t){.col = 2, .row = 0};
+    record.event.pressed = true;
+    dynamic_macro_encode_event(data, &record);
+    record.event.pressed = false;
+    dynamic_macro_encode_event(data + 2, &record);
+    eeprom_update_block(data, (uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR + 6), sizeof(data));
+    dynamic_macro_init();
+
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_key(KEY_PLAY1);
+    idle_for(10);
+}
+
+TEST_F(DynamicMacro, EeconfigInitForgetsSavedMacros) {
+    record(KEY_REC1, {{KEY_A}});
+    eeconfig_init();
+    dynamic_macro_init();
+
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).Times(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(KEY_PLAY1);
+    idle_for(10);
+}
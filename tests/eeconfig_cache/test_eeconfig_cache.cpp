@@ -0,0 +1,116 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "eeconfig.h"
+#include "eeprom.h"
+#include "process_unicode_common.h"
+uint32_t eeprom_get_write_count(void);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+#define UC_MOD_KEY 4, 0
+
+class EeconfigCache : public TestFixture {
+   protected:
+    EeconfigCache() {
+        eeconfig_init();
+        eeconfig_flush();
+    }
+};
+
+TEST_F(EeconfigCache, BurstOfUpdatesIsWrittenOnce) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    uint32_t writes = eeprom_get_write_count();
+    for (uint32_t i = 1; i <= 100; i++) {
+        eeconfig_update_user(i);
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(eeprom_get_write_count(), writes);
+    EXPECT_EQ(eeconfig_read_user(), 100u);
+
+    idle_for(EECONFIG_WRITE_DELAY);
+    // Only the lowest byte of the user config changed
+    EXPECT_EQ(eeprom_get_write_count(), writes + 1);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_USER), 100u);
+}
+
+TEST_F(EeconfigCache, WritingKeepsPostponingTheCommit) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    uint32_t writes = eeprom_get_write_count();
+    for (uint8_t i = 1; i <= 10; i++) {
+        eeconfig_update_debug(i);
+        idle_for(EECONFIG_WRITE_DELAY - 10);
+    }
+    idle_for(10);
+    EXPECT_EQ(eeprom_get_write_count(), writes);
+    // EECONFIG_WRITE_DELAY ms after the last write
+    run_one_scan_loop();
+    EXPECT_EQ(eeprom_get_write_count(), writes + 1);
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_DEBUG), 10);
+}
+
+TEST_F(EeconfigCache, ReadsSeeWritesThatArentCommittedYet) {
+    eeconfig_update_default_layer(4);
+    eeconfig_update_kb(0x12345678);
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_DEFAULT_LAYER), 0);
+    EXPECT_EQ(eeconfig_read_default_layer(), 4);
+    EXPECT_EQ(eeconfig_read_kb(), 0x12345678u);
+}
+
+TEST_F(EeconfigCache, FlushCommitsEverything) {
+    eeconfig_update_debug(1);
+    eeconfig_update_kb(0x12345678);
+    eeconfig_update_user(0xCAFE);
+    eeconfig_flush();
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_DEBUG), 1);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_KEYBOARD), 0x12345678u);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_USER), 0xCAFEu);
+}
+
+TEST_F(EeconfigCache, ResetDropsPendingWrites) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    eeconfig_update_user(7);
+    eeconfig_init();
+    idle_for(EECONFIG_WRITE_DELAY);
+    EXPECT_EQ(eeconfig_read_user(), 0u);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_USER), 0u);
+}
+
+TEST_F(EeconfigCache, CyclingUnicodeModesWritesOnce) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    uint32_t writes = eeprom_get_write_count();
+    for (int i = 0; i < 4; i++) {
+        press_key(UC_MOD_KEY);
+        run_one_scan_loop();
+        release_key(UC_MOD_KEY);
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(eeprom_get_write_count(), writes);
+    EXPECT_EQ(eeconfig_read_byte(EECONFIG_UNICODEMODE), get_unicode_input_mode());
+
+    idle_for(EECONFIG_WRITE_DELAY);
+    EXPECT_EQ(eeprom_get_write_count(), writes + 1);
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_UNICODEMODE), get_unicode_input_mode());
+}
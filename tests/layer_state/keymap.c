@@ -0,0 +1,44 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_A, KC_B, KC_NO, KC_LSFT, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+           {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+           {MO(1), MO(2), KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+           {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}},
+    [1] = {{KC_1, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______}},
+    [2] = {{KC_2, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______}},
+    // Turned on with layers 1 and 2 by layer_state_set_user
+    [3] = {{KC_3, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______}},
+};
+
+uint16_t layer_state_set_user_calls = 0;
+
+layer_state_t layer_state_set_user(layer_state_t state) {
+    layer_state_set_user_calls++;
+    return update_tri_layer_state(state, 1, 2, 3);
+}
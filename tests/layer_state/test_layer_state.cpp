@@ -0,0 +1,96 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" uint16_t layer_state_set_user_calls;
+
+class LayerState : public TestFixture {
+   protected:
+    void SetUp() override {
+        layer_state_flush();
+        layer_state_set_user_calls = 0;
+    }
+};
+
+TEST_F(LayerState, ChangesInOnePassRunTheCallbackOnce) {
+    TestDriver driver;
+    layer_on(1);
+    layer_on(2);
+    layer_off(1);
+    // The state is set right away, but the callback and the report wait for the end of the pass
+    EXPECT_EQ(layer_state, 0b0100);
+    EXPECT_EQ(layer_state_set_user_calls, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(1);
+    keyboard_task();
+    EXPECT_EQ(layer_state, 0b0100);
+    EXPECT_EQ(layer_state_set_user_calls, 1);
+    keyboard_task();
+    EXPECT_EQ(layer_state_set_user_calls, 1);
+    layer_clear();
+}
+
+TEST_F(LayerState, KeysAreLookedUpInTheStateTheCallbackReturns) {
+    layer_on(1);
+    layer_on(2);
+    EXPECT_EQ(layer_state, 0b0110);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){.col = 0, .row = 0}), 3);
+    EXPECT_EQ(layer_state, 0b1110);
+    EXPECT_EQ(layer_state_set_user_calls, 1);
+    layer_clear();
+}
+
+TEST_F(LayerState, LayerChangesDontSendReports) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+
+    // Held keys stay in the report, which doesn't change
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press_key(0, 2);
+    run_one_scan_loop();
+    press_key(1, 2);
+    run_one_scan_loop();
+    EXPECT_EQ(layer_state, 0b1110);
+    EXPECT_EQ(layer_state_set_user_calls, 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_3)));
+    run_one_scan_loop();
+
+    release_key(0, 2);
+    release_key(1, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_EQ(layer_state, 0);
+    EXPECT_EQ(layer_state_set_user_calls, 4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
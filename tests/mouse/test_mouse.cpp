@@ -0,0 +1,164 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+#include "mouse_accumulator.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+#define KEY_MS_DOWN 1, 0
+#define KEY_MS_RIGHT 3, 0
+#define KEY_BTN1 4, 0
+#define KEY_MO1 5, 0
+
+class Mouse : public TestFixture {
+   protected:
+    std::vector<report_mouse_t> reports;
+
+    void record(TestDriver &driver) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t &report) { reports.push_back(report); }));
+    }
+
+    int total(int8_t report_mouse_t::*axis) {
+        int sum = 0;
+        for (auto &report : reports) {
+            sum += report.*axis;
+        }
+        return sum;
+    }
+
+    void move_pointer(int8_t x, int8_t y, uint8_t buttons = 0) {
+        report_mouse_t report = pointing_device_get_report();
+        report.x              = x;
+        report.y              = y;
+        report.buttons        = buttons;
+        pointing_device_set_report(report);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(Mouse, DiagonalMousekeysKeepSubUnitMotion) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+    press_key(KEY_MS_RIGHT);
+    press_key(KEY_MS_DOWN);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // A one unit diagonal step is 0.707 units on each axis, which used to be rounded up to a whole unit
+    record(driver);
+    idle_for(MOUSEKEY_DELAY + 1 + 100 * (MOUSEKEY_INTERVAL + 1));
+    EXPECT_NEAR(total(&report_mouse_t::x), 70.7, 1);
+    EXPECT_NEAR(total(&report_mouse_t::y), 70.7, 1);
+    EXPECT_LT(reports.size(), 100);
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+    release_key(KEY_MS_RIGHT);
+    release_key(KEY_MS_DOWN);
+    run_one_scan_loop();
+}
+
+TEST_F(Mouse, PointerMotionIsSentOncePerInterval) {
+    TestDriver driver;
+    idle_for(MOUSE_REPORT_INTERVAL);
+    record(driver);
+
+    // A sensor reporting every millisecond
+    for (int i = 0; i < 100; i++) {
+        move_pointer(3, -1);
+    }
+    idle_for(MOUSE_REPORT_INTERVAL);
+
+    EXPECT_EQ(reports.size(), 100 / MOUSE_REPORT_INTERVAL + 1);
+    EXPECT_EQ(total(&report_mouse_t::x), 300);
+    EXPECT_EQ(total(&report_mouse_t::y), -100);
+}
+
+TEST_F(Mouse, LargeMotionIsSplitAcrossReports) {
+    TestDriver driver;
+    idle_for(MOUSE_REPORT_INTERVAL);
+    record(driver);
+
+    move_pointer(127, 0);
+    move_pointer(127, -128);
+    move_pointer(127, 0);
+    idle_for(3 * MOUSE_REPORT_INTERVAL);
+
+    ASSERT_EQ(reports.size(), 3);
+    for (auto &report : reports) {
+        EXPECT_EQ(report.x, 127);
+    }
+    EXPECT_EQ(reports[0].y, 0);
+    EXPECT_EQ(reports[1].y, -127);
+    EXPECT_EQ(reports[2].y, -1);
+}
+
+TEST_F(Mouse, ButtonChangesAreSentStraightAway) {
+    TestDriver driver;
+    idle_for(MOUSE_REPORT_INTERVAL);
+    record(driver);
+
+    move_pointer(5, 0);
+    move_pointer(5, 0);
+    ASSERT_EQ(reports.size(), 1);
+
+    // The pending motion goes along with the button
+    move_pointer(0, 0, MOUSE_BTN1);
+    ASSERT_EQ(reports.size(), 2);
+    EXPECT_EQ(reports[1].buttons, MOUSE_BTN1);
+    EXPECT_EQ(reports[1].x, 5);
+
+    move_pointer(0, 0, 0);
+    idle_for(MOUSE_REPORT_INTERVAL);
+    ASSERT_EQ(reports.size(), 3);
+    EXPECT_EQ(reports[2].buttons, 0);
+}
+
+TEST_F(Mouse, LayerChangesOnlySendAMouseReportWhenAMouseKeyIsHeld) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(MOUSE_REPORT_INTERVAL);
+    record(driver);
+
+    press_key(KEY_MO1);
+    run_one_scan_loop();
+    release_key(KEY_MO1);
+    run_one_scan_loop();
+    EXPECT_EQ(reports.size(), 0);
+
+    press_key(KEY_BTN1);
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 1);
+    EXPECT_EQ(reports[0].buttons, MOUSE_BTN1);
+
+    // The layer change still releases the held button
+    press_key(KEY_MO1);
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 2);
+    EXPECT_EQ(reports[1].buttons, 0);
+
+    release_key(KEY_MO1);
+    release_key(KEY_BTN1);
+    run_one_scan_loop();
+    idle_for(MOUSE_REPORT_INTERVAL);
+}
@@ -0,0 +1,239 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_layer.h"
+#include "action_util.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using testing::_;
+using testing::Invoke;
+
+// A key of the keymap, and what kind of key it is
+struct Key {
+    uint8_t col;
+    uint8_t row;
+    bool    plain;     // the same keycode on every layer
+    bool    tap_hold;  // a mod tap, layer tap or one shot key, which can hold up the keys typed after it
+};
+
+// A switch changing, delay ms after the previous change
+struct Change {
+    uint32_t delay;
+    size_t   key;
+    bool     pressed;
+};
+
+// A report, and when it was sent
+struct TimedReport {
+    uint32_t          time;
+    report_keyboard_t report;
+};
+
+class RandomTyping : public TestFixture {
+   protected:
+    std::vector<Key>  keys;
+    std::set<uint8_t> keycodes;
+
+    RandomTyping() {
+        for (uint8_t col = 0; col < 10; col++) {
+            keys.push_back({col, 0, true, false});
+        }
+        for (uint8_t col = 0; col < 5; col++) {
+            keys.push_back({col, 1, false, true});
+            keys.push_back({col, 2, false, false});
+        }
+        // Everything that can end up in a report
+        for (uint8_t layer = 0; layer < 2; layer++) {
+            for (auto &key : keys) {
+                uint16_t keycode = keymap_key_to_keycode(layer, (keypos_t){.col = key.col, .row = key.row});
+                if (IS_KEY(keycode)) {
+                    keycodes.insert(keycode);
+                } else if ((keycode >= QK_LAYER_TAP && keycode <= QK_LAYER_TAP_MAX) || (keycode >= QK_MOD_TAP && keycode <= QK_MOD_TAP_MAX)) {
+                    keycodes.insert(keycode & 0xFF);
+                }
+            }
+        }
+    }
+
+    uint8_t keycode(const Key &key) { return keymap_key_to_keycode(0, (keypos_t){.col = key.col, .row = key.row}); }
+
+    // Presses and releases random keys, mostly quickly one after another, with at most four keys held at a time,
+    // and then releases the keys that are still held
+    std::vector<Change> random_stream(uint32_t seed, size_t length) {
+        std::mt19937                       rng(seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> fast(1, 40);
+        std::uniform_int_distribution<int> slow(40, 150);
+        std::uniform_int_distribution<int> pause(150, 400);
+        std::vector<bool>                  down(keys.size());
+        std::vector<Change>                stream;
+        int                                num_down = 0;
+        while (stream.size() < length) {
+            int      kind  = percent(rng);
+            uint32_t delay = kind < 60 ? fast(rng) : kind < 90 ? slow(rng) : pause(rng);
+            size_t   key   = rng() % keys.size();
+            if (!down[key] && num_down == 4) {
+                continue;
+            }
+            down[key] = !down[key];
+            num_down += down[key] ? 1 : -1;
+            stream.push_back({delay, key, down[key]});
+        }
+        for (size_t key = 0; key < keys.size(); key++) {
+            if (down[key]) {
+                stream.push_back({1, key, false});
+            }
+        }
+        return stream;
+    }
+
+    // Runs the stream through the keyboard, a scan every ms, and returns the reports sent
+    std::vector<TimedReport> run(const std::vector<Change> &stream, std::vector<uint32_t> &times) {
+        TestDriver               driver;
+        std::vector<TimedReport> reports;
+        uint32_t                 now = 0;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&reports, &now](report_keyboard_t &report) { reports.push_back({now, report}); }));
+
+        for (auto &change : stream) {
+            for (uint32_t i = 1; i < change.delay; i++, now++) {
+                run_one_scan_loop();
+            }
+            if (change.pressed) {
+                press_key(keys[change.key].col, keys[change.key].row);
+            } else {
+                release_key(keys[change.key].col, keys[change.key].row);
+            }
+            times.push_back(now);
+            run_one_scan_loop();
+            now++;
+        }
+        for (uint32_t i = 0; i < 2 * ONESHOT_TIMEOUT; i++, now++) {
+            run_one_scan_loop();
+        }
+        return reports;
+    }
+
+    static void print_histogram(const char *name, std::vector<uint32_t> latencies) {
+        const uint32_t bounds[] = {0, 1, 2, 5, 10, 20, 50, 100, 200, 500};
+        std::sort(latencies.begin(), latencies.end());
+        printf("\n%s: %zu presses", name, latencies.size());
+        if (latencies.empty()) {
+            printf("\n");
+            return;
+        }
+        printf(", latency p50 %u, p95 %u, max %u ms\n", latencies[latencies.size() / 2], latencies[latencies.size() * 95 / 100], latencies.back());
+        uint32_t low = 0;
+        for (auto high : bounds) {
+            size_t count = std::count_if(latencies.begin(), latencies.end(), [low, high](uint32_t l) { return l >= low && l <= high; });
+            printf("  %3u-%3u ms %6zu %s\n", low, high, count, std::string(count * 50 / latencies.size(), '#').c_str());
+            low = high + 1;
+        }
+        size_t count = std::count_if(latencies.begin(), latencies.end(), [low](uint32_t l) { return l >= low; });
+        printf("  %3u+    ms %6zu %s\n", low, count, std::string(count * 50 / latencies.size(), '#').c_str());
+    }
+};
+
+TEST_F(RandomTyping, RandomStreamsKeepReportsConsistent) {
+    std::vector<uint32_t> latencies;
+    std::vector<uint32_t> latencies_tap_hold_pending;
+
+    for (uint32_t seed = 1; seed <= 5; seed++) {
+        SCOPED_TRACE(testing::Message() << "seed " << seed);
+        std::vector<Change>      stream = random_stream(seed, 2000);
+        std::vector<uint32_t>    times;
+        std::vector<TimedReport> reports = run(stream, times);
+
+        // Every report only has keycodes from the keymap, each at most once, and only the mods the keymap has, and
+        // differs from the one before
+        std::map<uint8_t, std::deque<uint32_t>> went_down;
+        std::set<uint8_t>                       previous;
+        for (size_t r = 0; r < reports.size(); r++) {
+            const TimedReport &timed = reports[r];
+            if (r > 0) {
+                ASSERT_FALSE(timed.report == reports[r - 1].report) << "same report sent twice at " << timed.time;
+            }
+            std::set<uint8_t> current;
+            for (size_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                uint8_t code = timed.report.keys[i];
+                if (code) {
+                    ASSERT_TRUE(keycodes.count(code)) << "unexpected keycode " << (int)code << " at " << timed.time;
+                    ASSERT_TRUE(current.insert(code).second) << "keycode " << (int)code << " twice at " << timed.time;
+                    if (!previous.count(code)) {
+                        went_down[code].push_back(timed.time);
+                    }
+                }
+            }
+            ASSERT_EQ(timed.report.mods & ~(MOD_BIT(KC_LSFT) | MOD_BIT(KC_LCTL)), 0) << "at " << timed.time;
+            previous = current;
+        }
+
+        // Nothing is stuck once everything has been released
+        report_keyboard_t empty = {};
+        ASSERT_FALSE(reports.empty());
+        EXPECT_EQ(reports.back().report, empty);
+        EXPECT_EQ(layer_state, 0u);
+        EXPECT_EQ(get_mods(), 0);
+        EXPECT_EQ(get_oneshot_mods(), 0);
+
+        // Every press of a plain key is reported once, and when
+        std::vector<bool> down(keys.size());
+        uint32_t          tap_hold_changed = 0;
+        bool              tap_hold_seen    = false;
+        for (size_t i = 0; i < stream.size(); i++) {
+            const Key &key = keys[stream[i].key];
+            if (key.plain && stream[i].pressed) {
+                auto &queue = went_down[keycode(key)];
+                ASSERT_FALSE(queue.empty()) << "press of " << (int)keycode(key) << " at " << times[i] << " not reported";
+                ASSERT_GE(queue.front(), times[i]) << "press of " << (int)keycode(key) << " reported before it happened";
+                uint32_t latency = queue.front() - times[i];
+                queue.pop_front();
+
+                // A tap-hold key that's held, or was let go of within the tapping term, may still be undecided
+                bool tap_hold_pending = tap_hold_seen && times[i] - tap_hold_changed < TAPPING_TERM;
+                for (size_t k = 0; k < keys.size(); k++) {
+                    tap_hold_pending |= down[k] && keys[k].tap_hold;
+                }
+                if (tap_hold_pending) {
+                    latencies_tap_hold_pending.push_back(latency);
+                } else {
+                    // Nothing to wait for, so it's reported in the same scan
+                    EXPECT_EQ(latency, 0u) << "press of " << (int)keycode(key) << " at " << times[i];
+                    latencies.push_back(latency);
+                }
+            }
+            if (key.tap_hold) {
+                tap_hold_changed = times[i];
+                tap_hold_seen    = true;
+            }
+            down[stream[i].key] = stream[i].pressed;
+        }
+        for (auto &key : keys) {
+            if (key.plain) {
+                EXPECT_TRUE(went_down[keycode(key)].empty()) << "keycode " << (int)keycode(key) << " reported more often than pressed";
+            }
+        }
+    }
+
+    print_histogram("Plain keys", latencies);
+    print_histogram("Plain keys while a tap-hold key is pending", latencies_tap_hold_pending);
+}
@@ -0,0 +1,121 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+#include <vector>
+
+using testing::_;
+using testing::Invoke;
+
+#define MASTER_MT 0, 0
+#define MASTER_A 1, 0
+#define SLAVE_MT 0, 2
+#define SLAVE_B 1, 2
+
+static bool     use_row_times = true;
+static uint16_t row_times[MATRIX_ROWS];
+
+// Like split_common/matrix.c, the slave rows report when they were scanned on the slave
+extern "C" uint16_t matrix_get_row_time(uint8_t row) {
+    if (use_row_times && row >= MATRIX_ROWS / 2) {
+        return row_times[row];
+    }
+    return timer_read();
+}
+
+// A switch change, happening at time and reaching the master delay ms later
+struct Change {
+    uint32_t time;
+    uint8_t  col;
+    uint8_t  row;
+    bool     pressed;
+    uint32_t delay;
+};
+
+class SplitRowTime : public TestFixture {
+   protected:
+    ~SplitRowTime() { use_row_times = true; }
+
+    // Runs the changes through the keyboard, with the slave half's changes arriving late
+    std::vector<report_keyboard_t> run(const std::vector<Change> &changes, bool split) {
+        TestDriver                     driver;
+        std::vector<report_keyboard_t> reports;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&reports](report_keyboard_t &report) { reports.push_back(report); }));
+
+        uint16_t start = timer_read();
+        for (uint32_t t = 0; t < 400; t++) {
+            for (auto &change : changes) {
+                if (change.time + (split ? change.delay : 0) == t) {
+                    if (change.pressed) {
+                        press_key(change.col, change.row);
+                    } else {
+                        release_key(change.col, change.row);
+                    }
+                    row_times[change.row] = start + change.time;
+                }
+            }
+            run_one_scan_loop();
+        }
+        return reports;
+    }
+};
+
+TEST_F(SplitRowTime, SlaveHoldIsDecidedLikeOnASingleBoard) {
+    // The press takes longer to reach the master than the release, so the key is held for less than
+    // the tapping term on the master, but more on the slave.
+    std::vector<Change> changes = {
+        {0, SLAVE_MT, true, 10},
+        {TAPPING_TERM + 5, SLAVE_MT, false, 1},
+    };
+    std::vector<report_keyboard_t> single_board = run(changes, false);
+    EXPECT_EQ(run(changes, true), single_board);
+    ASSERT_FALSE(single_board.empty());
+    EXPECT_EQ(single_board[0].mods, MOD_BIT(KC_LSFT));
+}
+
+TEST_F(SplitRowTime, SlaveHoldWithoutRowTimesBecomesTap) {
+    // What the previous test checks for: using the time the change reached the master gets it wrong
+    std::vector<Change> changes = {
+        {0, SLAVE_MT, true, 10},
+        {TAPPING_TERM + 5, SLAVE_MT, false, 1},
+    };
+    std::vector<report_keyboard_t> single_board = run(changes, false);
+    use_row_times                               = false;
+    EXPECT_NE(run(changes, true), single_board);
+}
+
+TEST_F(SplitRowTime, SlaveTapIsDecidedLikeOnASingleBoard) {
+    std::vector<Change> changes = {
+        {0, SLAVE_MT, true, 1},
+        {TAPPING_TERM - 20, SLAVE_MT, false, 15},
+    };
+    EXPECT_EQ(run(changes, true), run(changes, false));
+}
+
+TEST_F(SplitRowTime, SlaveEventsDontGoBackInTime) {
+    // The slave key was pressed before the master one, but arrives after it. Its time must not be before the
+    // master key's, or the master key would look like it had been held for almost 65 seconds.
+    std::vector<Change> changes = {
+        {100, SLAVE_B, true, 10},
+        {105, MASTER_MT, true, 0},
+        {150, SLAVE_B, false, 10},
+        {170, MASTER_MT, false, 0},
+    };
+    for (auto &report : run(changes, true)) {
+        EXPECT_EQ(report.mods, 0);
+    }
+}
@@ -0,0 +1,118 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+void    virtser_clear_transfers(void);
+uint8_t virtser_get_transfer_count(void);
+uint8_t virtser_get_transfer(uint8_t index, const uint8_t **data);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+#define S_KEY 0, 0
+#define T_KEY 1, 0
+#define A_KEY 2, 0
+#define Z_KEY 4, 0
+#define BOLT_KEY 5, 0
+#define GEMINI_KEY 6, 0
+
+class Steno : public TestFixture {
+   protected:
+    void tap(uint8_t col, uint8_t row) {
+        press_key(col, row);
+        run_one_scan_loop();
+        release_key(col, row);
+        run_one_scan_loop();
+    }
+
+    void set_mode(uint8_t col, uint8_t row) {
+        tap(col, row);
+        virtser_clear_transfers();
+    }
+
+    // Presses the keys one scan apart, and releases them the same way
+    void chord(std::vector<std::pair<uint8_t, uint8_t>> keys) {
+        for (auto& key : keys) {
+            press_key(key.first, key.second);
+            run_one_scan_loop();
+        }
+        for (auto& key : keys) {
+            release_key(key.first, key.second);
+            run_one_scan_loop();
+        }
+    }
+
+    static std::vector<std::vector<uint8_t>> transfers() {
+        std::vector<std::vector<uint8_t>> result;
+        for (uint8_t i = 0; i < virtser_get_transfer_count(); i++) {
+            const uint8_t* data;
+            uint8_t        length = virtser_get_transfer(i, &data);
+            result.emplace_back(data, data + length);
+        }
+        return result;
+    }
+};
+
+TEST_F(Steno, BoltChordIsOneTransfer) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    set_mode(BOLT_KEY);
+    chord({{S_KEY}, {T_KEY}, {A_KEY}});
+    // The nonzero groups of the chord and the terminating 0
+    std::vector<std::vector<uint8_t>> expected = {{0x03, 0x42, 0x00}};
+    EXPECT_EQ(transfers(), expected);
+}
+
+TEST_F(Steno, BoltSkipsEmptyGroups) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    set_mode(BOLT_KEY);
+    chord({{Z_KEY}});
+    chord({{S_KEY}});
+    std::vector<std::vector<uint8_t>> expected = {{0xC8, 0x00}, {0x01, 0x00}};
+    EXPECT_EQ(transfers(), expected);
+}
+
+TEST_F(Steno, GeminiChordIsOneTransfer) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    set_mode(GEMINI_KEY);
+    chord({{S_KEY}, {T_KEY}, {A_KEY}});
+    chord({{Z_KEY}});
+    // Always all six bytes, with the top bit of the first one marking the start
+    std::vector<std::vector<uint8_t>> expected = {{0x80, 0x50, 0x20, 0x00, 0x00, 0x00}, {0x80, 0x00, 0x00, 0x00, 0x00, 0x01}};
+    EXPECT_EQ(transfers(), expected);
+}
+
+TEST_F(Steno, NothingIsSentUntilAllKeysAreReleased) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    set_mode(GEMINI_KEY);
+    press_key(S_KEY);
+    run_one_scan_loop();
+    press_key(T_KEY);
+    run_one_scan_loop();
+    release_key(S_KEY);
+    idle_for(5);
+    EXPECT_EQ(virtser_get_transfer_count(), 0);
+    release_key(T_KEY);
+    run_one_scan_loop();
+    EXPECT_EQ(virtser_get_transfer_count(), 1);
+}
@@ -0,0 +1,149 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+#include <algorithm>
+#include <vector>
+
+using testing::_;
+using testing::Invoke;
+
+#define MOD_TAP 0, 0
+
+// A key going down in a report, and the mods it went down with
+struct Press {
+    uint8_t keycode;
+    uint8_t mods;
+};
+
+class TappingBuffer : public TestFixture {
+   protected:
+    // Position and keycode of the nth letter key
+    static uint8_t col(int n) { return (n + 1) % MATRIX_COLS; }
+    static uint8_t row(int n) { return (n + 1) / MATRIX_COLS; }
+    static uint8_t keycode(int n) { return keymap_key_to_keycode(0, (keypos_t){.col = col(n), .row = row(n)}); }
+
+    // Taps count letter keys one after another, a scan apart, with the mod tap key held from before the
+    // first one to after the last one
+    std::vector<report_keyboard_t> type_burst(int count) {
+        TestDriver                     driver;
+        std::vector<report_keyboard_t> reports;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&reports](report_keyboard_t &report) { reports.push_back(report); }));
+
+        press_key(MOD_TAP);
+        run_one_scan_loop();
+        for (int i = 0; i < count; i++) {
+            press_key(col(i), row(i));
+            run_one_scan_loop();
+            release_key(col(i), row(i));
+            run_one_scan_loop();
+        }
+        release_key(MOD_TAP);
+        run_one_scan_loop();
+        idle_for(TAPPING_TERM * 2);
+        return reports;
+    }
+
+    // The keys that went down, in order
+    static std::vector<Press> presses(const std::vector<report_keyboard_t> &reports) {
+        std::vector<Press>   result;
+        std::vector<uint8_t> down;
+        for (auto &report : reports) {
+            std::vector<uint8_t> keys;
+            for (size_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                if (report.keys[i]) {
+                    keys.push_back(report.keys[i]);
+                    if (std::find(down.begin(), down.end(), report.keys[i]) == down.end()) {
+                        result.push_back({report.keys[i], report.mods});
+                    }
+                }
+            }
+            down = keys;
+        }
+        return result;
+    }
+};
+
+TEST_F(TappingBuffer, BurstThatFitsKeepsModTapUndecided) {
+    // Few enough keys to wait in the buffer, so releasing the mod tap key within the tapping term taps it
+    const int          count   = (WAITING_BUFFER_SIZE - 2) / 2;
+    std::vector<Press> pressed = presses(type_burst(count));
+    ASSERT_EQ(pressed.size(), (size_t)count + 1);
+    EXPECT_EQ(pressed[0].keycode, KC_P);
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(pressed[i + 1].keycode, keycode(i));
+        EXPECT_EQ(pressed[i + 1].mods, 0);
+    }
+}
+
+TEST_F(TappingBuffer, LongBurstUnderHeldModTapLosesNoKeys) {
+    // Thirty keys don't fit in the buffer, so the mod tap key is resolved as held, and every key still gets typed
+    const int                      count   = 30;
+    std::vector<report_keyboard_t> reports = type_burst(count);
+    std::vector<Press>             pressed = presses(reports);
+    ASSERT_EQ(pressed.size(), (size_t)count);
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(pressed[i].keycode, keycode(i)) << "key " << i;
+        EXPECT_EQ(pressed[i].mods, MOD_BIT(KC_LSFT)) << "key " << i;
+    }
+    report_keyboard_t empty = {};
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back(), empty);
+}
+
+TEST_F(TappingBuffer, RepeatedBurstsLoseNoKeys) {
+    for (int burst = 0; burst < 3; burst++) {
+        std::vector<Press> pressed = presses(type_burst(30));
+        EXPECT_EQ(pressed.size(), 30u) << "burst " << burst;
+    }
+}
+
+TEST_F(TappingBuffer, ModTapReleasedIntoFullBufferIsTapped) {
+    // The release of the mod tap key is the event that doesn't fit, after the tap has already been decided
+    const int                      count = (WAITING_BUFFER_SIZE - 2) / 2;
+    TestDriver                     driver;
+    std::vector<report_keyboard_t> reports;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&reports](report_keyboard_t &report) { reports.push_back(report); }));
+
+    press_key(MOD_TAP);
+    run_one_scan_loop();
+    for (int i = 0; i < count; i++) {
+        press_key(col(i), row(i));
+        run_one_scan_loop();
+        release_key(col(i), row(i));
+        run_one_scan_loop();
+    }
+    press_key(col(count), row(count));
+    run_one_scan_loop();
+    release_key(MOD_TAP);
+    run_one_scan_loop();
+    release_key(col(count), row(count));
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM * 2);
+
+    std::vector<Press> pressed = presses(reports);
+    ASSERT_EQ(pressed.size(), (size_t)count + 2);
+    EXPECT_EQ(pressed[0].keycode, KC_P);
+    for (int i = 0; i <= count; i++) {
+        EXPECT_EQ(pressed[i + 1].keycode, keycode(i)) << "key " << i;
+        EXPECT_EQ(pressed[i + 1].mods, 0) << "key " << i;
+    }
+    report_keyboard_t empty = {};
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back(), empty);
+}
@@ -0,0 +1,38 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_A, KC_B, KC_NO, KC_NO, KC_NO, KC_NO, CTL_T(KC_Q), SFT_T(KC_P), LT(1, KC_O), KC_NO},
+           {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+           {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+           {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}},
+    [1] = {{KC_1, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+           {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______}},
+};
+
+// Layer tap keys are left out of typing streaks
+uint16_t get_tapping_streak_term(uint16_t keycode, keyrecord_t *record) {
+    switch (keycode) {
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            return 0;
+        default:
+            return TAPPING_STREAK_TERM;
+    }
+}
@@ -0,0 +1,184 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include "test_common.hpp"
+
+extern "C" {
+#include "print.h"
+#include "task_profiler.h"
+extern uint32_t housekeeping_ticks;
+extern uint32_t keypress_ticks;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+static std::string console;
+
+static int8_t capture(uint8_t c) {
+    console += (char)c;
+    return 0;
+}
+
+class TaskProfiler : public TestFixture {
+   protected:
+    TaskProfiler() {
+        housekeeping_ticks = 0;
+        keypress_ticks     = 0;
+        debug_enable       = false;
+        task_profiler_reset_all();
+        console.clear();
+        print_set_sendchar(capture);
+    }
+
+    static task_profiler_summary_t get(task_profiler_stage_t stage) {
+        task_profiler_summary_t summary;
+        EXPECT_TRUE(task_profiler_get(stage, &summary));
+        return summary;
+    }
+};
+
+TEST_F(TaskProfiler, EachStageIsTimedSeparately) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    housekeeping_ticks = 300;
+    idle_for(100);
+
+    auto housekeeping = get(TASK_PROFILER_HOUSEKEEPING);
+    EXPECT_EQ(housekeeping.count, 100);
+    EXPECT_EQ(housekeeping.min, 300u);
+    EXPECT_EQ(housekeeping.avg, 300u);
+    EXPECT_EQ(housekeeping.max, 300u);
+    EXPECT_EQ(housekeeping.p99, 300u);
+
+    auto matrix_scan = get(TASK_PROFILER_MATRIX_SCAN);
+    EXPECT_EQ(matrix_scan.count, 100);
+    EXPECT_EQ(matrix_scan.max, 0u);
+
+    auto total = get(TASK_PROFILER_TOTAL);
+    EXPECT_EQ(total.count, 100);
+    EXPECT_EQ(total.avg, 300u);
+
+    // Not built into this keyboard
+    EXPECT_EQ(get(TASK_PROFILER_RGBLIGHT).count, 0);
+}
+
+TEST_F(TaskProfiler, KeypressesAreTimedAsActionExec) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keypress_ticks = 2000;
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    idle_for(9);
+
+    auto action_exec = get(TASK_PROFILER_ACTION_EXEC);
+    EXPECT_EQ(action_exec.count, 10);
+    EXPECT_EQ(action_exec.min, 0u);
+    EXPECT_EQ(action_exec.max, 2000u);
+    EXPECT_EQ(action_exec.avg, 200u);
+    EXPECT_EQ(get(TASK_PROFILER_HOUSEKEEPING).max, 0u);
+}
+
+TEST_F(TaskProfiler, PercentilesComeFromTheHistogram) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    housekeeping_ticks = 100;
+    idle_for(90);
+    housekeeping_ticks = 3000;
+    idle_for(10);
+
+    auto housekeeping = get(TASK_PROFILER_HOUSEKEEPING);
+    EXPECT_EQ(housekeeping.avg, 390u);
+    // Within the bucket of 64 to 127 ticks
+    EXPECT_GE(housekeeping.p50, 100u);
+    EXPECT_LT(housekeeping.p50, 128u);
+    EXPECT_GE(housekeeping.p90, 100u);
+    EXPECT_LT(housekeeping.p90, 128u);
+    EXPECT_EQ(housekeeping.p99, 3000u);
+}
+
+TEST_F(TaskProfiler, CountersAreHalvedInsteadOfOverflowing) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    housekeeping_ticks = 10;
+    idle_for(70000);
+
+    auto housekeeping = get(TASK_PROFILER_HOUSEKEEPING);
+    EXPECT_GT(housekeeping.count, 30000);
+    EXPECT_EQ(housekeeping.avg, 10u);
+    EXPECT_EQ(housekeeping.p50, 10u);
+
+    // The total overflows before the count does, and the histogram follows the recent loops
+    housekeeping_ticks = 1000000;
+    idle_for(5000);
+    housekeeping = get(TASK_PROFILER_HOUSEKEEPING);
+    EXPECT_GT(housekeeping.avg, 10u);
+    EXPECT_LT(housekeeping.avg, 1000000u);
+    EXPECT_EQ(housekeeping.max, 1000000u);
+    EXPECT_EQ(housekeeping.p50, 1000000u);
+}
+
+TEST_F(TaskProfiler, RawHidReportsAStageInMicroseconds) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    housekeeping_ticks = 0x123456;
+    idle_for(2);
+
+    uint8_t data[32] = {TASK_PROFILER_RAW_HID_ID, TASK_PROFILER_HOUSEKEEPING, TASK_PROFILER_RESET};
+    EXPECT_TRUE(task_profiler_raw_hid(data, sizeof(data)));
+    uint8_t expected[30] = {TASK_PROFILER_RAW_HID_ID, TASK_PROFILER_HOUSEKEEPING, TASK_PROFILER_RESET, TASK_PROFILER_STAGES, 0, 2};
+    for (int i = 6; i < 30; i += 4) {
+        expected[i + 1] = 0x12;
+        expected[i + 2] = 0x34;
+        expected[i + 3] = 0x56;
+    }
+    EXPECT_EQ(std::vector<uint8_t>(data, data + 30), std::vector<uint8_t>(expected, expected + 30));
+    EXPECT_EQ(get(TASK_PROFILER_HOUSEKEEPING).count, 0);
+    EXPECT_EQ(get(TASK_PROFILER_TOTAL).count, 2);
+
+    uint8_t unknown[32] = {TASK_PROFILER_RAW_HID_ID, TASK_PROFILER_STAGES};
+    EXPECT_TRUE(task_profiler_raw_hid(unknown, sizeof(unknown)));
+    EXPECT_EQ(std::vector<uint8_t>(unknown + 4, unknown + 32), std::vector<uint8_t>(28, 0));
+
+    uint8_t other[32] = {0x01};
+    EXPECT_FALSE(task_profiler_raw_hid(other, sizeof(other)));
+}
+
+TEST_F(TaskProfiler, PrintShowsTheStagesThatRan) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    housekeeping_ticks = 300;
+    idle_for(10);
+    task_profiler_print();
+    EXPECT_NE(console.find("housekeeping\t10\t300\t300\t300\t300\t300\t300\n"), std::string::npos) << console;
+    EXPECT_NE(console.find("\ntotal\t10\t"), std::string::npos) << console;
+    EXPECT_EQ(console.find("rgblight"), std::string::npos) << console;
+}
+
+TEST_F(TaskProfiler, PrintsPeriodicallyInDebugMode) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(TASK_PROFILER_PRINT_INTERVAL * 2);
+    EXPECT_EQ(console, "");
+    debug_enable = true;
+    idle_for(TASK_PROFILER_PRINT_INTERVAL * 2);
+    debug_enable = false;
+    size_t first = console.find("task profiler");
+    EXPECT_NE(first, std::string::npos);
+    EXPECT_NE(console.find("task profiler", first + 1), std::string::npos) << console;
+}
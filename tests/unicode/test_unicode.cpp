@@ -0,0 +1,139 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+#define SNOW_KEY 0, 0
+#define E_ACUTE_KEY 1, 0
+
+#define AT_TIME(t) WillOnce(InvokeWithoutArgs([this]() { EXPECT_EQ(timer_elapsed32(start), t); }))
+
+class Unicode : public TestFixture {
+   protected:
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start;
+
+    void SetUp() override { start = timer_read32(); }
+
+    // The reports of tapping a key while the given modifier is held
+    void expect_tap(uint8_t keycode, uint8_t mod = KC_NO) {
+        if (mod == KC_NO) {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(keycode)));
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        } else {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(mod, keycode)));
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(mod)));
+        }
+    }
+
+    void expect_hex(const char *digits, uint8_t mod = KC_NO) {
+        for (; *digits; digits++) {
+            uint8_t keycode = *digits == '0' ? KC_0 : *digits <= '9' ? KC_1 + *digits - '1' : KC_A + *digits - 'a';
+            expect_tap(keycode, mod);
+        }
+    }
+};
+
+TEST_F(Unicode, Linux) {
+    set_unicode_input_mode(UC_LNX);
+    driver.set_leds(1 << USB_LED_CAPS_LOCK);
+
+    // Each character is typed in its own input session, with Caps Lock turned off around it
+    for (const char *hex : {"00e9", "2603", "1f600"}) {
+        expect_tap(KC_CAPS);
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_LSFT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_LSFT, KC_U)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_LSFT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        expect_hex(hex);
+        expect_tap(KC_SPC);
+        expect_tap(KC_CAPS);
+    }
+    send_unicode_string("é☃😀");
+
+    driver.set_leds(0);
+}
+
+TEST_F(Unicode, Mac) {
+    set_unicode_input_mode(UC_MAC);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    register_code(KC_LSFT);
+
+    // Option is held across the whole string, and Shift only comes back with the next report after it
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT))).AT_TIME(0);
+    expect_hex("00e9", KC_LALT);
+    expect_hex("d83dde00", KC_LALT);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(10);
+    send_unicode_string("é😀");
+
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    unregister_code(KC_LSFT);
+}
+
+TEST_F(Unicode, Windows) {
+    set_unicode_input_mode(UC_WIN);
+
+    // Code points beyond the Basic Multilingual Plane can't be typed, and are skipped
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    expect_tap(KC_PPLS, KC_LALT);
+    expect_hex("2603", KC_LALT);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    send_unicode_string("😀☃");
+}
+
+TEST_F(Unicode, WinCompose) {
+    set_unicode_input_mode(UC_WINC);
+
+    for (const char *hex : {"00e9", "1f600"}) {
+        expect_tap(KC_RALT);
+        expect_tap(KC_U);
+        expect_hex(hex);
+        expect_tap(KC_ENTER);
+    }
+    send_unicode_string("é😀");
+}
+
+TEST_F(Unicode, UnicodemapKeys) {
+    set_unicode_input_mode(UC_WINC);
+
+    expect_tap(KC_RALT);
+    expect_tap(KC_U);
+    expect_hex("2603");
+    expect_tap(KC_ENTER);
+    press_key(SNOW_KEY);
+    run_one_scan_loop();
+    release_key(SNOW_KEY);
+    run_one_scan_loop();
+
+    // Shift picks the second code point of the pair, and is held again afterwards
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    register_code(KC_LSFT);
+    expect_tap(KC_RALT);
+    expect_tap(KC_U);
+    expect_hex("00c9");
+    expect_tap(KC_ENTER);
+    press_key(E_ACUTE_KEY);
+    run_one_scan_loop();
+    release_key(E_ACUTE_KEY);
+    run_one_scan_loop();
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    unregister_code(KC_LSFT);
+}
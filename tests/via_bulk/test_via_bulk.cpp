@@ -0,0 +1,293 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+#include <vector>
+
+extern "C" {
+#include "via.h"
+#include "raw_hid.h"
+#include "dynamic_keymap.h"
+#include "task_profiler.h"
+}
+
+#define PACKET_SIZE 32
+#define CHUNK_SIZE (PACKET_SIZE - 4)
+
+static std::vector<uint8_t> reply;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) { reply.assign(data, data + length); }
+
+class ViaBulk : public TestFixture {
+   protected:
+    unsigned packets = 0;
+
+    ViaBulk() {
+        dynamic_keymap_reset();
+        dynamic_keymap_macro_reset();
+    }
+
+    std::vector<uint8_t> command(std::vector<uint8_t> packet) {
+        packet.resize(PACKET_SIZE);
+        raw_hid_receive(packet.data(), packet.size());
+        packets++;
+        return reply;
+    }
+
+    std::vector<uint8_t> data(uint8_t sequence, const std::vector<uint8_t> &chunk) {
+        std::vector<uint8_t> packet = {id_bulk_transfer_data, sequence, 0, (uint8_t)chunk.size()};
+        packet.insert(packet.end(), chunk.begin(), chunk.end());
+        return command(packet);
+    }
+
+    static std::vector<uint16_t> keymap_words() {
+        std::vector<uint8_t> buffer(dynamic_keymap_get_buffer_size());
+        dynamic_keymap_get_buffer(0, buffer.size(), buffer.data());
+        std::vector<uint16_t> words;
+        for (size_t i = 0; i < buffer.size(); i += 2) {
+            words.push_back((buffer[i] << 8) | buffer[i + 1]);
+        }
+        return words;
+    }
+
+    // Compresses words the way a host would, skipping the ones that are the same as in current,
+    // into chunks that don't split tokens
+    static std::vector<std::vector<uint8_t>> compress(const std::vector<uint16_t> &words, const std::vector<uint16_t> &current) {
+        std::vector<std::vector<uint8_t>> chunks(1);
+        auto                              add = [&chunks](const std::vector<uint8_t> &token) {
+            if (chunks.back().size() + token.size() > CHUNK_SIZE) {
+                chunks.emplace_back();
+            }
+            chunks.back().insert(chunks.back().end(), token.begin(), token.end());
+        };
+        size_t i = 0;
+        while (i < words.size()) {
+            size_t run = 1;
+            while (run < 64 && i + run < words.size() && words[i + run] == current[i + run] && words[i] == current[i]) {
+                run++;
+            }
+            if (words[i] == current[i]) {
+                add({(uint8_t)(0x80 | (run - 1))});
+                i += run;
+                continue;
+            }
+            run = 1;
+            while (run < 64 && i + run < words.size() && words[i + run] == words[i]) {
+                run++;
+            }
+            if (run > 1) {
+                add({(uint8_t)(0x40 | (run - 1)), (uint8_t)(words[i] >> 8), (uint8_t)(words[i] & 0xFF)});
+                i += run;
+                continue;
+            }
+            std::vector<uint8_t> token = {0};
+            while (token.size() < 1 + 2 * 8 && i < words.size() && words[i] != current[i] && (i + 1 == words.size() || words[i + 1] != words[i])) {
+                token.push_back(words[i] >> 8);
+                token.push_back(words[i] & 0xFF);
+                i++;
+            }
+            token[0] = (token.size() - 1) / 2 - 1;
+            add(token);
+        }
+        return chunks;
+    }
+
+    // Writes words to the keymap with a bulk transfer
+    void write_keymap(const std::vector<uint16_t> &words) {
+        EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 1})[3], id_bulk_ok);
+        auto    chunks   = compress(words, keymap_words());
+        uint8_t sequence = 0;
+        for (auto &chunk : chunks) {
+            EXPECT_EQ(data(sequence++, chunk)[2], id_bulk_ok);
+        }
+        EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+    }
+
+    // Reads the keymap with a bulk transfer, and decompresses it
+    std::vector<uint16_t> read_keymap() {
+        std::vector<uint8_t> begin = command({id_bulk_transfer_begin, id_bulk_region_keymap, 0});
+        EXPECT_EQ(begin[3], id_bulk_ok);
+        EXPECT_EQ((begin[4] << 8) | begin[5], dynamic_keymap_get_buffer_size());
+
+        std::vector<uint16_t> words;
+        for (uint8_t sequence = 0;; sequence++) {
+            std::vector<uint8_t> packet = data(sequence, {});
+            EXPECT_EQ(packet[2], id_bulk_ok);
+            uint8_t length = packet[3];
+            if (length == 0) {
+                break;
+            }
+            EXPECT_LE(length, CHUNK_SIZE);
+            const uint8_t *chunk = &packet[4];
+            for (uint8_t i = 0; i < length;) {
+                uint8_t token = chunk[i++];
+                uint8_t count = (token & 0x3F) + 1;
+                if ((token & 0xC0) == 0x40) {
+                    words.insert(words.end(), count, (chunk[i] << 8) | chunk[i + 1]);
+                    i += 2;
+                } else {
+                    EXPECT_EQ(token & 0xC0, 0x00);
+                    for (uint8_t k = 0; k < count; k++, i += 2) {
+                        words.push_back((chunk[i] << 8) | chunk[i + 1]);
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+        return words;
+    }
+};
+
+TEST_F(ViaBulk, ReadsKeymapInFewerPacketsThanGetBuffer) {
+    std::vector<uint16_t> expected = keymap_words();
+    packets                        = 0;
+    EXPECT_EQ(read_keymap(), expected);
+    // 28 bytes at a time with id_dynamic_keymap_get_buffer, where the base layer alone takes three
+    unsigned get_buffer_packets = (dynamic_keymap_get_buffer_size() + 27) / 28;
+    EXPECT_LT(packets, get_buffer_packets);
+}
+
+TEST_F(ViaBulk, WritesKeymap) {
+    std::vector<uint16_t> words = keymap_words();
+    const size_t          layer = MATRIX_ROWS * MATRIX_COLS;
+    // Swap two keys on the base layer, clear layer 3, and put a few keys on layer 2
+    std::swap(words[0], words[1]);
+    std::fill(words.begin() + 3 * layer, words.end(), KC_NO);
+    words[2 * layer + 5]  = KC_MUTE;
+    words[2 * layer + 6]  = KC_VOLD;
+    words[2 * layer + 7]  = KC_VOLU;
+    words[2 * layer + 12] = KC_VOLU;
+    words[2 * layer + 13] = KC_VOLU;
+
+    packets = 0;
+    write_keymap(words);
+    EXPECT_EQ(keymap_words(), words);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(2, 0, 5), KC_MUTE);
+    EXPECT_EQ(dynamic_keymap_get_keycode(3, 3, 9), KC_NO);
+    unsigned set_buffer_packets = (dynamic_keymap_get_buffer_size() + 27) / 28;
+    EXPECT_LT(packets, set_buffer_packets / 2);
+
+    // And reading it back gives the same
+    EXPECT_EQ(read_keymap(), words);
+}
+
+TEST_F(ViaBulk, WritesAreDeferredUntilTheEnd) {
+    std::vector<uint16_t> before = keymap_words();
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 1})[3], id_bulk_ok);
+    EXPECT_EQ(data(0, {0x43, 0x00, KC_X})[2], id_bulk_ok);
+    EXPECT_EQ(keymap_words(), before);
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+    for (uint8_t col = 0; col < 4; col++) {
+        EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, col), KC_X);
+    }
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 4), KC_E);
+}
+
+TEST_F(ViaBulk, SkippedWordsAreLeftAlone) {
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 1})[3], id_bulk_ok);
+    EXPECT_EQ(data(0, {0x81, 0x00, 0x00, KC_X, 0x80, 0x00, 0x00, KC_Y})[2], id_bulk_ok);
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_A);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 2), KC_X);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 3), KC_D);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 4), KC_Y);
+}
+
+TEST_F(ViaBulk, RepeatedChunkIsOnlyWrittenOnce) {
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 1})[3], id_bulk_ok);
+    EXPECT_EQ(data(0, {0x00, 0x00, KC_X})[2], id_bulk_ok);
+    // The reply was lost, so the host sends it again
+    EXPECT_EQ(data(0, {0x00, 0x00, KC_X})[2], id_bulk_ok);
+    EXPECT_EQ(data(1, {0x00, 0x00, KC_Y})[2], id_bulk_ok);
+    EXPECT_EQ(data(3, {0x00, 0x00, KC_Z})[2], id_bulk_error_sequence);
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_X);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), KC_Y);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 2), KC_C);
+}
+
+TEST_F(ViaBulk, RepeatedReadGivesTheSameChunk) {
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 0})[3], id_bulk_ok);
+    std::vector<uint8_t> first = data(0, {});
+    std::vector<uint8_t> again = data(0, {});
+    EXPECT_EQ(first, again);
+    std::vector<uint8_t> second = data(1, {});
+    EXPECT_NE(first, second);
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+}
+
+TEST_F(ViaBulk, BadChunksWriteNothing) {
+    std::vector<uint16_t> before = keymap_words();
+    uint16_t              words  = dynamic_keymap_get_buffer_size() / 2;
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 1})[3], id_bulk_ok);
+    // A reserved token after a good one
+    EXPECT_EQ(data(0, {0x00, 0x00, KC_X, 0xC0})[2], id_bulk_error_data);
+    // A literal that's cut short
+    EXPECT_EQ(data(0, {0x01, 0x00, KC_X})[2], id_bulk_error_data);
+    // Past the end of the keymap
+    std::vector<uint8_t> chunk;
+    for (uint16_t skipped = 0; skipped < words; skipped += 64) {
+        chunk.push_back(0x80 | 63);
+    }
+    chunk.insert(chunk.end(), {0x00, 0x00, KC_X});
+    EXPECT_EQ(data(0, chunk)[2], id_bulk_error_data);
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+    EXPECT_EQ(keymap_words(), before);
+}
+
+TEST_F(ViaBulk, NeedsASession) {
+    EXPECT_EQ(data(0, {0x00, 0x00, KC_X})[2], id_bulk_error_session);
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_error_session);
+    EXPECT_EQ(command({id_bulk_transfer_begin, 0x05, 0})[3], id_bulk_error_session);
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_keymap, 2})[3], id_bulk_error_session);
+    EXPECT_EQ(data(0, {0x00, 0x00, KC_X})[2], id_bulk_error_session);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_A);
+}
+
+TEST_F(ViaBulk, MacrosCantBeSentWhileWritten) {
+    uint16_t size = dynamic_keymap_macro_get_buffer_size();
+    EXPECT_EQ(command({id_bulk_transfer_begin, id_bulk_region_macro, 1})[3], id_bulk_ok);
+    uint8_t last;
+    dynamic_keymap_macro_get_buffer(size - 1, 1, &last);
+    EXPECT_NE(last, 0);
+
+    // "hi" and an empty second macro, and the rest cleared
+    std::vector<uint8_t> chunk = {0x01, 'h', 'i', 0x00, 0x00};
+    uint16_t             words = (size + 1) / 2 - 2;
+    uint8_t              sequence = 0;
+    EXPECT_EQ(data(sequence++, chunk)[2], id_bulk_ok);
+    for (; words > 0; words -= std::min<uint16_t>(words, 64)) {
+        EXPECT_EQ(data(sequence++, {(uint8_t)(0x40 | (std::min<uint16_t>(words, 64) - 1)), 0x00, 0x00})[2], id_bulk_ok);
+    }
+    EXPECT_EQ(command({id_bulk_transfer_end})[1], id_bulk_ok);
+
+    std::vector<uint8_t> buffer(size);
+    dynamic_keymap_macro_get_buffer(0, size, buffer.data());
+    EXPECT_EQ(buffer[0], 'h');
+    EXPECT_EQ(buffer[1], 'i');
+    EXPECT_EQ(buffer[2], 0);
+    EXPECT_EQ(buffer[size - 1], 0);
+}
+
+TEST_F(ViaBulk, TaskProfilerAnswersUnderItsOwnId) {
+    std::vector<uint8_t> profile = command({TASK_PROFILER_RAW_HID_ID, TASK_PROFILER_HOUSEKEEPING});
+    EXPECT_EQ(profile[0], TASK_PROFILER_RAW_HID_ID);
+    EXPECT_EQ(profile[3], TASK_PROFILER_STAGES);
+    EXPECT_EQ(command({0x17})[0], id_unhandled);
+}
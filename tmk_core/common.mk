@@ -103,6 +103,11 @@ ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     TMK_COMMON_DEFS += -DNO_SUSPEND_POWER_DOWN
 endif
 
+ifeq ($(strip $(TASK_PROFILER_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/task_profiler.c
+    TMK_COMMON_DEFS += -DTASK_PROFILER_ENABLE
+endif
+
 ifeq ($(strip $(NO_SUSPEND_POWER_DOWN)), yes)
     TMK_COMMON_DEFS += -DNO_SUSPEND_POWER_DOWN
 endif
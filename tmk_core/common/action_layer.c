@@ -92,22 +92,58 @@ __attribute__((weak)) layer_state_t layer_state_set_user(layer_state_t state) {
  */
 __attribute__((weak)) layer_state_t layer_state_set_kb(layer_state_t state) { return layer_state_set_user(state); }
 
+/** \brief Clear the keyboard after a layer change
+ */
+static void layer_state_clear_keyboard(void) {
+#    ifdef STRICT_LAYER_RELEASE
+    clear_keyboard_but_mods();  // To avoid stuck keys
+#    else
+    clear_keyboard_but_mods_and_keys();  // Don't reset held keys
+#    endif
+}
+
+#    ifdef LAYER_STATE_DEFER_CALLBACKS
+/** \brief Whether layer_state changed since the last layer_state_flush()
+ */
+static bool layer_state_pending = false;
+#    endif
+
 /** \brief Layer state set
  *
- * Sets the layer to match the specifed state (a bitmask)
+ * Sets the layer to match the specifed state (a bitmask). With LAYER_STATE_DEFER_CALLBACKS the new state is visible
+ * right away, but running the callbacks and clearing the keyboard are left to layer_state_flush(). That runs at the
+ * end of keyboard_task() and before every keymap lookup, so the changes made between two key events only do them once.
  */
 void layer_state_set(layer_state_t state) {
+#    ifndef LAYER_STATE_DEFER_CALLBACKS
     state = layer_state_set_kb(state);
+#    endif
     dprint("layer_state: ");
     layer_debug();
     dprint(" to ");
     layer_state = state;
     layer_debug();
     dprintln();
-#    ifdef STRICT_LAYER_RELEASE
-    clear_keyboard_but_mods();  // To avoid stuck keys
+#    ifdef LAYER_STATE_DEFER_CALLBACKS
+    layer_state_pending = true;
 #    else
-    clear_keyboard_but_mods_and_keys();  // Don't reset held keys
+    layer_state_clear_keyboard();
+#    endif
+}
+
+/** \brief Layer state flush
+ *
+ * Runs the callbacks on the layer state and clears the keyboard, if the state was set since the last flush. Without
+ * LAYER_STATE_DEFER_CALLBACKS layer_state_set() has already done both, and this does nothing.
+ */
+void layer_state_flush(void) {
+#    ifdef LAYER_STATE_DEFER_CALLBACKS
+    if (!layer_state_pending) {
+        return;
+    }
+    layer_state_pending = false;
+    layer_state         = layer_state_set_kb(layer_state);
+    layer_state_clear_keyboard();
 #    endif
 }
 
@@ -255,6 +291,9 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
+    // Keys are looked up in the state the callbacks return, if they were deferred. This flushes on every lookup, so
+    // only the changes made since the last key event are merged.
+    layer_state_flush();
     layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
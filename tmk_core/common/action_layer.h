@@ -72,6 +72,7 @@ void default_layer_xor(layer_state_t state);
 extern layer_state_t layer_state;
 
 void layer_state_set(layer_state_t state);
+void layer_state_flush(void);
 bool layer_state_is(uint8_t layer);
 bool layer_state_cmp(layer_state_t layer1, uint8_t layer2);
 
@@ -91,6 +92,7 @@ layer_state_t layer_state_set_kb(layer_state_t state);
 #    define layer_state 0
 
 #    define layer_state_set(layer)
+#    define layer_state_flush()
 #    define layer_state_is(layer) (layer == 0)
 #    define layer_state_cmp(state, layer) (state == 0 ? layer == 0 : (state & 1UL << layer) != 0)
 
@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
@@ -35,14 +36,50 @@ __attribute__((weak)) bool get_tapping_force_hold(uint16_t keycode, keyrecord_t
 __attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) { return false; }
 #    endif
 
-static keyrecord_t tapping_key                         = {};
-static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t     waiting_buffer_head                 = 0;
-static uint8_t     waiting_buffer_tail                 = 0;
+#    ifdef TAPPING_STREAK_TERM
+#        ifdef TAPPING_STREAK_TERM_PER_KEY
+__attribute__((weak)) uint16_t get_tapping_streak_term(uint16_t keycode, keyrecord_t *record) { return TAPPING_STREAK_TERM; }
+#            define WITHIN_TAPPING_STREAK_TERM(keyp) (TIMER_DIFF_16(keyp->event.time, last_press_time) < get_tapping_streak_term(get_event_keycode(keyp->event, false), keyp))
+#        else
+#            define WITHIN_TAPPING_STREAK_TERM(keyp) (TIMER_DIFF_16(keyp->event.time, last_press_time) < TAPPING_STREAK_TERM)
+#        endif
+#    endif
+
+/* A keyrecord_t without the padding, so that more of them fit in the waiting buffer */
+typedef struct {
+    keypos_t key;
+    uint16_t time;
+    bool     pressed : 1;
+    bool     interrupted : 1;
+    uint8_t  count : 4;
+} waiting_record_t;
+
+static keyrecord_t      tapping_key                         = {};
+static waiting_record_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
+static uint8_t          waiting_buffer_head                 = 0;
+static uint8_t          waiting_buffer_tail                 = 0;
 
-static bool process_tapping(keyrecord_t *record);
-static bool waiting_buffer_enq(keyrecord_t record);
-static void waiting_buffer_clear(void);
+#    ifdef TAPPING_STREAK_TERM
+static uint16_t last_press_time  = 0;
+static bool     last_press_valid = false;
+
+/* Keys decided as taps at press that are still held, but no longer the tapping key */
+#        define STREAK_TAPS_HELD_SIZE 8
+static keypos_t streak_taps_held[STREAK_TAPS_HELD_SIZE];
+static uint8_t  streak_taps_held_count = 0;
+#    endif
+
+static bool        process_tapping(keyrecord_t *record);
+static bool        waiting_buffer_enq(keyrecord_t record);
+static keyrecord_t waiting_buffer_get(uint8_t i);
+static void        waiting_buffer_set(uint8_t i, keyrecord_t *record);
+static void        waiting_buffer_process(void);
+static void        tapping_key_resolve(void);
+static bool        tapping_streak_start(keyrecord_t *keyp);
+static void        tapping_streak_keep(void);
+static void        tapping_streak_release(keyrecord_t *keyp);
+static void        tapping_streak_update(keyrecord_t *record);
+static void        debug_tapping_decision(uint16_t time);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -55,18 +92,18 @@ static void debug_waiting_buffer(void);
  */
 void action_tapping_process(keyrecord_t record) {
     if (process_tapping(&record)) {
+        tapping_streak_update(&record);
         if (!IS_NOEVENT(record.event)) {
             debug("processed: ");
             debug_record(record);
             debug("\n");
         }
     } else {
-        if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
-            debug("OVERFLOW: CLEAR ALL STATES\n");
-            clear_keyboard();
-            waiting_buffer_clear();
-            tapping_key = (keyrecord_t){};
+        while (!waiting_buffer_enq(record)) {
+            // Settle the tapping key in case of overflow, so that the waiting events can be processed
+            debug("OVERFLOW: RESOLVE TAPPING KEY\n");
+            tapping_key_resolve();
+            waiting_buffer_process();
         }
     }
 
@@ -74,22 +111,112 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer[");
-            debug_dec(waiting_buffer_tail);
-            debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]);
-            debug("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
 }
 
+/** \brief Tapping key resolve
+ *
+ * Settles the tapping key, as many keys have been typed while holding it. An undecided key is a tap if its
+ * release is already waiting, and a hold otherwise. A tap that is still pressed has already been processed,
+ * and stays the tapping key to take its release, while a released tap only loses its chance of a sequential tap.
+ */
+static void tapping_key_resolve(void) {
+    if (IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) {
+        waiting_buffer_scan_tap();
+        if (tapping_key.tap.count == 0) {
+            debug("Tapping: End. Resolved as hold.\n");
+            debug_tapping_decision(timer_read());
+            process_record(&tapping_key);
+            tapping_key = (keyrecord_t){};
+        }
+    } else if (IS_TAPPING_RELEASED()) {
+        debug("Tapping: End. Resolved after tap.\n");
+        tapping_key = (keyrecord_t){};
+    }
+    debug_tapping_key();
+}
+
+/** \brief Tapping streak start
+ *
+ * A tap key pressed within TAPPING_STREAK_TERM of the previous key press is part of a typing streak,
+ * so it's decided as a tap at once instead of waiting for its release.
+ */
+static bool tapping_streak_start(keyrecord_t *keyp) {
+#    ifdef TAPPING_STREAK_TERM
+    if (last_press_valid && WITHIN_TAPPING_STREAK_TERM(keyp)) {
+        debug("Tapping: Start. Tap in typing streak.\n");
+        keyp->tap.count       = 1;
+        keyp->tap.interrupted = false;
+        tapping_key           = *keyp;
+        debug_tapping_decision(keyp->event.time);
+        process_record(keyp);
+        debug_tapping_key();
+        return true;
+    }
+#    endif
+    return false;
+}
+
+/** \brief Tapping streak keep
+ *
+ * The tapping key is about to be replaced while it's still held as a tap, which only a typing streak does,
+ * before its release is waiting. Remember it, so that its release still ends the tap instead of a hold.
+ */
+static void tapping_streak_keep(void) {
+#    ifdef TAPPING_STREAK_TERM
+    if (!IS_TAPPING_PRESSED() || tapping_key.tap.count == 0 || waiting_buffer_typed(tapping_key.event)) {
+        return;
+    }
+    if (streak_taps_held_count == STREAK_TAPS_HELD_SIZE) {
+        // Out of room, so end the oldest tap now
+        debug("Tapping: Streak. Release oldest held tap.\n");
+        process_record(&(keyrecord_t){.tap.count = 1, .event.key = streak_taps_held[0], .event.time = tapping_key.event.time, .event.pressed = false});
+        memmove(&streak_taps_held[0], &streak_taps_held[1], sizeof(keypos_t) * (STREAK_TAPS_HELD_SIZE - 1));
+        streak_taps_held_count--;
+    }
+    streak_taps_held[streak_taps_held_count++] = tapping_key.event.key;
+#    endif
+}
+
+/** \brief Tapping streak release
+ *
+ * Gives the release of a key remembered by tapping_streak_keep() the tap state of its press.
+ */
+static void tapping_streak_release(keyrecord_t *keyp) {
+#    ifdef TAPPING_STREAK_TERM
+    if (keyp->event.pressed || IS_NOEVENT(keyp->event)) {
+        return;
+    }
+    for (uint8_t i = 0; i < streak_taps_held_count; i++) {
+        if (KEYEQ(streak_taps_held[i], keyp->event.key)) {
+            keyp->tap.count       = 1;
+            keyp->tap.interrupted = false;
+            memmove(&streak_taps_held[i], &streak_taps_held[i + 1], sizeof(keypos_t) * (streak_taps_held_count - i - 1));
+            streak_taps_held_count--;
+            return;
+        }
+    }
+#    endif
+}
+
+/** \brief Tapping streak update
+ *
+ * Remembers when the last key press was processed, and forgets it once the streak is over.
+ */
+static void tapping_streak_update(keyrecord_t *record) {
+#    ifdef TAPPING_STREAK_TERM
+    if (record->event.pressed && !IS_NOEVENT(record->event)) {
+        last_press_time  = record->event.time;
+        last_press_valid = true;
+    } else if (last_press_valid && TIMER_DIFF_16(timer_read(), last_press_time) >= TAPPING_STREAK_TERM) {
+        last_press_valid = false;
+    }
+#    endif
+}
+
 /** \brief Tapping
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
@@ -97,6 +224,7 @@ void action_tapping_process(keyrecord_t record) {
  */
 /* return true when key event is processed or consumed. */
 bool process_tapping(keyrecord_t *keyp) {
+    tapping_streak_release(keyp);
     keyevent_t event = keyp->event;
 
     // if tapping
@@ -106,6 +234,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 if (IS_TAPPING_KEY(event.key) && !event.pressed) {
                     // first tap!
                     debug("Tapping: First tap(0->1).\n");
+                    debug_tapping_decision(event.time);
                     tapping_key.tap.count = 1;
                     debug_tapping_key();
                     process_record(&tapping_key);
@@ -136,6 +265,7 @@ bool process_tapping(keyrecord_t *keyp) {
                               ) &&
                          IS_RELEASED(event) && waiting_buffer_typed(event)) {
                     debug("Tapping: End. No tap. Interfered by typing key\n");
+                    debug_tapping_decision(event.time);
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){};
                     debug_tapping_key();
@@ -193,7 +323,9 @@ bool process_tapping(keyrecord_t *keyp) {
                         process_record(&(keyrecord_t){.tap = tapping_key.tap, .event.key = tapping_key.event.key, .event.time = event.time, .event.pressed = false});
                     } else {
                         debug("Tapping: Start while last tap(1).\n");
+                        tapping_streak_keep();
                     }
+                    if (tapping_streak_start(keyp)) return true;
                     tapping_key = *keyp;
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
@@ -213,6 +345,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 debug("Tapping: End. Timeout. Not tap(0): ");
                 debug_event(event);
                 debug("\n");
+                debug_tapping_decision(event.time);
                 process_record(&tapping_key);
                 tapping_key = (keyrecord_t){};
                 debug_tapping_key();
@@ -231,7 +364,9 @@ bool process_tapping(keyrecord_t *keyp) {
                         process_record(&(keyrecord_t){.tap = tapping_key.tap, .event.key = tapping_key.event.key, .event.time = event.time, .event.pressed = false});
                     } else {
                         debug("Tapping: Start while last timeout tap(1).\n");
+                        tapping_streak_keep();
                     }
+                    if (tapping_streak_start(keyp)) return true;
                     tapping_key = *keyp;
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
@@ -274,6 +409,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 } else if (is_tap_key(event.key)) {
                     // Sequential tap can be interfered with other tap key.
                     debug("Tapping: Start with interfering other tap.\n");
+                    if (tapping_streak_start(keyp)) return true;
                     tapping_key = *keyp;
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
@@ -304,6 +440,7 @@ bool process_tapping(keyrecord_t *keyp) {
     // not tapping state
     else {
         if (event.pressed && is_tap_key(event.key)) {
+            if (tapping_streak_start(keyp)) return true;
             debug("Tapping: Start(Press tap key).\n");
             tapping_key = *keyp;
             process_record_tap_hint(&tapping_key);
@@ -331,21 +468,60 @@ bool waiting_buffer_enq(keyrecord_t record) {
         return false;
     }
 
-    waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_set(waiting_buffer_head, &record);
+    waiting_buffer_head = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
-/** \brief Waiting buffer clear
+/** \brief Waiting buffer get
  *
- * FIXME: Needs docs
+ * Unpacks an entry of the waiting buffer.
+ */
+keyrecord_t waiting_buffer_get(uint8_t i) {
+    waiting_record_t *entry = &waiting_buffer[i];
+    return (keyrecord_t){
+        .event = {.key = entry->key, .pressed = entry->pressed, .time = entry->time},
+        .tap   = {.interrupted = entry->interrupted, .count = entry->count},
+    };
+}
+
+/** \brief Waiting buffer set
+ *
+ * Packs a record into an entry of the waiting buffer.
+ */
+void waiting_buffer_set(uint8_t i, keyrecord_t *record) {
+    waiting_record_t *entry = &waiting_buffer[i];
+    entry->key              = record->event.key;
+    entry->time             = record->event.time;
+    entry->pressed          = record->event.pressed;
+    entry->interrupted      = record->tap.interrupted;
+    entry->count            = record->tap.count;
+}
+
+/** \brief Waiting buffer process
+ *
+ * Processes the waiting events in order, until one of them has to keep waiting.
  */
-void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+void waiting_buffer_process(void) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+        keyrecord_t record    = waiting_buffer_get(waiting_buffer_tail);
+        bool        processed = process_tapping(&record);
+        // The tap state can change even if the event keeps waiting
+        waiting_buffer_set(waiting_buffer_tail, &record);
+        if (processed) {
+            tapping_streak_update(&record);
+            debug("processed: waiting_buffer[");
+            debug_dec(waiting_buffer_tail);
+            debug("] = ");
+            debug_record(record);
+            debug("\n\n");
+        } else {
+            break;
+        }
+    }
 }
 
 /** \brief Waiting buffer typed
@@ -354,7 +530,7 @@ void waiting_buffer_clear(void) {
  */
 bool waiting_buffer_typed(keyevent_t event) {
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
+        if (KEYEQ(event.key, waiting_buffer[i].key) && event.pressed != waiting_buffer[i].pressed) {
             return true;
         }
     }
@@ -367,7 +543,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
+        if (waiting_buffer[i].pressed) return true;
     }
     return false;
 }
@@ -383,9 +559,10 @@ void waiting_buffer_scan_tap(void) {
     if (!tapping_key.event.pressed) return;
 
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
-            tapping_key.tap.count       = 1;
-            waiting_buffer[i].tap.count = 1;
+        if (IS_TAPPING_KEY(waiting_buffer[i].key) && !waiting_buffer[i].pressed && WITHIN_TAPPING_TERM(waiting_buffer[i])) {
+            debug_tapping_decision(waiting_buffer[i].time);
+            tapping_key.tap.count   = 1;
+            waiting_buffer[i].count = 1;
             process_record(&tapping_key);
 
             debug("waiting_buffer_scan_tap: found at [");
@@ -407,6 +584,16 @@ static void debug_tapping_key(void) {
     debug("\n");
 }
 
+/** \brief Tapping decision debug print
+ *
+ * Prints how long the tapping key took to be decided as a tap or a hold.
+ */
+static void debug_tapping_decision(uint16_t time) {
+    debug("Tapping: decided after ");
+    debug_dec(TIMER_DIFF_16(time, tapping_key.event.time));
+    debug("ms\n");
+}
+
 /** \brief Waiting buffer debug print
  *
  * FIXME: Needs docs
@@ -417,7 +604,7 @@ static void debug_waiting_buffer(void) {
         debug("[");
         debug_dec(i);
         debug("]=");
-        debug_record(waiting_buffer[i]);
+        debug_record(waiting_buffer_get(i));
         debug(" ");
     }
     debug("}\n");
@@ -42,9 +42,8 @@ static int8_t cb_count = 0;
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
-extern inline void add_key(uint8_t key);
-extern inline void del_key(uint8_t key);
-extern inline void clear_keys(void);
+// Number of keys in keyboard_report, kept up to date by add_key and del_key so that it doesn't need to be counted
+static uint8_t keys_count = 0;
 
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
@@ -184,6 +183,37 @@ void clear_oneshot_layer_state(oneshot_fullfillment_t state) {
 bool is_oneshot_layer_active(void) { return get_oneshot_layer_state(); }
 #endif
 
+/** \brief Adds a key to the keyboard report
+ *
+ * The report isn't sent until send_keyboard_report is called
+ */
+void add_key(uint8_t key) {
+    if (add_key_to_report(keyboard_report, key)) {
+        keys_count++;
+    }
+}
+
+/** \brief Removes a key from the keyboard report
+ *
+ * The report isn't sent until send_keyboard_report is called
+ */
+void del_key(uint8_t key) {
+    if (del_key_from_report(keyboard_report, key)) {
+        keys_count--;
+    }
+}
+
+/** \brief Removes all keys, but not the mods, from the keyboard report
+ */
+void clear_keys(void) {
+    clear_keys_from_report(keyboard_report);
+    keys_count = 0;
+}
+
+/** \brief Number of keys in the keyboard report, not counting mods
+ */
+uint8_t get_keys_count(void) { return keys_count; }
+
 /** \brief Send keyboard report
  *
  * FIXME: needs doc
@@ -201,7 +231,7 @@ void send_keyboard_report(void) {
         }
 #    endif
         keyboard_report->mods |= oneshot_mods;
-        if (has_anykey(keyboard_report)) {
+        if (keys_count) {
             clear_oneshot_mods();
         }
     }
@@ -2,6 +2,8 @@
 #include "i2c_master.h"
 #include "md_rgb_matrix.h"
 #include "suspend.h"
+#include "eeconfig.h"
+#include "host.h"
 
 /** \brief Suspend idle
  *
@@ -31,6 +33,10 @@ void suspend_power_down(void) {
     I2C3733_Control_Set(0);  // Disable LED driver
 #endif
 
+    // Settings still waiting to be written would be lost if the host cuts the power
+    eeconfig_flush();
+    // Reports sent while suspended may have been dropped
+    host_keyboard_forget_last_report();
     suspend_power_down_kb();
 }
 
@@ -63,6 +69,8 @@ __attribute__((weak)) void suspend_wakeup_init_kb(void) { suspend_wakeup_init_us
  * FIXME: needs doc
  */
 void suspend_wakeup_init(void) {
+    host_keyboard_forget_last_report();
+
 #ifdef RGB_MATRIX_ENABLE
 #    ifdef USE_MASSDROP_CONFIGURATOR
     if (led_enabled) {
@@ -16,4 +16,9 @@ uint16_t timer_elapsed(uint16_t tlast) { return TIMER_DIFF_16(timer_read(), tlas
 
 uint32_t timer_elapsed32(uint32_t tlast) { return TIMER_DIFF_32(timer_read32(), tlast); }
 
+// Only millisecond resolution here
+uint32_t timer_read_ticks(void) { return (uint32_t)ms_clk; }
+
+uint32_t timer_ticks_per_second(void) { return 1000; }
+
 void timer_clear(void) { set_time(0); }
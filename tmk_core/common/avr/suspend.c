@@ -8,6 +8,7 @@
 #include "timer.h"
 #include "led.h"
 #include "host.h"
+#include "eeconfig.h"
 
 #ifdef PROTOCOL_LUFA
 #    include "lufa.h"
@@ -128,6 +129,10 @@ void suspend_power_down(void) {
     if (!vusb_suspended) return;
 #endif
 
+    // Settings still waiting to be written would be lost if the host cuts the power
+    eeconfig_flush();
+    // Reports sent while suspended may have been dropped
+    host_keyboard_forget_last_report();
     suspend_power_down_kb();
 
 #ifndef NO_SUSPEND_POWER_DOWN
@@ -192,7 +197,8 @@ __attribute__((weak)) void suspend_wakeup_init_kb(void) { suspend_wakeup_init_us
  * FIXME: needs doc
  */
 void suspend_wakeup_init(void) {
-    // clear keyboard state
+    // clear keyboard state, and send it even if it's the same as before the host was suspended
+    host_keyboard_forget_last_report();
     clear_keyboard();
 
     // Turn on backlight
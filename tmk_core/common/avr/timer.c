@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <avr/interrupt.h>
 #include <util/atomic.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "timer_avr.h"
 #include "timer.h"
 
@@ -124,6 +125,35 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+/** \brief timer read ticks
+ *
+ * Counts Timer0 cycles, of which there are TIMER_RAW_TOP + 1 per millisecond
+ */
+uint32_t timer_read_ticks(void) {
+    uint32_t t;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t   = timer_count;
+        raw = TIMER_RAW;
+        // Timer0 has started over, but the interrupt counting the millisecond hasn't run yet
+#if defined(__AVR_ATmega32A__)
+        bool pending = TIFR & _BV(OCF0);
+#elif defined(__AVR_ATtiny85__)
+        bool pending = TIFR & _BV(OCF0A);
+#else
+        bool pending = TIFR0 & _BV(OCF0A);
+#endif
+        if (pending && raw < TIMER_RAW_TOP / 2) {
+            t++;
+        }
+    }
+
+    return t * (TIMER_RAW_TOP + 1) + raw;
+}
+
+uint32_t timer_ticks_per_second(void) { return 1000UL * (TIMER_RAW_TOP + 1); }
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
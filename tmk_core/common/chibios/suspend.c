@@ -8,6 +8,7 @@
 #include "action_util.h"
 #include "mousekey.h"
 #include "host.h"
+#include "eeconfig.h"
 #include "suspend.h"
 #include "led.h"
 #include "wait.h"
@@ -73,6 +74,10 @@ void suspend_power_down(void) {
     stop_all_notes();
 #endif /* AUDIO_ENABLE */
 
+    // Settings still waiting to be written would be lost if the host cuts the power
+    eeconfig_flush();
+    // Reports sent while suspended may have been dropped
+    host_keyboard_forget_last_report();
     suspend_power_down_kb();
     // on AVR, this enables the watchdog for 15ms (max), and goes to
     // SLEEP_MODE_PWR_DOWN
@@ -120,6 +125,7 @@ void suspend_wakeup_init(void) {
     // so only clear the variables in memory
     // the reports will be sent from main.c afterwards
     // or if the PC asks for GET_REPORT
+    host_keyboard_forget_last_report();
     clear_mods();
     clear_weak_mods();
     clear_keys();
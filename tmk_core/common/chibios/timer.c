@@ -1,4 +1,5 @@
 #include <ch.h>
+#include <hal.h>
 
 #include "timer.h"
 
@@ -20,7 +21,8 @@ void timer_clear(void) {
 
 uint16_t timer_read(void) { return (uint16_t)timer_read32(); }
 
-uint32_t timer_read32(void) {
+// The system time since timer_clear(), extended to 32 bits
+static uint32_t timer_read_systime(void) {
     uint32_t systime = (uint32_t)chVTGetSystemTime();
 
 #if CH_CFG_ST_RESOLUTION < 32
@@ -36,12 +38,25 @@ uint32_t timer_read32(void) {
     }
 
     last_systime = systime;
-    return (uint32_t)TIME_I2MS(systime - reset_point + overflow);
+    return systime - reset_point + overflow;
 #else
-    return (uint32_t)TIME_I2MS(systime - reset_point);
+    return systime - reset_point;
 #endif
 }
 
+uint32_t timer_read32(void) { return (uint32_t)TIME_I2MS(timer_read_systime()); }
+
+#if PORT_SUPPORTS_RT == TRUE
+// The cycle counter of the core
+uint32_t timer_read_ticks(void) { return (uint32_t)chSysGetRealtimeCounterX(); }
+
+uint32_t timer_ticks_per_second(void) { return halGetCounterFrequency(); }
+#else
+uint32_t timer_read_ticks(void) { return timer_read_systime(); }
+
+uint32_t timer_ticks_per_second(void) { return CH_CFG_ST_FREQUENCY; }
+#endif
+
 uint16_t timer_elapsed(uint16_t last) { return TIMER_DIFF_16(timer_read(), last); }
 
 uint32_t timer_elapsed32(uint32_t last) { return TIMER_DIFF_32(timer_read32(), last); }
@@ -63,11 +63,21 @@ extern debug_config_t debug_config;
         do {                              \
             if (debug_enable) println(s); \
         } while (0)
-#    define dprintf(fmt, ...)                              \
-        do {                                               \
-            if (debug_enable) xprintf(fmt, ##__VA_ARGS__); \
-        } while (0)
-#    define dmsg(s) dprintf("%s at %s: %S\n", __FILE__, __LINE__, PSTR(s))
+#    ifdef BINLOG_ENABLE
+// Only the id of the format string and the arguments are sent, see binlog.h
+#        include "binlog.h"
+#        define dprintf(fmt, ...)                             \
+            do {                                              \
+                if (debug_enable) binlog(fmt, ##__VA_ARGS__); \
+            } while (0)
+#        define dmsg(s) dprintf("%s at %u: " s "\n", __FILE__, __LINE__)
+#    else
+#        define dprintf(fmt, ...)                              \
+            do {                                               \
+                if (debug_enable) xprintf(fmt, ##__VA_ARGS__); \
+            } while (0)
+#        define dmsg(s) dprintf("%s at %s: %S\n", __FILE__, __LINE__, PSTR(s))
+#    endif
 
 /* Deprecated. DO NOT USE these anymore, use dprintf instead. */
 #    define debug(s)                    \
@@ -1,8 +1,10 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "eeprom.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "timer.h"
 
 #ifdef STM32_EEPROM_ENABLE
 #    include <hal.h>
@@ -13,10 +15,130 @@
 #    include "eeprom_driver.h"
 #endif
 
+#if defined(EEPROM_I2C) && defined(EXTERNAL_EEPROM_WRITE_BACK)
+#    include "eeprom_i2c.h"
+#endif
+
 #if defined(HAPTIC_ENABLE)
 #    include "haptic.h"
 #endif
 
+#if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_ENABLE)
+void dynamic_macro_eeprom_reset(void);
+#endif
+
+#ifdef EECONFIG_WRITE_DELAY
+// Values written to the eeconfig area that haven't been committed to EEPROM yet
+static uint8_t  eeconfig_cache[EECONFIG_SIZE];
+static uint8_t  eeconfig_dirty[(EECONFIG_SIZE + 7) / 8];
+static bool     eeconfig_any_dirty = false;
+static uint16_t eeconfig_last_write;
+
+static inline bool eeconfig_is_dirty(uintptr_t offset) { return eeconfig_dirty[offset / 8] & (1 << (offset % 8)); }
+
+/** \brief Drops writes that haven't been committed
+ */
+static void eeconfig_discard(void) {
+    memset(eeconfig_dirty, 0, sizeof(eeconfig_dirty));
+    eeconfig_any_dirty = false;
+}
+
+/** \brief Commits pending writes to EEPROM, a block per run of changed bytes
+ */
+static void eeconfig_commit(void) {
+    if (!eeconfig_any_dirty) {
+        return;
+    }
+    uintptr_t offset = 0;
+    while (offset < EECONFIG_SIZE) {
+        if (!eeconfig_is_dirty(offset)) {
+            offset++;
+            continue;
+        }
+        uintptr_t start = offset;
+        while (offset < EECONFIG_SIZE && eeconfig_is_dirty(offset)) {
+            offset++;
+        }
+        eeprom_update_block(eeconfig_cache + start, (void *)start, offset - start);
+    }
+    eeconfig_discard();
+}
+
+/** \brief Commits pending writes once nothing has been written for EECONFIG_WRITE_DELAY ms
+ */
+void eeconfig_task(void) {
+    if (eeconfig_any_dirty && timer_elapsed(eeconfig_last_write) >= EECONFIG_WRITE_DELAY) {
+        eeconfig_commit();
+    }
+}
+
+/** \brief Reads from the eeconfig area, including writes that haven't been committed yet
+ */
+void eeconfig_read_block(void *buf, const void *addr, size_t len) {
+    uint8_t * target = (uint8_t *)buf;
+    uintptr_t offset = (uintptr_t)addr;
+    for (size_t i = 0; i < len; i++, offset++) {
+        if (offset < EECONFIG_SIZE && eeconfig_is_dirty(offset)) {
+            target[i] = eeconfig_cache[offset];
+        } else {
+            target[i] = eeprom_read_byte((const uint8_t *)offset);
+        }
+    }
+}
+
+/** \brief Writes to the eeconfig area, held back until eeconfig_task or eeconfig_flush commits it
+ */
+void eeconfig_update_block(const void *buf, void *addr, size_t len) {
+    const uint8_t *source = (const uint8_t *)buf;
+    uintptr_t      offset = (uintptr_t)addr;
+    for (size_t i = 0; i < len; i++, offset++) {
+        if (offset < EECONFIG_SIZE) {
+            eeconfig_cache[offset] = source[i];
+            eeconfig_dirty[offset / 8] |= 1 << (offset % 8);
+            eeconfig_any_dirty  = true;
+            eeconfig_last_write = timer_read();
+        } else {
+            eeprom_update_byte((uint8_t *)offset, source[i]);
+        }
+    }
+}
+
+uint8_t eeconfig_read_byte(const uint8_t *addr) {
+    uint8_t value;
+    eeconfig_read_block(&value, addr, sizeof(value));
+    return value;
+}
+
+uint16_t eeconfig_read_word(const uint16_t *addr) {
+    uint16_t value;
+    eeconfig_read_block(&value, addr, sizeof(value));
+    return value;
+}
+
+uint32_t eeconfig_read_dword(const uint32_t *addr) {
+    uint32_t value;
+    eeconfig_read_block(&value, addr, sizeof(value));
+    return value;
+}
+
+void eeconfig_update_byte(uint8_t *addr, uint8_t value) { eeconfig_update_block(&value, addr, sizeof(value)); }
+
+void eeconfig_update_word(uint16_t *addr, uint16_t value) { eeconfig_update_block(&value, addr, sizeof(value)); }
+
+void eeconfig_update_dword(uint32_t *addr, uint32_t value) { eeconfig_update_block(&value, addr, sizeof(value)); }
+#endif
+
+/** \brief Writes everything still held in RAM to the EEPROM chip, before it can be lost to a reset or power down
+ */
+void eeconfig_flush(void) {
+#ifdef EECONFIG_WRITE_DELAY
+    eeconfig_commit();
+#endif
+#if defined(EEPROM_I2C) && defined(EXTERNAL_EEPROM_WRITE_BACK)
+    eeprom_i2c_flush();
+#endif
+}
+
 /** \brief eeconfig enable
  *
  * FIXME: needs doc
@@ -37,6 +159,10 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
  * FIXME: needs doc
  */
 void eeconfig_init_quantum(void) {
+#ifdef EECONFIG_WRITE_DELAY
+    // The defaults replace anything still waiting to be written
+    eeconfig_discard();
+#endif
 #ifdef STM32_EEPROM_ENABLE
     EEPROM_Erase();
 #endif
@@ -77,6 +203,9 @@ void eeconfig_init_quantum(void) {
     // when a haptic-enabled firmware is loaded onto the keyboard.
     eeprom_update_dword(EECONFIG_HAPTIC, 0);
 #endif
+#if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_ENABLE)
+    dynamic_macro_eeprom_reset();
+#endif
 
     eeconfig_init_kb();
 }
@@ -98,6 +227,9 @@ void eeconfig_enable(void) { eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_N
  * FIXME: needs doc
  */
 void eeconfig_disable(void) {
+#ifdef EECONFIG_WRITE_DELAY
+    eeconfig_discard();
+#endif
 #ifdef STM32_EEPROM_ENABLE
     EEPROM_Erase();
 #endif
@@ -111,112 +243,112 @@ void eeconfig_disable(void) {
  *
  * FIXME: needs doc
  */
-bool eeconfig_is_enabled(void) { return (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER); }
+bool eeconfig_is_enabled(void) { return (eeconfig_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER); }
 
 /** \brief eeconfig is disabled
  *
  * FIXME: needs doc
  */
-bool eeconfig_is_disabled(void) { return (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER_OFF); }
+bool eeconfig_is_disabled(void) { return (eeconfig_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER_OFF); }
 
 /** \brief eeconfig read debug
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_debug(void) { return eeprom_read_byte(EECONFIG_DEBUG); }
+uint8_t eeconfig_read_debug(void) { return eeconfig_read_byte(EECONFIG_DEBUG); }
 /** \brief eeconfig update debug
  *
  * FIXME: needs doc
  */
-void eeconfig_update_debug(uint8_t val) { eeprom_update_byte(EECONFIG_DEBUG, val); }
+void eeconfig_update_debug(uint8_t val) { eeconfig_update_byte(EECONFIG_DEBUG, val); }
 
 /** \brief eeconfig read default layer
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_default_layer(void) { return eeprom_read_byte(EECONFIG_DEFAULT_LAYER); }
+uint8_t eeconfig_read_default_layer(void) { return eeconfig_read_byte(EECONFIG_DEFAULT_LAYER); }
 /** \brief eeconfig update default layer
  *
  * FIXME: needs doc
  */
-void eeconfig_update_default_layer(uint8_t val) { eeprom_update_byte(EECONFIG_DEFAULT_LAYER, val); }
+void eeconfig_update_default_layer(uint8_t val) { eeconfig_update_byte(EECONFIG_DEFAULT_LAYER, val); }
 
 /** \brief eeconfig read keymap
  *
  * FIXME: needs doc
  */
-uint16_t eeconfig_read_keymap(void) { return (eeprom_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeprom_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8)); }
+uint16_t eeconfig_read_keymap(void) { return (eeconfig_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeconfig_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8)); }
 /** \brief eeconfig update keymap
  *
  * FIXME: needs doc
  */
 void eeconfig_update_keymap(uint16_t val) {
-    eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
-    eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
+    eeconfig_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
+    eeconfig_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
 }
 
 /** \brief eeconfig read backlight
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_backlight(void) { return eeprom_read_byte(EECONFIG_BACKLIGHT); }
+uint8_t eeconfig_read_backlight(void) { return eeconfig_read_byte(EECONFIG_BACKLIGHT); }
 /** \brief eeconfig update backlight
  *
  * FIXME: needs doc
  */
-void eeconfig_update_backlight(uint8_t val) { eeprom_update_byte(EECONFIG_BACKLIGHT, val); }
+void eeconfig_update_backlight(uint8_t val) { eeconfig_update_byte(EECONFIG_BACKLIGHT, val); }
 
 /** \brief eeconfig read audio
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_audio(void) { return eeprom_read_byte(EECONFIG_AUDIO); }
+uint8_t eeconfig_read_audio(void) { return eeconfig_read_byte(EECONFIG_AUDIO); }
 /** \brief eeconfig update audio
  *
  * FIXME: needs doc
  */
-void eeconfig_update_audio(uint8_t val) { eeprom_update_byte(EECONFIG_AUDIO, val); }
+void eeconfig_update_audio(uint8_t val) { eeconfig_update_byte(EECONFIG_AUDIO, val); }
 
 /** \brief eeconfig read kb
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_kb(void) { return eeprom_read_dword(EECONFIG_KEYBOARD); }
+uint32_t eeconfig_read_kb(void) { return eeconfig_read_dword(EECONFIG_KEYBOARD); }
 /** \brief eeconfig update kb
  *
  * FIXME: needs doc
  */
-void eeconfig_update_kb(uint32_t val) { eeprom_update_dword(EECONFIG_KEYBOARD, val); }
+void eeconfig_update_kb(uint32_t val) { eeconfig_update_dword(EECONFIG_KEYBOARD, val); }
 
 /** \brief eeconfig read user
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_user(void) { return eeprom_read_dword(EECONFIG_USER); }
+uint32_t eeconfig_read_user(void) { return eeconfig_read_dword(EECONFIG_USER); }
 /** \brief eeconfig update user
  *
  * FIXME: needs doc
  */
-void eeconfig_update_user(uint32_t val) { eeprom_update_dword(EECONFIG_USER, val); }
+void eeconfig_update_user(uint32_t val) { eeconfig_update_dword(EECONFIG_USER, val); }
 
 /** \brief eeconfig read haptic
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_haptic(void) { return eeprom_read_dword(EECONFIG_HAPTIC); }
+uint32_t eeconfig_read_haptic(void) { return eeconfig_read_dword(EECONFIG_HAPTIC); }
 /** \brief eeconfig update haptic
  *
  * FIXME: needs doc
  */
-void eeconfig_update_haptic(uint32_t val) { eeprom_update_dword(EECONFIG_HAPTIC, val); }
+void eeconfig_update_haptic(uint32_t val) { eeconfig_update_dword(EECONFIG_HAPTIC, val); }
 
 /** \brief eeconfig read split handedness
  *
  * FIXME: needs doc
  */
-bool eeconfig_read_handedness(void) { return !!eeprom_read_byte(EECONFIG_HANDEDNESS); }
+bool eeconfig_read_handedness(void) { return !!eeconfig_read_byte(EECONFIG_HANDEDNESS); }
 /** \brief eeconfig update split handedness
  *
  * FIXME: needs doc
  */
-void eeconfig_update_handedness(bool val) { eeprom_update_byte(EECONFIG_HANDEDNESS, !!val); }
+void eeconfig_update_handedness(bool val) { eeconfig_update_byte(EECONFIG_HANDEDNESS, !!val); }
@@ -19,6 +19,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "eeprom.h"
 
 #ifndef EECONFIG_MAGIC_NUMBER
 #    define EECONFIG_MAGIC_NUMBER (uint16_t)0xFEEB  // When changing, decrement this value to avoid future re-init issues
@@ -110,3 +112,33 @@ void     eeconfig_update_haptic(uint32_t val);
 
 bool eeconfig_read_handedness(void);
 void eeconfig_update_handedness(bool val);
+
+/* Access to the eeconfig area. With EECONFIG_WRITE_DELAY defined, writes
+ * are held in RAM and committed in one go once nothing has been written for
+ * that many ms, or when eeconfig_flush is called, so that adjusting a setting
+ * over and over doesn't write EEPROM each time. */
+#ifdef EECONFIG_WRITE_DELAY
+uint8_t  eeconfig_read_byte(const uint8_t *addr);
+uint16_t eeconfig_read_word(const uint16_t *addr);
+uint32_t eeconfig_read_dword(const uint32_t *addr);
+void     eeconfig_read_block(void *buf, const void *addr, size_t len);
+void     eeconfig_update_byte(uint8_t *addr, uint8_t value);
+void     eeconfig_update_word(uint16_t *addr, uint16_t value);
+void     eeconfig_update_dword(uint32_t *addr, uint32_t value);
+void     eeconfig_update_block(const void *buf, void *addr, size_t len);
+
+void eeconfig_task(void);
+#else
+#    define eeconfig_read_byte(addr) eeprom_read_byte(addr)
+#    define eeconfig_read_word(addr) eeprom_read_word(addr)
+#    define eeconfig_read_dword(addr) eeprom_read_dword(addr)
+#    define eeconfig_read_block(buf, addr, len) eeprom_read_block(buf, addr, len)
+#    define eeconfig_update_byte(addr, value) eeprom_update_byte(addr, value)
+#    define eeconfig_update_word(addr, value) eeprom_update_word(addr, value)
+#    define eeconfig_update_dword(addr, value) eeprom_update_dword(addr, value)
+#    define eeconfig_update_block(buf, addr, len) eeprom_update_block(buf, addr, len)
+#endif
+
+/* Writes held back by EECONFIG_WRITE_DELAY or by the EEPROM driver
+ * (EXTERNAL_EEPROM_WRITE_BACK) go out to the chip before this returns. */
+void eeconfig_flush(void);
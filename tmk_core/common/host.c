@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 //#include <avr/interrupt.h>
 #include "keycode.h"
 #include "host.h"
@@ -31,10 +32,22 @@ static host_driver_t *driver;
 static uint16_t       last_system_report   = 0;
 static uint16_t       last_consumer_report = 0;
 
-void host_set_driver(host_driver_t *d) { driver = d; }
+/* The last keyboard report sent, so that the same one isn't sent twice in a row */
+static report_keyboard_t last_keyboard_report;
+static bool              last_keyboard_report_valid  = false;
+static bool              last_keyboard_report_nkro   = false;
+static uint16_t          keyboard_reports_suppressed = 0;
+
+void host_set_driver(host_driver_t *d) {
+    driver = d;
+    // A different driver hasn't seen the last report
+    last_keyboard_report_valid = false;
+}
 
 host_driver_t *host_get_driver(void) { return driver; }
 
+void host_keyboard_forget_last_report(void) { last_keyboard_report_valid = false; }
+
 uint8_t host_keyboard_leds(void) {
     if (!driver) return 0;
     return (*driver->keyboard_leds)();
@@ -62,6 +75,23 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
+
+    /* The NKRO and 6KRO reports share their memory, so switching between them always sends */
+    bool nkro = false;
+#ifdef NKRO_ENABLE
+    nkro = keyboard_protocol && keymap_config.nkro;
+#endif
+    if (last_keyboard_report_valid && nkro == last_keyboard_report_nkro && memcmp(report, &last_keyboard_report, sizeof(report_keyboard_t)) == 0) {
+        keyboard_reports_suppressed++;
+        if (debug_keyboard) {
+            dprintf("keyboard_report: same as last, %u not sent\n", keyboard_reports_suppressed);
+        }
+        return;
+    }
+    last_keyboard_report       = *report;
+    last_keyboard_report_nkro  = nkro;
+    last_keyboard_report_valid = true;
+
     (*driver->send_keyboard)(report);
 
     if (debug_keyboard) {
@@ -100,3 +130,5 @@ void host_consumer_send(uint16_t report) {
 uint16_t host_last_system_report(void) { return last_system_report; }
 
 uint16_t host_last_consumer_report(void) { return last_consumer_report; }
+
+uint16_t host_keyboard_reports_suppressed(void) { return keyboard_reports_suppressed; }
@@ -51,6 +51,11 @@ void    host_consumer_send(uint16_t data);
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 
+/* keyboard reports not sent because they were the same as the one before */
+uint16_t host_keyboard_reports_suppressed(void);
+/* send the next keyboard report even if it's the same, for when the host may have missed the last one */
+void host_keyboard_forget_last_report(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
+#if defined(EEPROM_I2C) && defined(EXTERNAL_EEPROM_WRITE_BACK)
+#    include "eeprom_i2c.h"
+#endif
+#ifdef TASK_PROFILER_ENABLE
+#    include "task_profiler.h"
+#else
+#    define task_profiler_start()
+#    define task_profiler_stage(stage)
+#    define task_profiler_end()
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) { return last_input_modification_time; }
@@ -342,6 +352,33 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
+/** \brief matrix_get_row_time
+ *
+ * Returns when the last change of a matrix row happened. Matrices that learn about changes after the fact, like the
+ * other half of a split keyboard, can override this so that key events get the time the key actually changed.
+ */
+__attribute__((weak)) uint16_t matrix_get_row_time(uint8_t row) { return timer_read(); }
+
+/** \brief key_event_time
+ *
+ * Time for a key event in the given row. It is never in the future, and never earlier than the previous key event, so
+ * that the intervals seen by tapping stay positive.
+ */
+static uint16_t key_event_time(uint8_t row) {
+    static uint16_t last_key_event_time = 0;
+    uint16_t        now                 = timer_read();
+    uint16_t        age                 = TIMER_DIFF_16(now, matrix_get_row_time(row));
+    uint16_t        since_last          = TIMER_DIFF_16(now, last_key_event_time);
+    if (age >= 0x8000) {
+        // the row time is in the future
+        age = 0;
+    } else if (age > since_last) {
+        age = since_last;
+    }
+    last_key_event_time = now - age;
+    return last_key_event_time;
+}
+
 /** \brief Keyboard task: Do keyboard routine jobs
  *
  * Do routine keyboard jobs:
@@ -366,11 +403,15 @@ void keyboard_task(void) {
     bool encoders_changed = false;
 #endif
 
+    task_profiler_start();
+
     housekeeping_task_kb();
     housekeeping_task_user();
+    task_profiler_stage(TASK_PROFILER_HOUSEKEEPING);
 
     uint8_t matrix_changed = matrix_scan();
     if (matrix_changed) last_matrix_activity_trigger();
+    task_profiler_stage(TASK_PROFILER_MATRIX_SCAN);
 
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         matrix_row    = matrix_get_row(r);
@@ -387,7 +428,7 @@ void keyboard_task(void) {
                 if (matrix_change & col_mask) {
                     if (should_process_keypress()) {
                         action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
+                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (key_event_time(r) | 1) /* time should not be 0 */
                         });
                     }
                     // record a processed key
@@ -413,32 +454,41 @@ void keyboard_task(void) {
         action_exec(TICK);
 
 MATRIX_LOOP_END:
+    // deferred layer callbacks run once for all the changes the keys made, before the lighting reads the state
+    layer_state_flush();
+    task_profiler_stage(TASK_PROFILER_ACTION_EXEC);
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
+    task_profiler_stage(TASK_PROFILER_OTHER);
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
     rgblight_task();
+    task_profiler_stage(TASK_PROFILER_RGBLIGHT);
 #endif
 
 #ifdef RGB_MATRIX_ENABLE
     rgb_matrix_task();
+    task_profiler_stage(TASK_PROFILER_RGB_MATRIX);
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
 #    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
     backlight_task();
+    task_profiler_stage(TASK_PROFILER_BACKLIGHT);
 #    endif
 #endif
 
 #ifdef ENCODER_ENABLE
     encoders_changed = encoder_read();
     if (encoders_changed) last_encoder_activity_trigger();
+    task_profiler_stage(TASK_PROFILER_ENCODER);
 #endif
 
 #ifdef QWIIC_ENABLE
     qwiic_task();
+    task_profiler_stage(TASK_PROFILER_OTHER);
 #endif
 
 #ifdef OLED_DRIVER_ENABLE
@@ -451,56 +501,83 @@ MATRIX_LOOP_END:
     if (matrix_changed) oled_on();
 #        endif
 #    endif
+    task_profiler_stage(TASK_PROFILER_OLED);
 #endif
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
     mousekey_task();
+    task_profiler_stage(TASK_PROFILER_MOUSE);
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
     ps2_mouse_task();
+    task_profiler_stage(TASK_PROFILER_MOUSE);
 #endif
 
 #ifdef SERIAL_MOUSE_ENABLE
     serial_mouse_task();
+    task_profiler_stage(TASK_PROFILER_MOUSE);
 #endif
 
 #ifdef ADB_MOUSE_ENABLE
     adb_mouse_task();
+    task_profiler_stage(TASK_PROFILER_MOUSE);
 #endif
 
 #ifdef SERIAL_LINK_ENABLE
     serial_link_update();
+    task_profiler_stage(TASK_PROFILER_OTHER);
 #endif
 
 #ifdef VISUALIZER_ENABLE
     visualizer_update(default_layer_state, layer_state, visualizer_get_mods(), host_keyboard_leds());
+    task_profiler_stage(TASK_PROFILER_OTHER);
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
     pointing_device_task();
+    task_profiler_stage(TASK_PROFILER_MOUSE);
 #endif
 
 #ifdef MIDI_ENABLE
     midi_task();
+    task_profiler_stage(TASK_PROFILER_MIDI);
 #endif
 
 #ifdef VELOCIKEY_ENABLE
     if (velocikey_enabled()) {
         velocikey_decelerate();
     }
+    task_profiler_stage(TASK_PROFILER_OTHER);
+#endif
+
+#ifdef EECONFIG_WRITE_DELAY
+    eeconfig_task();
+    task_profiler_stage(TASK_PROFILER_OTHER);
 #endif
 
 #ifdef JOYSTICK_ENABLE
     joystick_task();
+    task_profiler_stage(TASK_PROFILER_OTHER);
 #endif
 
+#if defined(EEPROM_I2C) && defined(EXTERNAL_EEPROM_WRITE_BACK)
+    eeprom_i2c_task();
+    task_profiler_stage(TASK_PROFILER_OTHER);
+#endif
+
+    // and for any the other tasks made
+    layer_state_flush();
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+    task_profiler_stage(TASK_PROFILER_LED_SYNC);
+
+    task_profiler_end();
 }
 
 /** \brief keyboard set leds
@@ -96,16 +96,18 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
 
 /** \brief add key byte
  *
- * FIXME: Needs doc
+ * Returns true if the number of keys in the report went up, which it doesn't when the key is already in it, or
+ * when the report is full
  */
-void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+bool add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
 #ifdef USB_6KRO_ENABLE
     int8_t i     = cb_head;
     int8_t empty = -1;
+    bool   added = true;
     if (cb_count) {
         do {
             if (keyboard_report->keys[i] == code) {
-                return;
+                return false;
             }
             if (empty == -1 && keyboard_report->keys[i] == 0) {
                 empty = i;
@@ -119,6 +121,7 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
                     // pop head when has no empty space
                     cb_head = RO_INC(cb_head);
                     cb_count--;
+                    added = false;
                 } else {
                     // left shift when has empty space
                     uint8_t offset = 1;
@@ -142,6 +145,7 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
     keyboard_report->keys[cb_tail] = code;
     cb_tail                        = RO_INC(cb_tail);
     cb_count++;
+    return added;
 #else
     int8_t i     = 0;
     int8_t empty = -1;
@@ -156,16 +160,18 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
     if (i == KEYBOARD_REPORT_KEYS) {
         if (empty != -1) {
             keyboard_report->keys[empty] = code;
+            return true;
         }
     }
+    return false;
 #endif
 }
 
 /** \brief del key byte
  *
- * FIXME: Needs doc
+ * Returns true if the key was in the report
  */
-void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+bool del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
 #ifdef USB_6KRO_ENABLE
     uint8_t i = cb_head;
     if (cb_count) {
@@ -186,72 +192,86 @@ void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
                         }
                     } while (cb_tail != cb_head);
                 }
-                break;
+                return true;
             }
             i = RO_INC(i);
         } while (i != cb_tail);
     }
+    return false;
 #else
+    bool deleted = false;
     for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
         if (keyboard_report->keys[i] == code) {
             keyboard_report->keys[i] = 0;
+            deleted                  = true;
         }
     }
+    return deleted;
 #endif
 }
 
 #ifdef NKRO_ENABLE
 /** \brief add key bit
  *
- * FIXME: Needs doc
+ * Returns true if the key wasn't in the report yet
  */
-void add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
+bool add_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
-        keyboard_report->nkro.bits[code >> 3] |= 1 << (code & 7);
+        uint8_t bit = 1 << (code & 7);
+        if (keyboard_report->nkro.bits[code >> 3] & bit) {
+            return false;
+        }
+        keyboard_report->nkro.bits[code >> 3] |= bit;
+        return true;
     } else {
         dprintf("add_key_bit: can't add: %02X\n", code);
+        return false;
     }
 }
 
 /** \brief del key bit
  *
- * FIXME: Needs doc
+ * Returns true if the key was in the report
  */
-void del_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
+bool del_key_bit(report_keyboard_t* keyboard_report, uint8_t code) {
     if ((code >> 3) < KEYBOARD_REPORT_BITS) {
-        keyboard_report->nkro.bits[code >> 3] &= ~(1 << (code & 7));
+        uint8_t bit = 1 << (code & 7);
+        if (!(keyboard_report->nkro.bits[code >> 3] & bit)) {
+            return false;
+        }
+        keyboard_report->nkro.bits[code >> 3] &= ~bit;
+        return true;
     } else {
         dprintf("del_key_bit: can't del: %02X\n", code);
+        return false;
     }
 }
 #endif
 
 /** \brief add key to report
  *
- * FIXME: Needs doc
+ * Returns true if the number of keys in the report went up
  */
-void add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key) {
+bool add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        add_key_bit(keyboard_report, key);
-        return;
+        return add_key_bit(keyboard_report, key);
     }
 #endif
-    add_key_byte(keyboard_report, key);
+    return add_key_byte(keyboard_report, key);
 }
 
 /** \brief del key from report
  *
- * FIXME: Needs doc
+ * Returns true if the key was in the report
  */
-void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key) {
+bool del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key) {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        del_key_bit(keyboard_report, key);
-        return;
+        return del_key_bit(keyboard_report, key);
     }
 #endif
-    del_key_byte(keyboard_report, key);
+    return del_key_byte(keyboard_report, key);
 }
 
 /** \brief clear key from report
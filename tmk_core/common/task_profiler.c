@@ -0,0 +1,262 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "task_profiler.h"
+#include "timer.h"
+#include "print.h"
+#include "debug.h"
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+    uint16_t count;
+    uint8_t  buckets[TASK_PROFILER_BUCKETS];
+} stage_stats_t;
+
+static stage_stats_t stats[TASK_PROFILER_STAGES];
+
+// The time spent in each stage during the current keyboard_task(), as a stage can be reached more than once
+static uint32_t loop_ticks[TASK_PROFILER_STAGES];
+static uint16_t stages_run;
+static uint32_t loop_start;
+static uint32_t last_mark;
+#if TASK_PROFILER_PRINT_INTERVAL > 0
+static uint32_t last_print;
+#endif
+
+_Static_assert(TASK_PROFILER_STAGES <= 16, "stages_run has a bit per stage");
+
+static uint8_t bit_length(uint32_t value) {
+    uint8_t length = 0;
+    while (value) {
+        value >>= 1;
+        length++;
+    }
+    return length;
+}
+
+static void record(task_profiler_stage_t stage, uint32_t ticks) {
+    stage_stats_t *s = &stats[stage];
+
+    // Halve what would overflow, which keeps the averages and the shape of the histogram, while giving recent loops
+    // more weight
+    while (s->count == UINT16_MAX || s->total + ticks < s->total) {
+        uint32_t avg = s->total / s->count;
+        s->count >>= 1;
+        s->total = avg * s->count;
+    }
+    uint8_t bucket = bit_length(ticks);
+    if (bucket >= TASK_PROFILER_BUCKETS) {
+        bucket = TASK_PROFILER_BUCKETS - 1;
+    }
+    if (s->buckets[bucket] == UINT8_MAX) {
+        for (uint8_t i = 0; i < TASK_PROFILER_BUCKETS; i++) {
+            s->buckets[i] >>= 1;
+        }
+    }
+
+    if (s->count == 0 || ticks < s->min) {
+        s->min = ticks;
+    }
+    if (ticks > s->max) {
+        s->max = ticks;
+    }
+    s->total += ticks;
+    s->count++;
+    s->buckets[bucket]++;
+}
+
+void task_profiler_start(void) {
+    loop_start = last_mark = timer_read_ticks();
+    stages_run             = 0;
+}
+
+void task_profiler_stage(task_profiler_stage_t stage) {
+    uint32_t now = timer_read_ticks();
+    uint32_t bit = 1U << stage;
+
+    loop_ticks[stage] = (stages_run & bit ? loop_ticks[stage] : 0) + (now - last_mark);
+    stages_run |= bit;
+    last_mark = now;
+}
+
+void task_profiler_end(void) {
+    uint32_t now = timer_read_ticks();
+
+    for (uint8_t stage = 0; stage < TASK_PROFILER_TOTAL; stage++) {
+        if (stages_run & (1U << stage)) {
+            record(stage, loop_ticks[stage]);
+        }
+    }
+    record(TASK_PROFILER_TOTAL, now - loop_start);
+
+#if TASK_PROFILER_PRINT_INTERVAL > 0
+    if (debug_enable && timer_elapsed32(last_print) >= TASK_PROFILER_PRINT_INTERVAL) {
+        last_print = timer_read32();
+        task_profiler_print();
+    }
+#endif
+}
+
+void task_profiler_reset(task_profiler_stage_t stage) {
+    if (stage < TASK_PROFILER_STAGES) {
+        memset(&stats[stage], 0, sizeof(stage_stats_t));
+    }
+}
+
+void task_profiler_reset_all(void) { memset(stats, 0, sizeof(stats)); }
+
+static uint32_t ticks_to_us(uint32_t ticks) { return (uint64_t)ticks * 1000000 / timer_ticks_per_second(); }
+
+// The upper end of the bucket the percentile falls in, which is within a factor of 2 of the real value
+static uint32_t percentile(const stage_stats_t *s, uint8_t percent) {
+    uint16_t samples = 0;
+    for (uint8_t i = 0; i < TASK_PROFILER_BUCKETS; i++) {
+        samples += s->buckets[i];
+    }
+
+    uint32_t ticks = s->max;
+    uint16_t seen  = 0;
+    for (uint8_t i = 0; i < TASK_PROFILER_BUCKETS - 1; i++) {
+        seen += s->buckets[i];
+        if ((uint32_t)seen * 100 >= (uint32_t)samples * percent) {
+            ticks = (1UL << i) - 1;
+            break;
+        }
+    }
+
+    if (ticks > s->max) {
+        ticks = s->max;
+    }
+    if (ticks < s->min) {
+        ticks = s->min;
+    }
+    return ticks_to_us(ticks);
+}
+
+bool task_profiler_get(task_profiler_stage_t stage, task_profiler_summary_t *summary) {
+    if (stage >= TASK_PROFILER_STAGES) {
+        return false;
+    }
+
+    const stage_stats_t *s = &stats[stage];
+    if (s->count == 0) {
+        memset(summary, 0, sizeof(task_profiler_summary_t));
+        return true;
+    }
+
+    summary->count = s->count;
+    summary->min   = ticks_to_us(s->min);
+    summary->avg   = ticks_to_us(s->total / s->count);
+    summary->max   = ticks_to_us(s->max);
+    summary->p50   = percentile(s, 50);
+    summary->p90   = percentile(s, 90);
+    summary->p99   = percentile(s, 99);
+    return true;
+}
+
+static void print_stage_name(task_profiler_stage_t stage) {
+    switch (stage) {
+        case TASK_PROFILER_HOUSEKEEPING:
+            print("housekeeping");
+            break;
+        case TASK_PROFILER_MATRIX_SCAN:
+            print("matrix_scan");
+            break;
+        case TASK_PROFILER_ACTION_EXEC:
+            print("action_exec");
+            break;
+        case TASK_PROFILER_RGBLIGHT:
+            print("rgblight");
+            break;
+        case TASK_PROFILER_RGB_MATRIX:
+            print("rgb_matrix");
+            break;
+        case TASK_PROFILER_BACKLIGHT:
+            print("backlight");
+            break;
+        case TASK_PROFILER_ENCODER:
+            print("encoder");
+            break;
+        case TASK_PROFILER_OLED:
+            print("oled");
+            break;
+        case TASK_PROFILER_MOUSE:
+            print("mouse");
+            break;
+        case TASK_PROFILER_MIDI:
+            print("midi");
+            break;
+        case TASK_PROFILER_LED_SYNC:
+            print("led_sync");
+            break;
+        case TASK_PROFILER_OTHER:
+            print("other");
+            break;
+        default:
+            print("total");
+            break;
+    }
+}
+
+void task_profiler_print(void) {
+    task_profiler_summary_t summary;
+
+    print("task profiler (us): stage\tcount\tmin\tavg\tmax\tp50\tp90\tp99\n");
+    for (uint8_t stage = 0; stage < TASK_PROFILER_STAGES; stage++) {
+        task_profiler_get(stage, &summary);
+        if (summary.count == 0) {
+            continue;
+        }
+        print_stage_name(stage);
+        uprintf("\t%u\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\n", summary.count, summary.min, summary.avg, summary.max, summary.p50, summary.p90, summary.p99);
+    }
+}
+
+static uint8_t *put_uint32(uint8_t *data, uint32_t value) {
+    data[0] = value >> 24;
+    data[1] = value >> 16;
+    data[2] = value >> 8;
+    data[3] = value;
+    return data + 4;
+}
+
+bool task_profiler_raw_hid(uint8_t *data, uint8_t length) {
+    task_profiler_summary_t summary;
+
+    if (length < 30 || data[0] != TASK_PROFILER_RAW_HID_ID) {
+        return false;
+    }
+
+    if (!task_profiler_get(data[1], &summary)) {
+        memset(&summary, 0, sizeof(summary));
+    } else if (data[2] & TASK_PROFILER_RESET) {
+        task_profiler_reset(data[1]);
+    }
+
+    data[3]       = TASK_PROFILER_STAGES;
+    data[4]       = summary.count >> 8;
+    data[5]       = summary.count;
+    uint8_t *next = put_uint32(&data[6], summary.min);
+    next          = put_uint32(next, summary.avg);
+    next          = put_uint32(next, summary.max);
+    next          = put_uint32(next, summary.p50);
+    next          = put_uint32(next, summary.p90);
+    put_uint32(next, summary.p99);
+    return true;
+}
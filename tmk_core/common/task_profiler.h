@@ -0,0 +1,88 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Times each stage of keyboard_task() with timer_read_ticks(), keeping the count, minimum, average and maximum, and a
+// histogram to estimate percentiles from.
+//
+// The results can be printed to the console, and read over raw HID with TASK_PROFILER_RAW_HID_ID:
+//   request:  id, stage, flags (TASK_PROFILER_RESET to start the stage over after reading it)
+//   response: id, stage, flags, TASK_PROFILER_STAGES, count (2 bytes), then min, avg, max, p50, p90 and p99 in
+//             microseconds (4 bytes each)
+// All values are big endian.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef TASK_PROFILER_PRINT_INTERVAL
+#    define TASK_PROFILER_PRINT_INTERVAL 5000
+#endif
+
+#ifndef TASK_PROFILER_RAW_HID_ID
+#    define TASK_PROFILER_RAW_HID_ID 0x17
+#endif
+
+#define TASK_PROFILER_RESET 0x01
+
+// The histogram has a bucket for each bit length of the ticks a stage took
+#ifndef TASK_PROFILER_BUCKETS
+#    if defined(__AVR__)
+#        define TASK_PROFILER_BUCKETS 16
+#    else
+#        define TASK_PROFILER_BUCKETS 24
+#    endif
+#endif
+
+typedef enum {
+    TASK_PROFILER_HOUSEKEEPING,
+    TASK_PROFILER_MATRIX_SCAN,
+    TASK_PROFILER_ACTION_EXEC,
+    TASK_PROFILER_RGBLIGHT,
+    TASK_PROFILER_RGB_MATRIX,
+    TASK_PROFILER_BACKLIGHT,
+    TASK_PROFILER_ENCODER,
+    TASK_PROFILER_OLED,
+    TASK_PROFILER_MOUSE,
+    TASK_PROFILER_MIDI,
+    TASK_PROFILER_LED_SYNC,
+    TASK_PROFILER_OTHER,
+    TASK_PROFILER_TOTAL,
+    TASK_PROFILER_STAGES,
+} task_profiler_stage_t;
+
+typedef struct {
+    uint16_t count;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+} task_profiler_summary_t;
+
+void task_profiler_start(void);
+// Adds the time since the previous call (or task_profiler_start()) to the stage
+void task_profiler_stage(task_profiler_stage_t stage);
+void task_profiler_end(void);
+
+void task_profiler_reset(task_profiler_stage_t stage);
+void task_profiler_reset_all(void);
+// Fills in the summary of the stage in microseconds, returns false for an unknown stage
+bool task_profiler_get(task_profiler_stage_t stage, task_profiler_summary_t *summary);
+void task_profiler_print(void);
+// Answers a raw HID request, returns false if it isn't one for the profiler
+bool task_profiler_raw_hid(uint8_t *data, uint8_t length);
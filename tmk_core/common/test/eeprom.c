@@ -16,9 +16,13 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+#define EEPROM_SIZE 1024
 
-static uint8_t buffer[EEPROM_SIZE];
+static uint8_t  buffer[EEPROM_SIZE];
+static uint32_t write_count = 0;
+
+/* The number of bytes written, for tests that check how often EEPROM is written */
+uint32_t eeprom_get_write_count(void) { return write_count; }
 
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uintptr_t offset = (uintptr_t)addr;
@@ -28,6 +32,7 @@ uint8_t eeprom_read_byte(const uint8_t *addr) {
 void eeprom_write_byte(uint8_t *addr, uint8_t value) {
     uintptr_t offset = (uintptr_t)addr;
     buffer[offset]   = value;
+    write_count++;
 }
 
 uint16_t eeprom_read_word(const uint16_t *addr) {
@@ -70,26 +75,31 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
     }
 }
 
-void eeprom_update_byte(uint8_t *addr, uint8_t value) { eeprom_write_byte(addr, value); }
+/* Like real EEPROM, updating only writes the bytes that change */
+void eeprom_update_byte(uint8_t *addr, uint8_t value) {
+    if (eeprom_read_byte(addr) != value) {
+        eeprom_write_byte(addr, value);
+    }
+}
 
 void eeprom_update_word(uint16_t *addr, uint16_t value) {
     uint8_t *p = (uint8_t *)addr;
-    eeprom_write_byte(p++, value);
-    eeprom_write_byte(p, value >> 8);
+    eeprom_update_byte(p++, value);
+    eeprom_update_byte(p, value >> 8);
 }
 
 void eeprom_update_dword(uint32_t *addr, uint32_t value) {
     uint8_t *p = (uint8_t *)addr;
-    eeprom_write_byte(p++, value);
-    eeprom_write_byte(p++, value >> 8);
-    eeprom_write_byte(p++, value >> 16);
-    eeprom_write_byte(p, value >> 24);
+    eeprom_update_byte(p++, value);
+    eeprom_update_byte(p++, value >> 8);
+    eeprom_update_byte(p++, value >> 16);
+    eeprom_update_byte(p, value >> 24);
 }
 
 void eeprom_update_block(const void *buf, void *addr, size_t len) {
     uint8_t *      p   = (uint8_t *)addr;
     const uint8_t *src = (const uint8_t *)buf;
     while (len--) {
-        eeprom_write_byte(p++, *src++);
+        eeprom_update_byte(p++, *src++);
     }
 }
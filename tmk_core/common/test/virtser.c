@@ -0,0 +1,52 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "virtser.h"
+
+#define VIRTSER_MAX_TRANSFERS 32
+#define VIRTSER_BUFFER_SIZE 256
+
+// Everything sent, and where each transfer starts in it, so tests can check how the data was split up
+static uint8_t  buffer[VIRTSER_BUFFER_SIZE];
+static uint16_t transfer_start[VIRTSER_MAX_TRANSFERS + 1];
+static uint8_t  transfer_count = 0;
+
+void virtser_clear_transfers(void) { transfer_count = 0; }
+
+uint8_t virtser_get_transfer_count(void) { return transfer_count; }
+
+/* Points data at a transfer and returns its length */
+uint8_t virtser_get_transfer(uint8_t index, const uint8_t **data) {
+    if (index >= transfer_count) {
+        return 0;
+    }
+    *data = &buffer[transfer_start[index]];
+    return transfer_start[index + 1] - transfer_start[index];
+}
+
+void virtser_send_buf(const uint8_t *buf, uint8_t length) {
+    uint16_t start = transfer_start[transfer_count];
+    if (transfer_count == VIRTSER_MAX_TRANSFERS || start + length > VIRTSER_BUFFER_SIZE) {
+        return;
+    }
+    memcpy(&buffer[start], buf, length);
+    transfer_count++;
+    transfer_start[transfer_count] = start + length;
+}
+
+void virtser_send(const uint8_t byte) { virtser_send_buf(&byte, 1); }
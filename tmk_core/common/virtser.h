@@ -5,3 +5,6 @@ void virtser_recv(const uint8_t ch);
 
 /* Call this to send a character over the Virtual Serial Device */
 void virtser_send(const uint8_t byte);
+
+/* Call this to send several characters at once, which goes out as a single transfer where possible */
+void virtser_send_buf(const uint8_t *buf, uint8_t length);
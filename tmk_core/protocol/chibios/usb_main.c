@@ -471,6 +471,8 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
         case USB_EVENT_UNCONFIGURED:
             /* Falls into.*/
         case USB_EVENT_RESET:
+            // The host may have missed the last keyboard report, so it's sent again
+            host_keyboard_forget_last_report();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -1008,6 +1010,8 @@ void midi_ep_task(void) {
 
 void virtser_send(const uint8_t byte) { chnWrite(&drivers.serial_driver.driver, &byte, 1); }
 
+void virtser_send_buf(const uint8_t *buf, uint8_t length) { chnWrite(&drivers.serial_driver.driver, buf, length); }
+
 __attribute__((weak)) void virtser_recv(uint8_t c) {
     // Ignore by default
 }
@@ -32,6 +32,11 @@
 #    define AdafruitBleSpiClockSpeed 4000000UL  // SCK frequency
 #endif
 
+// The number of commands sent to the module before waiting for a response
+#ifndef AdafruitBlePipelineDepth
+#    define AdafruitBlePipelineDepth 2
+#endif
+
 #define SCK_DIVISOR (F_CPU / AdafruitBleSpiClockSpeed)
 
 #define SAMPLE_BATTERY
@@ -55,6 +60,14 @@ static struct {
     uint32_t vbat;
 #endif
     uint16_t last_connection_update;
+
+    // The last key report queued, to tell which reports only release keys
+    uint8_t last_modifier;
+    uint8_t last_keys[6];
+#ifdef MOUSE_ENABLE
+    // The buttons the module was last told about, which it holds until told otherwise
+    uint8_t mouse_buttons;
+#endif
 } state;
 
 // Commands are encoded using SDEP and sent via SPI
@@ -93,6 +106,7 @@ struct queue_item {
         struct __attribute__((packed)) {
             uint8_t modifier;
             uint8_t keys[6];
+            bool    release_only;  // nothing was pressed since the report before
         } key;
 
         uint16_t consumer;
@@ -105,10 +119,11 @@ struct queue_item {
 
 // Items that we wish to send
 static RingBuffer<queue_item, 40> send_buf;
-// Pending response; while pending, we can't send any more requests.
-// This records the time at which we sent the command for which we
+// Pending responses; while AdafruitBlePipelineDepth are pending, we can't
+// send any more requests.
+// This records the time at which we sent each command for which we
 // are expecting a response.
-static RingBuffer<uint16_t, 2> resp_buf;
+static RingBuffer<uint16_t, AdafruitBlePipelineDepth + 1> resp_buf;
 
 static bool process_queue_item(struct queue_item *item, uint16_t timeout);
 
@@ -259,25 +274,27 @@ static void resp_buf_read_one(bool greedy) {
     }
 }
 
-static void send_buf_send_one(uint16_t timeout = SdepTimeout) {
+static bool send_buf_send_one(uint16_t timeout = SdepTimeout) {
     struct queue_item item;
 
     // Don't send anything more until we get an ACK
-    if (!resp_buf.empty()) {
-        return;
+    if (resp_buf.size() >= AdafruitBlePipelineDepth) {
+        return false;
     }
 
-    if (!send_buf.peek(item)) {
-        return;
+    if (send_buf.empty()) {
+        return false;
     }
-    if (process_queue_item(&item, timeout)) {
-        // commit that peek
+    // Sent from where it is queued, so what went out of a partly sent item can be cleared
+    if (process_queue_item(&send_buf.front(), timeout)) {
         send_buf.get(item);
         dprintf("send_buf_send_one: have %d remaining\n", (int)send_buf.size());
+        return true;
     } else {
         dprint("failed to send, will retry\n");
         wait_ms(SdepTimeout);
         resp_buf_read_one(true);
+        return false;
     }
 }
 
@@ -389,6 +406,16 @@ static bool at_command(const char *cmd, char *resp, uint16_t resplen, bool verbo
         // that we don't confuse the results
         resp_buf_wait(cmd);
         *resp = 0;
+    } else {
+        // Make room in the pipeline first, as the module won't take more
+        uint16_t now = timer_read();
+        while (resp_buf.size() >= AdafruitBlePipelineDepth) {
+            resp_buf_read_one(false);
+        }
+        uint16_t later = timer_read();
+        if (TIMER_DIFF_16(later, now) > 0) {
+            dprintf("waited %dms for resp_buf\n", TIMER_DIFF_16(later, now));
+        }
     }
 
     // Fragment the command into a series of SDEP packets
@@ -406,14 +433,7 @@ static bool at_command(const char *cmd, char *resp, uint16_t resplen, bool verbo
     }
 
     if (resp == NULL) {
-        uint16_t now = timer_read();
-        while (!resp_buf.enqueue(now)) {
-            resp_buf_read_one(false);
-        }
-        uint16_t later = timer_read();
-        if (TIMER_DIFF_16(later, now) > 0) {
-            dprintf("waited %dms for resp_buf\n", TIMER_DIFF_16(later, now));
-        }
+        resp_buf.enqueue(timer_read());
         return true;
     }
 
@@ -436,6 +456,9 @@ bool adafruit_ble_enable_keyboard(void) {
     }
 
     state.configured = false;
+#ifdef MOUSE_ENABLE
+    state.mouse_buttons = 0;
+#endif
 
     // Disable command echo
     static const char kEcho[] PROGMEM = "ATE=0";
@@ -466,7 +489,14 @@ bool adafruit_ble_enable_keyboard(void) {
         memcpy_P(&cmd, configure_commands + i, sizeof(cmd));
 
         if (!at_command_P(cmd, resbuf, sizeof(resbuf))) {
+#ifdef BINLOG_ENABLE
+            // binlog reads string arguments from RAM, so copy the command out of flash rather than print it with %S
+            char *cmdbuf = (char *)alloca(strlen_P(cmd) + 1);
+            strcpy_P(cmdbuf, cmd);
+            dprintf("failed BLE command: %s: %s\n", cmdbuf, resbuf);
+#else
             dprintf("failed BLE command: %S: %s\n", cmd, resbuf);
+#endif
             goto fail;
         }
     }
@@ -507,7 +537,9 @@ void adafruit_ble_task(void) {
         return;
     }
     resp_buf_read_one(true);
-    send_buf_send_one(SdepShortTimeout);
+    // Keep the pipeline full
+    while (send_buf_send_one(SdepShortTimeout)) {
+    }
 
     if (resp_buf.empty() && (state.event_flags & UsingEvents) && readPin(AdafruitBleIRQPin)) {
         // Must be an event update
@@ -560,9 +592,41 @@ void adafruit_ble_task(void) {
 #endif
 }
 
+static char *append_P(char *dest, const char *src) {
+    strcpy_P(dest, src);
+    return dest + strlen(dest);
+}
+
+static char *append_hex(char *dest, uint8_t value) {
+    static const char hex[] PROGMEM = "0123456789abcdef";
+    *dest++                         = pgm_read_byte(hex + (value >> 4));
+    *dest++                         = pgm_read_byte(hex + (value & 0xF));
+    *dest                           = 0;
+    return dest;
+}
+
+#ifdef MOUSE_ENABLE
+static char *append_int(char *dest, int8_t value) {
+    uint8_t magnitude = value < 0 ? -value : value;
+    if (value < 0) {
+        *dest++ = '-';
+    }
+    if (magnitude >= 100) {
+        *dest++ = '0' + magnitude / 100;
+    }
+    if (magnitude >= 10) {
+        *dest++ = '0' + magnitude / 10 % 10;
+    }
+    *dest++ = '0' + magnitude % 10;
+    *dest   = 0;
+    return dest;
+}
+#endif
+
+// The commands are built by hand rather than with snprintf, as this is on the path of every report
 static bool process_queue_item(struct queue_item *item, uint16_t timeout) {
-    char cmdbuf[48];
-    char fmtbuf[64];
+    char  cmdbuf[48];
+    char *cmd;
 
     // Arrange to re-check connection after keys have settled
     state.last_connection_update = timer_read();
@@ -575,21 +639,40 @@ static bool process_queue_item(struct queue_item *item, uint16_t timeout) {
 
     switch (item->queue_type) {
         case QTKeyReport:
-            strcpy_P(fmtbuf, PSTR("AT+BLEKEYBOARDCODE=%02x-00-%02x-%02x-%02x-%02x-%02x-%02x"));
-            snprintf(cmdbuf, sizeof(cmdbuf), fmtbuf, item->key.modifier, item->key.keys[0], item->key.keys[1], item->key.keys[2], item->key.keys[3], item->key.keys[4], item->key.keys[5]);
+            cmd = append_P(cmdbuf, PSTR("AT+BLEKEYBOARDCODE="));
+            cmd = append_hex(cmd, item->key.modifier);
+            cmd = append_P(cmd, PSTR("-00"));
+            for (uint8_t i = 0; i < 6; i++) {
+                *cmd++ = '-';
+                cmd    = append_hex(cmd, item->key.keys[i]);
+            }
             return at_command(cmdbuf, NULL, 0, true, timeout);
 
         case QTConsumer:
-            strcpy_P(fmtbuf, PSTR("AT+BLEHIDCONTROLKEY=0x%04x"));
-            snprintf(cmdbuf, sizeof(cmdbuf), fmtbuf, item->consumer);
+            cmd = append_P(cmdbuf, PSTR("AT+BLEHIDCONTROLKEY=0x"));
+            cmd = append_hex(cmd, item->consumer >> 8);
+            append_hex(cmd, item->consumer & 0xFF);
             return at_command(cmdbuf, NULL, 0, true, timeout);
 
 #ifdef MOUSE_ENABLE
         case QTMouseMove:
-            strcpy_P(fmtbuf, PSTR("AT+BLEHIDMOUSEMOVE=%d,%d,%d,%d"));
-            snprintf(cmdbuf, sizeof(cmdbuf), fmtbuf, item->mousemove.x, item->mousemove.y, item->mousemove.scroll, item->mousemove.pan);
-            if (!at_command(cmdbuf, NULL, 0, true, timeout)) {
-                return false;
+            // The module holds the buttons, so a move only needs them sent when they changed, and a change of
+            // buttons only needs a move when there is one
+            if (item->mousemove.x || item->mousemove.y || item->mousemove.scroll || item->mousemove.pan || item->mousemove.buttons == state.mouse_buttons) {
+                cmd = append_P(cmdbuf, PSTR("AT+BLEHIDMOUSEMOVE="));
+                cmd = append_int(cmd, item->mousemove.x);
+                *cmd++ = ',';
+                cmd    = append_int(cmd, item->mousemove.y);
+                *cmd++ = ',';
+                cmd    = append_int(cmd, item->mousemove.scroll);
+                *cmd++ = ',';
+                append_int(cmd, item->mousemove.pan);
+                if (!at_command(cmdbuf, NULL, 0, true, timeout)) {
+                    return false;
+                }
+            }
+            if (item->mousemove.buttons == state.mouse_buttons) {
+                return true;
             }
             strcpy_P(cmdbuf, PSTR("AT+BLEHIDMOUSEBUTTON="));
             if (item->mousemove.buttons & MOUSE_BTN1) {
@@ -604,16 +687,96 @@ static bool process_queue_item(struct queue_item *item, uint16_t timeout) {
             if (item->mousemove.buttons == 0) {
                 strcat(cmdbuf, "0");
             }
-            return at_command(cmdbuf, NULL, 0, true, timeout);
+            if (!at_command(cmdbuf, NULL, 0, true, timeout)) {
+                // The move went out, so only the buttons are left to retry
+                item->mousemove.x = item->mousemove.y = item->mousemove.scroll = item->mousemove.pan = 0;
+                return false;
+            }
+            state.mouse_buttons = item->mousemove.buttons;
+            return true;
 #endif
         default:
             return true;
     }
 }
 
+// Folds the item into the last one queued when that one hasn't been sent yet, and the host doesn't need to see both
+static bool send_buf_coalesce(const struct queue_item *item) {
+    if (send_buf.empty()) {
+        return false;
+    }
+
+    struct queue_item *last = &send_buf.back();
+    if (last->queue_type != item->queue_type) {
+        return false;
+    }
+
+    switch (item->queue_type) {
+        case QTKeyReport:
+            // Releases can go out together, but presses have to keep their order
+            if (!last->key.release_only || !item->key.release_only) {
+                return false;
+            }
+            last->key.modifier = item->key.modifier;
+            memcpy(last->key.keys, item->key.keys, sizeof(last->key.keys));
+            return true;
+
+#ifdef MOUSE_ENABLE
+        case QTMouseMove: {
+            if (last->mousemove.buttons != item->mousemove.buttons) {
+                return false;
+            }
+            int16_t x      = last->mousemove.x + item->mousemove.x;
+            int16_t y      = last->mousemove.y + item->mousemove.y;
+            int16_t scroll = last->mousemove.scroll + item->mousemove.scroll;
+            int16_t pan    = last->mousemove.pan + item->mousemove.pan;
+            if (x < -127 || x > 127 || y < -127 || y > 127 || scroll < -127 || scroll > 127 || pan < -127 || pan > 127) {
+                return false;
+            }
+            last->mousemove.x      = x;
+            last->mousemove.y      = y;
+            last->mousemove.scroll = scroll;
+            last->mousemove.pan    = pan;
+            return true;
+        }
+#endif
+
+        default:
+            return false;
+    }
+}
+
+static void send_buf_enqueue(const struct queue_item *item) {
+    bool didWait = false;
+
+    if (send_buf_coalesce(item)) {
+        return;
+    }
+
+    while (!send_buf.enqueue(*item)) {
+        if (!didWait) {
+            dprint("wait for buf space\n");
+            didWait = true;
+        }
+        send_buf_send_one();
+        resp_buf_read_one(false);
+    }
+}
+
+static bool is_release_only(uint8_t modifier, const uint8_t *keys) {
+    if (modifier & ~state.last_modifier) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 6; i++) {
+        if (keys[i] && !memchr(state.last_keys, keys[i], sizeof(state.last_keys))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void adafruit_ble_send_keys(uint8_t hid_modifier_mask, uint8_t *keys, uint8_t nkeys) {
     struct queue_item item;
-    bool              didWait = false;
 
     item.queue_type   = QTKeyReport;
     item.key.modifier = hid_modifier_mask;
@@ -627,14 +790,10 @@ void adafruit_ble_send_keys(uint8_t hid_modifier_mask, uint8_t *keys, uint8_t nk
         item.key.keys[4] = nkeys >= 4 ? keys[4] : 0;
         item.key.keys[5] = nkeys >= 5 ? keys[5] : 0;
 
-        if (!send_buf.enqueue(item)) {
-            if (!didWait) {
-                dprint("wait for buf space\n");
-                didWait = true;
-            }
-            send_buf_send_one();
-            continue;
-        }
+        item.key.release_only = is_release_only(item.key.modifier, item.key.keys);
+        state.last_modifier   = item.key.modifier;
+        memcpy(state.last_keys, item.key.keys, sizeof(state.last_keys));
+        send_buf_enqueue(&item);
 
         if (nkeys <= 6) {
             return;
@@ -650,10 +809,9 @@ void adafruit_ble_send_consumer_key(uint16_t usage) {
 
     item.queue_type = QTConsumer;
     item.consumer   = usage;
+    item.added      = timer_read();
 
-    while (!send_buf.enqueue(item)) {
-        send_buf_send_one();
-    }
+    send_buf_enqueue(&item);
 }
 
 #ifdef MOUSE_ENABLE
@@ -666,10 +824,9 @@ void adafruit_ble_send_mouse_move(int8_t x, int8_t y, int8_t scroll, int8_t pan,
     item.mousemove.scroll  = scroll;
     item.mousemove.pan     = pan;
     item.mousemove.buttons = buttons;
+    item.added             = timer_read();
 
-    while (!send_buf.enqueue(item)) {
-        send_buf_send_one();
-    }
+    send_buf_enqueue(&item);
 }
 #endif
 
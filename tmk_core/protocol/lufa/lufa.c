@@ -416,7 +416,11 @@ void EVENT_USB_Device_Disconnect(void) {
  *
  * FIXME: Needs doc
  */
-void EVENT_USB_Device_Reset(void) { print("[R]"); }
+void EVENT_USB_Device_Reset(void) {
+    print("[R]");
+    // The host starts over, so the next keyboard report has to be sent
+    host_keyboard_forget_last_report();
+}
 
 /** \brief Event USB Device Connect
  *
@@ -955,7 +959,13 @@ void virtser_task(void) {
  *
  * FIXME: Needs doc
  */
-void virtser_send(const uint8_t byte) {
+void virtser_send(const uint8_t byte) { virtser_send_buf(&byte, 1); }
+
+/** \brief Virtual Serial Send Buffer
+ *
+ * Writes all of the bytes before flushing, so they share packets instead of taking one each
+ */
+void virtser_send_buf(const uint8_t *buf, uint8_t length) {
     uint8_t timeout = 255;
     uint8_t ep      = Endpoint_GetCurrentEndpoint();
 
@@ -970,7 +980,8 @@ void virtser_send(const uint8_t byte) {
 
         while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
 
-        Endpoint_Write_8(byte);
+        // Sends each full bank on the way
+        Endpoint_Write_Stream_LE(buf, length, NULL);
         CDC_Device_Flush(&cdc_device);
 
         if (Endpoint_IsINReady()) {
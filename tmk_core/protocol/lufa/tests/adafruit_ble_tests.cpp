@@ -0,0 +1,183 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "adafruit_ble.h"
+#include "report.h"
+#include "sdep_module.hpp"
+
+using sdep_module::Command;
+
+class AdafruitBle : public testing::Test {
+   protected:
+    AdafruitBle() {
+        sdep_module::configure(5000, 2);
+        // Configures the module the first time, and lets earlier tests finish
+        run_for(1500);
+        sdep_module::commands().clear();
+    }
+
+    // Runs the main loop, once a millisecond
+    static void run_for(uint32_t ms) {
+        uint32_t end = sdep_module::now_us() + ms * 1000;
+        while (sdep_module::now_us() < end) {
+            adafruit_ble_task();
+            sdep_module::advance_us(1000);
+        }
+    }
+
+    // The HID commands sent, leaving out the ones the driver sends to check on the connection
+    static std::vector<Command> hid_commands() {
+        std::vector<Command> result;
+        for (auto& command : sdep_module::commands()) {
+            if (command.text.rfind("AT+BLEHID", 0) == 0 || command.text.rfind("AT+BLEKEYBOARDCODE", 0) == 0) {
+                result.push_back(command);
+            }
+        }
+        return result;
+    }
+
+    static std::vector<std::string> hid_command_texts() {
+        std::vector<std::string> result;
+        for (auto& command : hid_commands()) {
+            result.push_back(command.text);
+        }
+        return result;
+    }
+
+    static void send_keys(uint8_t modifier, std::vector<uint8_t> pressed) {
+        uint8_t keys[6] = {0};
+        std::copy(pressed.begin(), pressed.end(), keys);
+        adafruit_ble_send_keys(modifier, keys, sizeof(keys));
+    }
+};
+
+TEST_F(AdafruitBle, CommandsAreFormatted) {
+    send_keys(0x22, {0x04, 0xE0});
+    adafruit_ble_send_consumer_key(0x00E9);
+    adafruit_ble_send_mouse_move(-128, 127, -1, 10, 0);
+    run_for(100);
+    std::vector<std::string> expected = {
+        "AT+BLEKEYBOARDCODE=22-00-04-e0-00-00-00-00",
+        "AT+BLEHIDCONTROLKEY=0x00e9",
+        "AT+BLEHIDMOUSEMOVE=-128,127,-1,10",
+    };
+    EXPECT_EQ(hid_command_texts(), expected);
+}
+
+TEST_F(AdafruitBle, MouseButtonsAreOnlySentWhenTheyChange) {
+    adafruit_ble_send_mouse_move(5, -3, 0, 0, 0);
+    run_for(20);
+    adafruit_ble_send_mouse_move(0, 0, 0, 0, MOUSE_BTN1);
+    run_for(20);
+    adafruit_ble_send_mouse_move(1, 1, 0, 0, MOUSE_BTN1);
+    run_for(20);
+    adafruit_ble_send_mouse_move(2, 0, 0, 0, MOUSE_BTN1 | MOUSE_BTN2);
+    run_for(20);
+    adafruit_ble_send_mouse_move(0, 0, 0, 0, 0);
+    run_for(20);
+    std::vector<std::string> expected = {
+        "AT+BLEHIDMOUSEMOVE=5,-3,0,0", "AT+BLEHIDMOUSEBUTTON=L", "AT+BLEHIDMOUSEMOVE=1,1,0,0", "AT+BLEHIDMOUSEMOVE=2,0,0,0", "AT+BLEHIDMOUSEBUTTON=LR", "AT+BLEHIDMOUSEBUTTON=0",
+    };
+    EXPECT_EQ(hid_command_texts(), expected);
+}
+
+TEST_F(AdafruitBle, QueuedMouseMovesAreAddedUp) {
+    for (int i = 0; i < 20; i++) {
+        adafruit_ble_send_mouse_move(10, -5, 0, 0, 0);
+    }
+    adafruit_ble_send_mouse_move(0, 0, 1, 0, MOUSE_BTN1);
+    run_for(100);
+    // As far as they fit in a report
+    std::vector<std::string> expected = {"AT+BLEHIDMOUSEMOVE=120,-60,0,0", "AT+BLEHIDMOUSEMOVE=80,-40,0,0", "AT+BLEHIDMOUSEMOVE=0,0,1,0", "AT+BLEHIDMOUSEBUTTON=L"};
+    EXPECT_EQ(hid_command_texts(), expected);
+    adafruit_ble_send_mouse_move(0, 0, 0, 0, 0);
+    run_for(20);
+}
+
+TEST_F(AdafruitBle, QueuedReleasesAreCombinedButPressesKeepTheirOrder) {
+    send_keys(0x02, {0x04});
+    send_keys(0x02, {0x04, 0x05});
+    send_keys(0x02, {0x05});
+    send_keys(0x00, {0x05});
+    send_keys(0x00, {});
+    send_keys(0x00, {0x06});
+    send_keys(0x00, {});
+    run_for(100);
+    std::vector<std::string> expected = {
+        "AT+BLEKEYBOARDCODE=02-00-04-00-00-00-00-00",
+        "AT+BLEKEYBOARDCODE=02-00-04-05-00-00-00-00",
+        "AT+BLEKEYBOARDCODE=00-00-00-00-00-00-00-00",
+        "AT+BLEKEYBOARDCODE=00-00-06-00-00-00-00-00",
+        "AT+BLEKEYBOARDCODE=00-00-00-00-00-00-00-00",
+    };
+    EXPECT_EQ(hid_command_texts(), expected);
+}
+
+TEST_F(AdafruitBle, CommandsArePipelinedUpToTheModulesLimit) {
+    for (uint8_t key = 0x04; key < 0x14; key++) {
+        send_keys(0, {key});
+        send_keys(0, {});
+    }
+    run_for(500);
+    EXPECT_EQ(hid_commands().size(), 32u);
+    EXPECT_EQ(sdep_module::max_outstanding(), 2);
+    // The module is never left waiting on the keyboard
+    auto commands = hid_commands();
+    for (size_t i = 1; i < commands.size(); i++) {
+        EXPECT_LE(commands[i].received_us, commands[i - 1].done_us) << commands[i].text;
+    }
+}
+
+// The time from each report to the host seeing it, while typing 10 keys a second with a module that takes 5ms per
+// command, as the Bluefruit takes about that when connected
+TEST_F(AdafruitBle, TypingLatency) {
+    std::vector<uint32_t> sent;
+    for (uint8_t i = 0; i < 50; i++) {
+        uint8_t key = 0x04 + i % 26;
+        sent.push_back(sdep_module::now_us());
+        send_keys(0, {key});
+        run_for(i % 3 ? 30 : 3);
+        // Rolling over to the next key before this one is released
+        sent.push_back(sdep_module::now_us());
+        send_keys(0, {key, (uint8_t)(0x04 + (i + 1) % 26)});
+        run_for(2);
+        sent.push_back(sdep_module::now_us());
+        send_keys(0, {(uint8_t)(0x04 + (i + 1) % 26)});
+        run_for(i % 3 ? 60 : 5);
+        sent.push_back(sdep_module::now_us());
+        send_keys(0, {});
+        run_for(5);
+    }
+    run_for(500);
+
+    auto commands = hid_commands();
+    ASSERT_EQ(commands.size(), sent.size());
+    std::vector<uint32_t> latency;
+    for (size_t i = 0; i < commands.size(); i++) {
+        latency.push_back(commands[i].done_us - sent[i]);
+    }
+    std::sort(latency.begin(), latency.end());
+    uint32_t total = 0;
+    for (auto us : latency) {
+        total += us;
+    }
+    fprintf(stdout, "\n  report latency (us): avg %u, p50 %u, p90 %u, max %u\n", (unsigned)(total / latency.size()), latency[latency.size() / 2], latency[latency.size() * 9 / 10], latency.back());
+    EXPECT_LT(latency.back(), 30000u);
+}
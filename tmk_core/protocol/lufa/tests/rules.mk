@@ -0,0 +1,10 @@
+adafruit_ble_DEFS := -DMOUSE_ENABLE -DPRODUCT=TestKeyboard -DF_CPU=8000000UL
+adafruit_ble_INC := $(TMK_PATH)/protocol/lufa/tests $(TMK_PATH)/protocol/lufa
+
+adafruit_ble_SRC := \
+	$(TMK_PATH)/protocol/lufa/tests/adafruit_ble_tests.cpp \
+	$(TMK_PATH)/protocol/lufa/tests/sdep_module.cpp \
+	$(TMK_PATH)/protocol/lufa/adafruit_ble.cpp \
+	$(TMK_PATH)/common/debug.c \
+	$(TMK_PATH)/common/printf.c \
+	$(LIB_PATH)/printf/printf.c
@@ -0,0 +1,199 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sdep_module.hpp"
+
+#include <algorithm>
+#include <deque>
+#include "spi_master.h"
+#include "analog.h"
+#include "timer.h"
+#include "wait.h"
+
+namespace {
+
+const uint8_t  sdep_command        = 0x10;
+const uint8_t  sdep_response       = 0x20;
+const uint8_t  sdep_not_ready      = 0xFE;
+const uint16_t sdep_at_wrapper     = 0x0A00;
+const uint8_t  sdep_max_payload    = 16;
+const pin_t    irq_pin             = E6;
+const uint32_t default_processing  = 5000;
+const uint8_t  default_max_pending = 2;
+
+struct Response {
+    std::deque<std::vector<uint8_t>> packets;
+    uint32_t                         ready_us;
+};
+
+uint32_t clock_us      = 0;
+uint32_t processing_us = default_processing;
+uint8_t  max_pending   = default_max_pending;
+uint8_t  outstanding   = 0;
+
+std::deque<Response>                responses;
+std::vector<sdep_module::Command>   received;
+std::string                         partial_command;
+std::vector<uint8_t>                written;
+const std::vector<uint8_t>*         reading = nullptr;
+size_t                              read_position;
+
+std::deque<std::vector<uint8_t>> response_packets(const std::string& text) {
+    std::deque<std::vector<uint8_t>> packets;
+    size_t                           offset = 0;
+    do {
+        size_t  len  = std::min<size_t>(text.size() - offset, sdep_max_payload);
+        bool    more = offset + len < text.size();
+        uint8_t header[] = {sdep_response, sdep_at_wrapper & 0xFF, sdep_at_wrapper >> 8, (uint8_t)(len | (more ? 0x80 : 0))};
+        std::vector<uint8_t> packet(header, header + sizeof(header));
+        packet.insert(packet.end(), text.begin() + offset, text.begin() + offset + len);
+        packets.push_back(packet);
+        offset += len;
+    } while (offset < text.size());
+    return packets;
+}
+
+std::string response_text(const std::string& command) {
+    if (command == "AT+GAPGETCONN") {
+        return "1\r\nOK\r\n";
+    }
+    if (command == "AT+EVENTSTATUS") {
+        return "0x0\r\nOK\r\n";
+    }
+    return "OK\r\n";
+}
+
+void command_received(const std::string& command) {
+    uint32_t start = responses.empty() ? clock_us : std::max(clock_us, responses.back().ready_us);
+    responses.push_back({response_packets(response_text(command)), start + processing_us});
+    received.push_back({command, clock_us, start + processing_us});
+    outstanding = std::max<uint8_t>(outstanding, responses.size());
+}
+
+void packet_written(void) {
+    if (written.size() < 4 || written[0] != sdep_command) {
+        return;
+    }
+    uint8_t len  = written[3] & 0x7F;
+    bool    more = written[3] & 0x80;
+    partial_command.append(written.begin() + 4, written.begin() + 4 + std::min<size_t>(len, written.size() - 4));
+    if (!more) {
+        command_received(partial_command);
+        partial_command.clear();
+    }
+}
+
+}  // namespace
+
+namespace sdep_module {
+
+void configure(uint32_t processing, uint8_t pending) {
+    processing_us = processing;
+    max_pending   = pending;
+    outstanding   = 0;
+    received.clear();
+}
+
+uint32_t now_us(void) { return clock_us; }
+
+void advance_us(uint32_t us) { clock_us += us; }
+
+std::vector<Command>& commands(void) { return received; }
+
+uint8_t max_outstanding(void) { return outstanding; }
+
+bool idle(void) { return responses.empty(); }
+
+}  // namespace sdep_module
+
+extern "C" {
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    written.clear();
+    reading = nullptr;
+    return true;
+}
+
+spi_status_t spi_write(uint8_t data) {
+    if (written.empty() && responses.size() >= max_pending) {
+        return sdep_not_ready;
+    }
+    written.push_back(data);
+    return 0;
+}
+
+spi_status_t spi_transmit(const uint8_t* data, uint16_t length) {
+    written.insert(written.end(), data, data + length);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_read(void) {
+    if (responses.empty() || responses.front().ready_us > clock_us) {
+        return sdep_not_ready;
+    }
+    reading       = &responses.front().packets.front();
+    read_position = 1;
+    return (*reading)[0];
+}
+
+spi_status_t spi_receive(uint8_t* data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = reading && read_position < reading->size() ? (*reading)[read_position++] : 0;
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_stop(void) {
+    if (reading && read_position >= reading->size()) {
+        responses.front().packets.pop_front();
+        if (responses.front().packets.empty()) {
+            responses.pop_front();
+        }
+    }
+    reading = nullptr;
+    packet_written();
+    written.clear();
+}
+
+// Polling takes a little time too, so loops waiting on the IRQ pin get somewhere
+bool readPin(pin_t pin) {
+    clock_us++;
+    return pin == irq_pin && !responses.empty() && responses.front().ready_us <= clock_us;
+}
+
+void setPinInput(pin_t pin) {}
+
+void setPinOutput(pin_t pin) {}
+
+void writePinHigh(pin_t pin) {}
+
+void writePinLow(pin_t pin) {}
+
+int16_t analogReadPin(pin_t pin) { return 0; }
+
+uint16_t timer_read(void) { return clock_us / 1000; }
+
+uint32_t timer_read32(void) { return clock_us / 1000; }
+
+uint16_t timer_elapsed(uint16_t last) { return TIMER_DIFF_16(timer_read(), last); }
+
+uint32_t timer_elapsed32(uint32_t last) { return TIMER_DIFF_32(timer_read32(), last); }
+
+// wait_us() waits for 0 milliseconds here, which has to take some time for the polling loops to time out
+void wait_ms(uint32_t ms) { clock_us += ms ? ms * 1000 : 10; }
+}
@@ -0,0 +1,47 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// A stand-in for the Bluefruit module on the other end of the SPI bus. It takes AT commands wrapped in SDEP packets,
+// works on them one at a time, and raises the IRQ pin when a response is ready.
+//
+// The clock of the timer and wait functions is simulated as well, so the time the driver spends waiting on the
+// module is accounted for.
+namespace sdep_module {
+
+struct Command {
+    std::string text;
+    uint32_t    received_us;  // when the last packet of the command was sent
+    uint32_t    done_us;      // when the module was done with it, and the host saw the result
+};
+
+// How long each command takes, and how many the module holds before it tells the driver it isn't ready
+void configure(uint32_t processing_us, uint8_t max_pending);
+
+uint32_t now_us(void);
+void     advance_us(uint32_t us);
+
+std::vector<Command>& commands(void);
+// The most commands that were waiting for a response at once
+uint8_t max_outstanding(void);
+bool    idle(void);
+
+}  // namespace sdep_module